@@ -0,0 +1,414 @@
+#include "cbor_io.h"
+#include <string.h>
+
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NEGINT 1
+#define CBOR_MAJOR_BYTES 2
+#define CBOR_MAJOR_TEXT 3
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_MAJOR_TAG 6
+#define CBOR_MAJOR_SIMPLE 7
+
+#define CBOR_INDEFINITE 31
+
+// RFC 8746 typed array tags: 0b010_f_s_e_ll
+#define CBOR_TAG_TYPED_FIRST 64
+#define CBOR_TAG_TYPED_LAST 87
+
+size_t cbor_typed_size(cbor_typed_t type) {
+    switch (type) {
+        case CBOR_TYPED_U8:
+        case CBOR_TYPED_I8:  return 1;
+        case CBOR_TYPED_U16:
+        case CBOR_TYPED_I16: return 2;
+        case CBOR_TYPED_U32:
+        case CBOR_TYPED_I32:
+        case CBOR_TYPED_F32: return 4;
+        case CBOR_TYPED_U64:
+        case CBOR_TYPED_I64:
+        case CBOR_TYPED_F64: return 8;
+    }
+    return 0;
+}
+
+static uint64_t typed_tag(cbor_typed_t type, int big_endian) {
+    unsigned f = 0, s = 0, ll;
+    switch (type) {
+        case CBOR_TYPED_U8:  ll = 0; break;
+        case CBOR_TYPED_U16: ll = 1; break;
+        case CBOR_TYPED_U32: ll = 2; break;
+        case CBOR_TYPED_U64: ll = 3; break;
+        case CBOR_TYPED_I8:  s = 1; ll = 0; break;
+        case CBOR_TYPED_I16: s = 1; ll = 1; break;
+        case CBOR_TYPED_I32: s = 1; ll = 2; break;
+        case CBOR_TYPED_I64: s = 1; ll = 3; break;
+        case CBOR_TYPED_F32: f = 1; ll = 1; break;
+        default:             f = 1; ll = 2; break;
+    }
+    // Byte order is meaningless for 8-bit elements; e = 1 there means
+    // "clamped" (uint8) or is reserved (sint8).
+    const unsigned e = ll == 0 && !f ? 0 : !big_endian;
+    return CBOR_TAG_TYPED_FIRST + (f << 4) + (s << 3) + (e << 2) + ll;
+}
+
+static int typed_from_tag(uint64_t tag, cbor_typed_t* type, int* big_endian) {
+    if (tag < CBOR_TAG_TYPED_FIRST || tag > CBOR_TAG_TYPED_LAST)
+        return -1;
+    const unsigned bits = (unsigned)(tag - CBOR_TAG_TYPED_FIRST);
+    const unsigned f = (bits >> 4) & 1, s = (bits >> 3) & 1, e = (bits >> 2) & 1, ll = bits & 3;
+    *big_endian = !e;
+
+    // Half and quad precision floats and tag 76 (reserved) are not supported
+    if (f) {
+        if (ll != 1 && ll != 2)
+            return -1;
+        *type = ll == 1 ? CBOR_TYPED_F32 : CBOR_TYPED_F64;
+        return 0;
+    }
+    if (ll == 0 && s && e)
+        return -1;
+    static const cbor_typed_t unsigned_types[4] = {
+        CBOR_TYPED_U8, CBOR_TYPED_U16, CBOR_TYPED_U32, CBOR_TYPED_U64 };
+    static const cbor_typed_t signed_types[4] = {
+        CBOR_TYPED_I8, CBOR_TYPED_I16, CBOR_TYPED_I32, CBOR_TYPED_I64 };
+    *type = s ? signed_types[ll] : unsigned_types[ll];
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Encoding
+// -----------------------------------------------------------------------------
+
+void cbor_encoder_init(cbor_encoder_t* enc, uint8_t* buffer, size_t size) {
+    enc->data = buffer;
+    enc->size = size;
+    enc->pos = 0;
+}
+
+static inline size_t head_size(uint64_t arg) {
+    return arg < 24 ? 1 : arg <= 0xFF ? 2 : arg <= 0xFFFF ? 3 : arg <= 0xFFFFFFFFu ? 5 : 9;
+}
+
+// Writes an item head, reserving room for extra payload bytes after it
+static int put_head(cbor_encoder_t* enc, unsigned major, uint64_t arg, size_t extra) {
+    const size_t n = head_size(arg);
+    if (!enc || enc->size - enc->pos < n || enc->size - enc->pos - n < extra)
+        return -1;
+
+    uint8_t* p = enc->data + enc->pos;
+    const uint8_t initial = (uint8_t)(major << 5);
+    switch (n) {
+        case 1: p[0] = initial | (uint8_t)arg; break;
+        case 2: p[0] = initial | 24; p[1] = (uint8_t)arg; break;
+        case 3: p[0] = initial | 25; store_be16(p + 1, (uint16_t)arg); break;
+        case 5: p[0] = initial | 26; store_be32(p + 1, (uint32_t)arg); break;
+        default: p[0] = initial | 27; store_be64(p + 1, arg); break;
+    }
+    enc->pos += n;
+    return 0;
+}
+
+int cbor_encode_uint(cbor_encoder_t* enc, uint64_t value) {
+    return put_head(enc, CBOR_MAJOR_UINT, value, 0);
+}
+
+int cbor_encode_int(cbor_encoder_t* enc, int64_t value) {
+    if (value >= 0)
+        return put_head(enc, CBOR_MAJOR_UINT, (uint64_t)value, 0);
+    return put_head(enc, CBOR_MAJOR_NEGINT, ~(uint64_t)value, 0);
+}
+
+static int put_string(cbor_encoder_t* enc, unsigned major, const void* data, size_t len) {
+    if ((!data && len > 0) || put_head(enc, major, len, len) != 0)
+        return -1;
+    if (len > 0)
+        memcpy(enc->data + enc->pos, data, len);
+    enc->pos += len;
+    return 0;
+}
+
+int cbor_encode_bytes(cbor_encoder_t* enc, const uint8_t* data, size_t len) {
+    return put_string(enc, CBOR_MAJOR_BYTES, data, len);
+}
+
+int cbor_encode_text(cbor_encoder_t* enc, const char* str, size_t len) {
+    return put_string(enc, CBOR_MAJOR_TEXT, str, len);
+}
+
+int cbor_encode_array(cbor_encoder_t* enc, uint64_t count) {
+    return put_head(enc, CBOR_MAJOR_ARRAY, count, 0);
+}
+
+int cbor_encode_map(cbor_encoder_t* enc, uint64_t pairs) {
+    return put_head(enc, CBOR_MAJOR_MAP, pairs, 0);
+}
+
+int cbor_encode_tag(cbor_encoder_t* enc, uint64_t tag) {
+    return put_head(enc, CBOR_MAJOR_TAG, tag, 0);
+}
+
+int cbor_encode_bool(cbor_encoder_t* enc, int value) {
+    return put_head(enc, CBOR_MAJOR_SIMPLE, value ? 21 : 20, 0);
+}
+
+int cbor_encode_null(cbor_encoder_t* enc) {
+    return put_head(enc, CBOR_MAJOR_SIMPLE, 22, 0);
+}
+
+int cbor_encode_float(cbor_encoder_t* enc, float value) {
+    if (!enc || enc->size - enc->pos < 5)
+        return -1;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    enc->data[enc->pos] = (CBOR_MAJOR_SIMPLE << 5) | 26;
+    store_be32(enc->data + enc->pos + 1, bits);
+    enc->pos += 5;
+    return 0;
+}
+
+int cbor_encode_double(cbor_encoder_t* enc, double value) {
+    if (!enc || enc->size - enc->pos < 9)
+        return -1;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    enc->data[enc->pos] = (CBOR_MAJOR_SIMPLE << 5) | 27;
+    store_be64(enc->data + enc->pos + 1, bits);
+    enc->pos += 9;
+    return 0;
+}
+
+int cbor_encode_typed_array(cbor_encoder_t* enc, cbor_typed_t type, const void* data,
+                            size_t count, int big_endian) {
+    const size_t size = cbor_typed_size(type);
+    if (!enc || size == 0 || (!data && count > 0) || count > SIZE_MAX / size)
+        return -1;
+
+    const size_t start = enc->pos;
+    const size_t len = count * size;
+    if (cbor_encode_tag(enc, typed_tag(type, big_endian)) != 0)
+        return -1;
+    if (put_head(enc, CBOR_MAJOR_BYTES, len, len) != 0) {
+        enc->pos = start;
+        return -1;
+    }
+
+    // Copy, then swap the output in place with the block kernels
+    uint8_t* dst = enc->data + enc->pos;
+    if (len > 0)
+        memcpy(dst, data, len);
+    if (big_endian)
+        convert_be(dst, count, size);
+    else
+        convert_le(dst, count, size);
+    enc->pos += len;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Decoding
+// -----------------------------------------------------------------------------
+
+void cbor_decoder_init(cbor_decoder_t* dec, const uint8_t* data, size_t size) {
+    dec->data = data;
+    dec->size = size;
+    dec->pos = 0;
+}
+
+// Widens an IEEE half to double by rebuilding the bit pattern; subnormals
+// are scaled exactly.
+static double half_to_double(uint16_t h) {
+    const uint64_t sign = (uint64_t)(h >> 15) << 63;
+    const unsigned exponent = (h >> 10) & 0x1F;
+    const uint64_t mantissa = h & 0x3FF;
+
+    double value;
+    if (exponent == 0) {
+        value = (double)mantissa / 16777216.0;   // 2^-24
+        return sign ? -value : value;
+    }
+    const uint64_t e = exponent == 31 ? 0x7FF : exponent - 15 + 1023;
+    const uint64_t bits = sign | (e << 52) | (mantissa << 42);
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int cbor_decode_next(cbor_decoder_t* dec, cbor_item_t* item) {
+    if (!dec || !item || dec->pos >= dec->size)
+        return -1;
+
+    const uint8_t* p = dec->data + dec->pos;
+    const size_t avail = dec->size - dec->pos;
+    const unsigned major = p[0] >> 5;
+    const unsigned info = p[0] & 0x1F;
+
+    // Argument: inline, or 1/2/4/8 following bytes
+    uint64_t arg = info;
+    size_t n = 1;
+    switch (info) {
+        case 24: n = 2; break;
+        case 25: n = 3; break;
+        case 26: n = 5; break;
+        case 27: n = 9; break;
+        case 28: case 29: case 30: return -1;
+    }
+    if (avail < n)
+        return -1;
+    switch (n) {
+        case 2: arg = p[1]; break;
+        case 3: arg = load_be16(p + 1); break;
+        case 5: arg = load_be32(p + 1); break;
+        case 9: arg = load_be64(p + 1); break;
+    }
+
+    const int indefinite = info == CBOR_INDEFINITE;
+    item->value = indefinite ? 0 : arg;
+    item->number = 0.0;
+    item->data = NULL;
+    item->indefinite = indefinite;
+
+    switch (major) {
+        case CBOR_MAJOR_UINT:
+        case CBOR_MAJOR_NEGINT:
+        case CBOR_MAJOR_TAG:
+            if (indefinite)
+                return -1;
+            item->type = major == CBOR_MAJOR_UINT ? CBOR_UINT
+                       : major == CBOR_MAJOR_NEGINT ? CBOR_NEGINT : CBOR_TAG;
+            break;
+
+        case CBOR_MAJOR_BYTES:
+        case CBOR_MAJOR_TEXT:
+            item->type = major == CBOR_MAJOR_BYTES ? CBOR_BYTES : CBOR_TEXT;
+            if (!indefinite) {
+                if (arg > avail - n)
+                    return -1;
+                item->data = p + n;
+                n += (size_t)arg;
+            }
+            break;
+
+        case CBOR_MAJOR_ARRAY:
+        case CBOR_MAJOR_MAP:
+            item->type = major == CBOR_MAJOR_ARRAY ? CBOR_ARRAY : CBOR_MAP;
+            break;
+
+        default:
+            item->indefinite = 0;
+            switch (info) {
+                case 20:
+                case 21: item->type = CBOR_BOOL; item->value = info - 20; break;
+                case 22: item->type = CBOR_NULL; break;
+                case 23: item->type = CBOR_UNDEFINED; break;
+                case 24:
+                    if (arg < 32)
+                        return -1;
+                    item->type = CBOR_SIMPLE;
+                    break;
+                case 25:
+                    item->type = CBOR_FLOAT;
+                    item->number = half_to_double((uint16_t)arg);
+                    break;
+                case 26: {
+                    const uint32_t bits = (uint32_t)arg;
+                    float f;
+                    memcpy(&f, &bits, sizeof(f));
+                    item->type = CBOR_FLOAT;
+                    item->number = f;
+                    break;
+                }
+                case 27:
+                    item->type = CBOR_FLOAT;
+                    memcpy(&item->number, &arg, sizeof(arg));
+                    break;
+                case CBOR_INDEFINITE: item->type = CBOR_BREAK; break;
+                default: item->type = CBOR_SIMPLE; break;
+            }
+            break;
+    }
+
+    dec->pos += n;
+    return 0;
+}
+
+int cbor_skip(cbor_decoder_t* dec) {
+    if (!dec)
+        return -1;
+
+    // Items still expected at each open level; UINT64_MAX marks an
+    // indefinite-length container that ends with a break.
+    uint64_t pending[CBOR_MAX_DEPTH];
+    size_t depth = 0;
+    const size_t start = dec->pos;
+
+    do {
+        cbor_item_t item;
+        if (cbor_decode_next(dec, &item) != 0)
+            goto fail;
+
+        uint64_t children = 0;
+        if (item.type == CBOR_BREAK) {
+            if (depth == 0 || pending[depth - 1] != UINT64_MAX)
+                goto fail;
+            depth--;
+        } else if (item.indefinite) {
+            children = UINT64_MAX;
+        } else if (item.type == CBOR_ARRAY) {
+            children = item.value;
+        } else if (item.type == CBOR_MAP) {
+            if (item.value >= UINT64_MAX / 2)
+                goto fail;
+            children = 2 * item.value;
+        } else if (item.type == CBOR_TAG) {
+            children = 1;
+        }
+
+        if (children > 0) {
+            if (depth == CBOR_MAX_DEPTH)
+                goto fail;
+            pending[depth++] = children;
+            continue;
+        }
+
+        // The item is complete; close every definite container it finishes
+        while (depth > 0 && pending[depth - 1] != UINT64_MAX && --pending[depth - 1] == 0)
+            depth--;
+    } while (depth > 0);
+    return 0;
+
+fail:
+    dec->pos = start;
+    return -1;
+}
+
+int cbor_decode_typed_array(cbor_decoder_t* dec, cbor_typed_t* type, void* out,
+                            size_t out_size, size_t* count) {
+    if (!dec || !type || !count || (!out && out_size > 0))
+        return -1;
+
+    const size_t start = dec->pos;
+    cbor_item_t tag, bytes;
+    int big_endian;
+    if (cbor_decode_next(dec, &tag) != 0 || tag.type != CBOR_TAG ||
+        typed_from_tag(tag.value, type, &big_endian) != 0 ||
+        cbor_decode_next(dec, &bytes) != 0 || bytes.type != CBOR_BYTES || bytes.indefinite)
+        goto fail;
+
+    const size_t size = cbor_typed_size(*type);
+    if (bytes.value % size != 0 || bytes.value > out_size)
+        goto fail;
+
+    const size_t n = (size_t)bytes.value / size;
+    if (n > 0)
+        memcpy(out, bytes.data, (size_t)bytes.value);
+    if (big_endian)
+        convert_be((uint8_t*)out, n, size);
+    else
+        convert_le((uint8_t*)out, n, size);
+    *count = n;
+    return 0;
+
+fail:
+    dec->pos = start;
+    return -1;
+}
@@ -0,0 +1,157 @@
+#ifndef CBOR_IO_H
+#define CBOR_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum nesting depth handled by cbor_skip().
+#define CBOR_MAX_DEPTH 64
+
+/// Kind of a decoded data item header.
+typedef enum {
+    CBOR_UINT,          ///< value holds the integer
+    CBOR_NEGINT,        ///< the integer is -1 - value
+    CBOR_BYTES,         ///< value bytes at data; chunks follow if indefinite
+    CBOR_TEXT,          ///< value UTF-8 bytes at data; chunks follow if indefinite
+    CBOR_ARRAY,         ///< value items follow (until CBOR_BREAK if indefinite)
+    CBOR_MAP,           ///< value key/value pairs follow (until CBOR_BREAK if indefinite)
+    CBOR_TAG,           ///< value is the tag; the tagged item follows
+    CBOR_SIMPLE,        ///< value is an unassigned simple value
+    CBOR_BOOL,          ///< value is 0 or 1
+    CBOR_NULL,
+    CBOR_UNDEFINED,
+    CBOR_FLOAT,         ///< number holds a half, single or double value
+    CBOR_BREAK          ///< end of an indefinite-length item
+} cbor_type_t;
+
+/// Element types of RFC 8746 typed arrays.
+typedef enum {
+    CBOR_TYPED_U8,
+    CBOR_TYPED_U16,
+    CBOR_TYPED_U32,
+    CBOR_TYPED_U64,
+    CBOR_TYPED_I8,
+    CBOR_TYPED_I16,
+    CBOR_TYPED_I32,
+    CBOR_TYPED_I64,
+    CBOR_TYPED_F32,
+    CBOR_TYPED_F64
+} cbor_typed_t;
+
+/// Header of one data item; strings point into the input buffer.
+typedef struct {
+    cbor_type_t type;
+    uint64_t value;
+    double number;
+    const uint8_t* data;
+    int indefinite;
+} cbor_item_t;
+
+/// Encoder writing into a caller-provided buffer.
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t pos;     ///< Bytes written so far
+} cbor_encoder_t;
+
+/// Pull decoder reading from a caller-provided buffer.
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;     ///< Bytes consumed so far
+} cbor_decoder_t;
+
+// -----------------------------------------------------------------------------
+// Encoding
+// -----------------------------------------------------------------------------
+
+// Each encoder returns 0 on success and -1 if the item does not fit; a failed
+// call leaves the encoder unchanged.
+
+void cbor_encoder_init(cbor_encoder_t* enc, uint8_t* buffer, size_t size);
+
+int cbor_encode_uint(cbor_encoder_t* enc, uint64_t value);
+int cbor_encode_int(cbor_encoder_t* enc, int64_t value);
+int cbor_encode_bytes(cbor_encoder_t* enc, const uint8_t* data, size_t len);
+int cbor_encode_text(cbor_encoder_t* enc, const char* str, size_t len);
+int cbor_encode_array(cbor_encoder_t* enc, uint64_t count);
+int cbor_encode_map(cbor_encoder_t* enc, uint64_t pairs);
+int cbor_encode_tag(cbor_encoder_t* enc, uint64_t tag);
+int cbor_encode_bool(cbor_encoder_t* enc, int value);
+int cbor_encode_null(cbor_encoder_t* enc);
+int cbor_encode_float(cbor_encoder_t* enc, float value);
+int cbor_encode_double(cbor_encoder_t* enc, double value);
+
+/**
+ * @brief Encodes an RFC 8746 typed array (tag 64-87 plus a byte string).
+ *
+ * The elements are copied and swapped to the requested byte order in one
+ * pass over the output.
+ *
+ * @param enc         Encoder.
+ * @param type        Element type.
+ * @param data        Native-order elements.
+ * @param count       Number of elements.
+ * @param big_endian  1 to store big-endian elements, 0 for little-endian.
+ * @return 0 on success, -1 if the array does not fit.
+ */
+int cbor_encode_typed_array(cbor_encoder_t* enc, cbor_typed_t type, const void* data,
+                            size_t count, int big_endian);
+
+// -----------------------------------------------------------------------------
+// Decoding
+// -----------------------------------------------------------------------------
+
+void cbor_decoder_init(cbor_decoder_t* dec, const uint8_t* data, size_t size);
+
+/**
+ * @brief Decodes the next item header.
+ *
+ * Arrays, maps and tags return only their header; the enclosed items are
+ * returned by subsequent calls. Definite strings are consumed whole and
+ * returned as a pointer into the input.
+ *
+ * @param dec   Decoder.
+ * @param item  Receives the item.
+ * @return 0 on success, -1 on truncated or malformed input.
+ */
+int cbor_decode_next(cbor_decoder_t* dec, cbor_item_t* item);
+
+/**
+ * @brief Skips the next complete item, including nested items.
+ *
+ * @return 0 on success, -1 on truncated or malformed input or nesting deeper
+ *         than CBOR_MAX_DEPTH.
+ */
+int cbor_skip(cbor_decoder_t* dec);
+
+/**
+ * @brief Decodes an RFC 8746 typed array into native-order elements.
+ *
+ * The next item must be a typed-array tag followed by a definite byte string.
+ * The payload is copied and swapped to host order in one pass.
+ *
+ * @param dec       Decoder.
+ * @param type      Receives the element type.
+ * @param out       Output buffer.
+ * @param out_size  Size of the output buffer in bytes.
+ * @param count     Receives the number of elements.
+ * @return 0 on success, -1 on malformed input, unsupported type or
+ *         insufficient space.
+ */
+int cbor_decode_typed_array(cbor_decoder_t* dec, cbor_typed_t* type, void* out,
+                            size_t out_size, size_t* count);
+
+/**
+ * @brief Returns the size in bytes of one typed-array element.
+ */
+size_t cbor_typed_size(cbor_typed_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CBOR_IO_H
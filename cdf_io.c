@@ -0,0 +1,509 @@
+#include "cdf_io.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define CDF_BUFFER_SIZE 65536
+#define CDF_MAX_PENDING 1024
+
+// Header list tags
+#define CDF_TAG_ABSENT 0x00
+#define CDF_TAG_DIMENSION 0x0A
+#define CDF_TAG_VARIABLE 0x0B
+#define CDF_TAG_ATTRIBUTE 0x0C
+
+#define CDF_STREAMING 0xFFFFFFFFu
+#define CDF_UNKNOWN_SIZE UINT64_MAX
+
+size_t cdf_type_size(cdf_type_t type) {
+    switch (type) {
+        case CDF_BYTE:
+        case CDF_CHAR:
+        case CDF_UBYTE:  return 1;
+        case CDF_SHORT:
+        case CDF_USHORT: return 2;
+        case CDF_INT:
+        case CDF_FLOAT:
+        case CDF_UINT:   return 4;
+        case CDF_DOUBLE:
+        case CDF_INT64:
+        case CDF_UINT64: return 8;
+    }
+    return 0;
+}
+
+static inline uint64_t pad4(uint64_t n) {
+    return (n + 3) & ~(uint64_t)3;
+}
+
+// -----------------------------------------------------------------------------
+// Byte Source
+// -----------------------------------------------------------------------------
+
+// Sequential (header) and random (data) access over a byte source
+typedef struct {
+    const endian_source_t* stream;
+    uint64_t size;      ///< Length of the stream, or CDF_UNKNOWN_SIZE
+    int staged;         ///< 1 to gather nearby runs through a staging buffer
+    size_t pos;
+    int version;
+} cdf_source_t;
+
+static int source_take(cdf_source_t* src, void* dst, size_t n) {
+    if (src->stream->read(src->stream->ctx, (uint8_t*)dst, n) != 0)
+        return -1;
+    src->pos += n;
+    return 0;
+}
+
+// Sources without a seek hook skip by reading
+static int source_skip(cdf_source_t* src, uint64_t n) {
+    if (src->stream->seek) {
+        if (n > SIZE_MAX - src->pos || src->stream->seek(src->stream->ctx, src->pos + n) != 0)
+            return -1;
+        src->pos += (size_t)n;
+        return 0;
+    }
+    uint8_t scratch[256];
+    while (n > 0) {
+        const size_t chunk = n < sizeof(scratch) ? (size_t)n : sizeof(scratch);
+        if (source_take(src, scratch, chunk) != 0)
+            return -1;
+        n -= chunk;
+    }
+    return 0;
+}
+
+static int source_read_at(const cdf_source_t* src, uint64_t offset, void* dst, size_t n) {
+    return endian_source_read_at(src->stream, offset, (uint8_t*)dst, n);
+}
+
+static int get_u32(cdf_source_t* src, uint32_t* value) {
+    uint8_t b[4];
+    if (source_take(src, b, sizeof(b)) != 0)
+        return -1;
+    *value = load_be32(b);
+    return 0;
+}
+
+static int get_u64(cdf_source_t* src, uint64_t* value) {
+    uint8_t b[8];
+    if (source_take(src, b, sizeof(b)) != 0)
+        return -1;
+    *value = load_be64(b);
+    return 0;
+}
+
+// NON_NEG is 32 bits in CDF-1/2 and 64 bits in CDF-5
+static int get_non_neg(cdf_source_t* src, uint64_t* value) {
+    if (src->version == 5)
+        return get_u64(src, value);
+    uint32_t v;
+    if (get_u32(src, &v) != 0)
+        return -1;
+    *value = v;
+    return 0;
+}
+
+// OFFSET is 32 bits in CDF-1 and 64 bits in CDF-2/5
+static int get_offset(cdf_source_t* src, uint64_t* value) {
+    if (src->version != 1)
+        return get_u64(src, value);
+    uint32_t v;
+    if (get_u32(src, &v) != 0)
+        return -1;
+    *value = v;
+    return 0;
+}
+
+static int get_name(cdf_source_t* src, char* name) {
+    uint64_t length;
+    if (get_non_neg(src, &length) != 0 || length > CDF_MAX_NAME)
+        return -1;
+    if (source_take(src, name, (size_t)length) != 0)
+        return -1;
+    name[length] = '\0';
+    return source_skip(src, pad4(length) - length);
+}
+
+// -----------------------------------------------------------------------------
+// Header Parsing
+// -----------------------------------------------------------------------------
+
+// Reads a list tag and element count; an absent list yields 0 elements
+static int get_list(cdf_source_t* src, uint32_t expected, uint64_t* nelems) {
+    uint32_t tag;
+    if (get_u32(src, &tag) != 0 || get_non_neg(src, nelems) != 0)
+        return -1;
+    if (tag == CDF_TAG_ABSENT)
+        return *nelems == 0 ? 0 : -1;
+    return tag == expected ? 0 : -1;
+}
+
+static int skip_attributes(cdf_source_t* src) {
+    uint64_t nattrs;
+    if (get_list(src, CDF_TAG_ATTRIBUTE, &nattrs) != 0)
+        return -1;
+
+    char name[CDF_MAX_NAME + 1];
+    for (uint64_t i = 0; i < nattrs; i++) {
+        uint32_t type;
+        uint64_t nelems;
+        if (get_name(src, name) != 0 || get_u32(src, &type) != 0 ||
+            get_non_neg(src, &nelems) != 0)
+            return -1;
+        const size_t size = cdf_type_size((cdf_type_t)type);
+        if (size == 0 || nelems > UINT64_MAX / 8)
+            return -1;
+        if (source_skip(src, pad4(nelems * size)) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+// Allocates n zeroed elements, refusing counts the source cannot back
+static void* alloc_table(const cdf_source_t* src, uint64_t n, size_t size) {
+    if (n == 0 || n > SIZE_MAX / size || n > src->size)
+        return NULL;
+    return calloc((size_t)n, size);
+}
+
+// Unpadded size of one record's worth (or all) of a variable's data
+static int var_bytes(const cdf_var_t* var, uint64_t* bytes) {
+    uint64_t n = cdf_type_size(var->type);
+    for (size_t d = var->is_record ? 1 : 0; d < var->ndims; d++) {
+        if (var->shape[d] != 0 && n > UINT64_MAX / var->shape[d])
+            return -1;
+        n *= var->shape[d];
+    }
+    *bytes = n;
+    return 0;
+}
+
+static int parse_variable(cdf_source_t* src, cdf_file_t* cdf, cdf_var_t* var) {
+    uint64_t ndims;
+    if (get_name(src, var->name) != 0 || get_non_neg(src, &ndims) != 0 ||
+        ndims > CDF_MAX_VAR_DIMS)
+        return -1;
+
+    var->ndims = (size_t)ndims;
+    for (size_t d = 0; d < var->ndims; d++) {
+        uint64_t id;
+        if (get_non_neg(src, &id) != 0 || id >= cdf->ndims)
+            return -1;
+        var->dimids[d] = (size_t)id;
+        var->shape[d] = cdf->dims[id].length;
+
+        // Only the first dimension may be the record dimension
+        if (var->shape[d] == 0) {
+            if (d != 0)
+                return -1;
+            var->is_record = 1;
+        }
+    }
+
+    uint32_t type;
+    uint64_t vsize;
+    if (skip_attributes(src) != 0 || get_u32(src, &type) != 0 ||
+        get_non_neg(src, &vsize) != 0 || get_offset(src, &var->begin) != 0)
+        return -1;
+    var->type = (cdf_type_t)type;
+    const size_t size = cdf_type_size(var->type);
+    if (size == 0)
+        return -1;
+
+    // vsize is recomputed: writers clamp the stored value for variables over 4 GiB
+    (void)vsize;
+    uint64_t bytes;
+    if (var_bytes(var, &bytes) != 0)
+        return -1;
+    var->vsize = pad4(bytes);
+    return 0;
+}
+
+static int parse_header(cdf_source_t* src, cdf_file_t* cdf) {
+    memset(cdf, 0, sizeof(*cdf));
+
+    uint8_t magic[4];
+    if (source_take(src, magic, sizeof(magic)) != 0 || memcmp(magic, "CDF", 3) != 0)
+        return -1;
+    if (magic[3] != 1 && magic[3] != 2 && magic[3] != 5)
+        return -1;
+    cdf->version = src->version = magic[3];
+
+    uint64_t numrecs, ndims, nvars;
+    if (get_non_neg(src, &numrecs) != 0 || get_list(src, CDF_TAG_DIMENSION, &ndims) != 0)
+        return -1;
+    const int streaming = cdf->version != 5 && numrecs == CDF_STREAMING;
+
+    if (ndims > 0) {
+        cdf->dims = (cdf_dim_t*)alloc_table(src, ndims, sizeof(cdf_dim_t));
+        if (!cdf->dims)
+            return -1;
+        cdf->ndims = (size_t)ndims;
+        for (size_t i = 0; i < cdf->ndims; i++)
+            if (get_name(src, cdf->dims[i].name) != 0 ||
+                get_non_neg(src, &cdf->dims[i].length) != 0)
+                return -1;
+    }
+
+    if (skip_attributes(src) != 0 || get_list(src, CDF_TAG_VARIABLE, &nvars) != 0)
+        return -1;
+
+    if (nvars > 0) {
+        cdf->vars = (cdf_var_t*)alloc_table(src, nvars, sizeof(cdf_var_t));
+        if (!cdf->vars)
+            return -1;
+        cdf->nvars = (size_t)nvars;
+    }
+
+    size_t record_vars = 0;
+    uint64_t first_record = UINT64_MAX;
+    for (size_t i = 0; i < cdf->nvars; i++) {
+        cdf_var_t* var = &cdf->vars[i];
+        if (parse_variable(src, cdf, var) != 0)
+            return -1;
+        if (var->is_record) {
+            record_vars++;
+            cdf->record_size += var->vsize;
+            if (var->begin < first_record)
+                first_record = var->begin;
+        }
+    }
+
+    // A lone record variable is stored without padding between records
+    if (record_vars == 1) {
+        for (size_t i = 0; i < cdf->nvars; i++)
+            if (cdf->vars[i].is_record)
+                var_bytes(&cdf->vars[i], &cdf->record_size);
+    }
+
+    cdf->header_size = src->pos;
+    cdf->numrecs = numrecs;
+
+    // Streaming files leave numrecs unset; derive it from the file size
+    if (streaming) {
+        const uint64_t size = src->size;
+        if (size == CDF_UNKNOWN_SIZE)
+            return -1;
+        cdf->numrecs = cdf->record_size > 0 && size > first_record
+                       ? (size - first_record) / cdf->record_size : 0;
+    }
+
+    for (size_t i = 0; i < cdf->nvars; i++)
+        if (cdf->vars[i].is_record)
+            cdf->vars[i].shape[0] = cdf->numrecs;
+    return 0;
+}
+
+static int read_header(const endian_source_t* stream, uint64_t size, cdf_file_t* cdf) {
+    cdf_source_t src = { stream, size, 0, 0, 0 };
+    const int status = parse_header(&src, cdf);
+    if (status != 0)
+        cdf_free(cdf);
+    return status;
+}
+
+int cdf_parse_header(const uint8_t* data, size_t size, cdf_file_t* cdf) {
+    if (!data || !cdf)
+        return -1;
+    endian_buffer_t buf = { (uint8_t*)data, size, 0 };
+    endian_source_t stream;
+    endian_source_from_buffer(&stream, &buf);
+    return read_header(&stream, size, cdf);
+}
+
+int cdf_read_header(FILE* file, cdf_file_t* cdf) {
+    if (!file || !cdf)
+        return -1;
+
+    // The file length bounds the header tables and sizes streaming files
+    long end;
+    if (fseek(file, 0, SEEK_END) != 0 || (end = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0)
+        return -1;
+    endian_source_t stream;
+    endian_source_from_file(&stream, file);
+    return read_header(&stream, (uint64_t)end, cdf);
+}
+
+int cdf_read_header_source(const endian_source_t* src, cdf_file_t* cdf) {
+    if (!src || !src->read || !cdf)
+        return -1;
+    return read_header(src, CDF_UNKNOWN_SIZE, cdf);
+}
+
+void cdf_free(cdf_file_t* cdf) {
+    if (!cdf)
+        return;
+    free(cdf->dims);
+    free(cdf->vars);
+    cdf->dims = NULL;
+    cdf->vars = NULL;
+    cdf->ndims = 0;
+    cdf->nvars = 0;
+}
+
+const cdf_var_t* cdf_find_var(const cdf_file_t* cdf, const char* name) {
+    if (!cdf || !name)
+        return NULL;
+    for (size_t i = 0; i < cdf->nvars; i++)
+        if (strcmp(cdf->vars[i].name, name) == 0)
+            return &cdf->vars[i];
+    return NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Hyperslab Reads
+// -----------------------------------------------------------------------------
+
+// Collects equally sized runs at increasing offsets. For files, runs that fit
+// in one staging window are fetched with a single read and gathered from it;
+// memory sources are copied directly.
+typedef struct {
+    const cdf_source_t* src;
+    uint8_t* buffer;
+    uint8_t* out;
+    size_t run;
+    size_t pending;
+    uint64_t offsets[CDF_MAX_PENDING];
+} cdf_gather_t;
+
+static int gather_flush(cdf_gather_t* g) {
+    if (g->pending == 0)
+        return 0;
+
+    const uint64_t window = g->offsets[0];
+    const size_t span = (size_t)(g->offsets[g->pending - 1] - window) + g->run;
+    if (source_read_at(g->src, window, g->buffer, span) != 0)
+        return -1;
+    for (size_t i = 0; i < g->pending; i++) {
+        memcpy(g->out, g->buffer + (g->offsets[i] - window), g->run);
+        g->out += g->run;
+    }
+    g->pending = 0;
+    return 0;
+}
+
+static int gather_run(cdf_gather_t* g, uint64_t offset) {
+    if (!g->buffer) {
+        if (source_read_at(g->src, offset, g->out, g->run) != 0)
+            return -1;
+        g->out += g->run;
+        return 0;
+    }
+
+    if (g->pending > 0 && (g->pending == CDF_MAX_PENDING ||
+                           offset + g->run - g->offsets[0] > CDF_BUFFER_SIZE))
+        if (gather_flush(g) != 0)
+            return -1;
+    g->offsets[g->pending++] = offset;
+    return 0;
+}
+
+static int read_slab(const cdf_source_t* src, const cdf_file_t* cdf, const cdf_var_t* var,
+                     const size_t* start, const size_t* count, uint8_t* out) {
+    const size_t size = cdf_type_size(var->type);
+    const size_t nd = var->ndims;
+    if (size == 0 || (nd > 0 && (!start || !count)))
+        return -1;
+
+    uint64_t total = 1;
+    for (size_t d = 0; d < nd; d++) {
+        if (start[d] > var->shape[d] || count[d] > var->shape[d] - start[d])
+            return -1;
+        total *= count[d];
+    }
+    if (total == 0)
+        return 0;
+
+    // Byte stride of each dimension; records are record_size apart
+    uint64_t stride[CDF_MAX_VAR_DIMS];
+    uint64_t step = size;
+    for (size_t d = nd; d-- > 0; ) {
+        if (d == 0 && var->is_record) {
+            stride[d] = cdf->record_size;
+        } else {
+            stride[d] = step;
+            step *= var->shape[d];
+        }
+    }
+
+    // Merge trailing dimensions into one contiguous run. The merge stops after
+    // the first partially selected dimension and never crosses records.
+    size_t outer = nd;
+    uint64_t run = size;
+    while (outer > (var->is_record ? 1u : 0u)) {
+        const size_t d = --outer;
+        run *= count[d];
+        if (count[d] != var->shape[d])
+            break;
+    }
+    const uint64_t base = var->begin + (outer < nd ? start[outer] * stride[outer] : 0);
+
+    cdf_gather_t g;
+    g.src = src;
+    g.buffer = NULL;
+    g.out = out;
+    g.run = (size_t)run;
+    g.pending = 0;
+    if (src->staged && outer > 0 && run < CDF_BUFFER_SIZE / 2) {
+        g.buffer = (uint8_t*)malloc(CDF_BUFFER_SIZE);
+        if (!g.buffer)
+            return -1;
+    }
+
+    // Odometer over the outer dimensions
+    size_t index[CDF_MAX_VAR_DIMS] = { 0 };
+    int status = 0;
+    for (;;) {
+        uint64_t offset = base;
+        for (size_t d = 0; d < outer; d++)
+            offset += (start[d] + index[d]) * stride[d];
+        if ((status = gather_run(&g, offset)) != 0)
+            break;
+
+        size_t d = outer;
+        while (d > 0 && ++index[d - 1] == count[d - 1])
+            index[--d] = 0;
+        if (d == 0)
+            break;
+    }
+
+    if (status == 0)
+        status = gather_flush(&g);
+    free(g.buffer);
+    if (status != 0)
+        return -1;
+
+    // One pass over the gathered values converts them to host order
+    return convert_be(out, (size_t)total, size);
+}
+
+int cdf_read_vara(FILE* file, const cdf_file_t* cdf, const cdf_var_t* var,
+                  const size_t* start, const size_t* count, void* out) {
+    if (!file)
+        return -1;
+    endian_source_t stream;
+    endian_source_from_file(&stream, file);
+    return cdf_read_vara_source(&stream, cdf, var, start, count, out);
+}
+
+int cdf_read_vara_source(const endian_source_t* src, const cdf_file_t* cdf,
+                         const cdf_var_t* var, const size_t* start, const size_t* count,
+                         void* out) {
+    if (!src || !src->seek || !cdf || !var || !out)
+        return -1;
+    const cdf_source_t slab = { src, CDF_UNKNOWN_SIZE, 1, 0, cdf->version };
+    return read_slab(&slab, cdf, var, start, count, (uint8_t*)out);
+}
+
+int cdf_decode_vara(const uint8_t* data, size_t size, const cdf_file_t* cdf,
+                    const cdf_var_t* var, const size_t* start, const size_t* count,
+                    void* out) {
+    if (!data || !cdf || !var || !out)
+        return -1;
+    endian_buffer_t buf = { (uint8_t*)data, size, 0 };
+    endian_source_t stream;
+    endian_source_from_buffer(&stream, &buf);
+    const cdf_source_t src = { &stream, size, 0, 0, cdf->version };
+    return read_slab(&src, cdf, var, start, count, (uint8_t*)out);
+}
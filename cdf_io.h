@@ -0,0 +1,152 @@
+#ifndef CDF_IO_H
+#define CDF_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CDF_MAX_NAME 256
+#define CDF_MAX_VAR_DIMS 32
+
+/// External data types of the classic (CDF-1/2) and 64-bit data (CDF-5) formats.
+typedef enum {
+    CDF_BYTE = 1,
+    CDF_CHAR = 2,
+    CDF_SHORT = 3,
+    CDF_INT = 4,
+    CDF_FLOAT = 5,
+    CDF_DOUBLE = 6,
+    CDF_UBYTE = 7,      ///< CDF-5 only
+    CDF_USHORT = 8,     ///< CDF-5 only
+    CDF_UINT = 9,       ///< CDF-5 only
+    CDF_INT64 = 10,     ///< CDF-5 only
+    CDF_UINT64 = 11     ///< CDF-5 only
+} cdf_type_t;
+
+/// Named dimension. The record (unlimited) dimension has length 0.
+typedef struct {
+    char name[CDF_MAX_NAME + 1];
+    uint64_t length;
+} cdf_dim_t;
+
+/// Variable description from the header.
+typedef struct {
+    char name[CDF_MAX_NAME + 1];
+    cdf_type_t type;
+    size_t ndims;
+    size_t dimids[CDF_MAX_VAR_DIMS];
+    uint64_t shape[CDF_MAX_VAR_DIMS];   ///< Dimension lengths; numrecs for the record dimension
+    int is_record;                      ///< 1 if the first dimension is the record dimension
+    uint64_t vsize;                     ///< Padded size of one record's (or the whole) data
+    uint64_t begin;                     ///< File offset of the data
+} cdf_var_t;
+
+/// Parsed header of a netCDF classic file.
+typedef struct {
+    int version;            ///< 1 (classic), 2 (64-bit offset) or 5 (64-bit data)
+    uint64_t numrecs;       ///< Number of records
+    uint64_t record_size;   ///< Distance between consecutive records
+    size_t ndims;
+    cdf_dim_t* dims;
+    size_t nvars;
+    cdf_var_t* vars;
+    size_t header_size;
+} cdf_file_t;
+
+/**
+ * @brief Returns the size in bytes of one value of the given type, or 0.
+ */
+size_t cdf_type_size(cdf_type_t type);
+
+/**
+ * @brief Parses the header of a netCDF file held in memory.
+ *
+ * Global and variable attributes are skipped.
+ *
+ * @param data  Start of the file, e.g. an mmapped region.
+ * @param size  Number of bytes available.
+ * @param cdf   Receives the header; release with cdf_free().
+ * @return 0 on success, -1 on error or malformed input.
+ */
+int cdf_parse_header(const uint8_t* data, size_t size, cdf_file_t* cdf);
+
+/**
+ * @brief Reads the header of a netCDF file.
+ *
+ * @param file  Open binary file positioned at the start.
+ * @param cdf   Receives the header; release with cdf_free().
+ * @return 0 on success, -1 on error or malformed input.
+ */
+int cdf_read_header(FILE* file, cdf_file_t* cdf);
+
+/**
+ * @brief Source counterpart of cdf_read_header().
+ *
+ * The source only needs to read forward. Its length is unknown, so
+ * streaming files (numrecs left unset by the writer) are rejected.
+ *
+ * @param src  Input stream positioned at the start of the file.
+ * @param cdf  Receives the header; release with cdf_free().
+ * @return 0 on success, -1 on error, malformed input or a streaming file.
+ */
+int cdf_read_header_source(const endian_source_t* src, cdf_file_t* cdf);
+
+/**
+ * @brief Releases the dimension and variable tables.
+ */
+void cdf_free(cdf_file_t* cdf);
+
+/**
+ * @brief Looks up a variable by name.
+ *
+ * @return The variable, or NULL if not found.
+ */
+const cdf_var_t* cdf_find_var(const cdf_file_t* cdf, const char* name);
+
+/**
+ * @brief Reads a hyperslab of a variable into a native array.
+ *
+ * The slab is split into the longest contiguous runs the layout allows.
+ * Runs close to each other (e.g. one record variable across many records)
+ * are fetched with one read and gathered from a staging buffer, and the
+ * whole result is swapped to host order in a single pass.
+ *
+ * @param file   Open binary file.
+ * @param cdf    Parsed header.
+ * @param var    Variable from cdf.
+ * @param start  Index of the first element along each dimension.
+ * @param count  Number of elements along each dimension.
+ * @param out    Output array of prod(count) values in row-major order.
+ * @return 0 on success, -1 on error or out-of-range slab.
+ */
+int cdf_read_vara(FILE* file, const cdf_file_t* cdf, const cdf_var_t* var,
+                  const size_t* start, const size_t* count, void* out);
+
+/// Source counterpart of cdf_read_vara(); src must have a seek hook.
+int cdf_read_vara_source(const endian_source_t* src, const cdf_file_t* cdf,
+                         const cdf_var_t* var, const size_t* start, const size_t* count,
+                         void* out);
+
+/**
+ * @brief In-memory counterpart of cdf_read_vara().
+ *
+ * @param data   Start of the file.
+ * @param size   Number of bytes available.
+ * @param cdf    Parsed header.
+ * @param var    Variable from cdf.
+ * @param start  Index of the first element along each dimension.
+ * @param count  Number of elements along each dimension.
+ * @param out    Output array of prod(count) values in row-major order.
+ * @return 0 on success, -1 on error or out-of-range slab.
+ */
+int cdf_decode_vara(const uint8_t* data, size_t size, const cdf_file_t* cdf,
+                    const cdf_var_t* var, const size_t* start, const size_t* count,
+                    void* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CDF_IO_H
@@ -1,4 +1,5 @@
 #include "endian_io.h"
+#include <limits.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -16,6 +17,12 @@ static inline int is_little_endian(void) {
     return *((uint8_t*)&x) == 1;
 }
 
+static inline int needs_swap(endian_t file_endian) {
+    const int host_little = is_little_endian();
+    return (host_little && file_endian == ENDIAN_BIG) ||
+           (!host_little && file_endian == ENDIAN_LITTLE);
+}
+
 // -----------------------------------------------------------------------------
 // Byte-Swap Helpers
 // -----------------------------------------------------------------------------
@@ -74,21 +81,293 @@ static inline void convert_endian(void* elem, size_t size) {
 }
 
 // -----------------------------------------------------------------------------
-// Generic File I/O (Private)
+// Vector Kernels
 // -----------------------------------------------------------------------------
+// 16-byte shuffles written with the GCC/Clang vector extensions, which lower
+// to the target's native byte permute (pshufb, tbl, vperm, ...) on any
+// architecture. Define ENDIAN_IO_NO_VECTOR to build the scalar loops only.
+#if !defined(ENDIAN_IO_NO_VECTOR) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define ENDIAN_IO_VECTOR 1
 
-static int write_endian(FILE* file, const uint8_t* data,
-                        size_t num, size_t size, endian_t target_endian) {
-    if (!file || !data || size == 0 || num == 0)
+typedef uint8_t byte_vec_t __attribute__((vector_size(16)));
+
+#if defined(__clang__)
+#define SHUFFLE_BYTES(v, ...) __builtin_shufflevector((v), (v), __VA_ARGS__)
+#else
+#define SHUFFLE_BYTES(v, ...) __builtin_shuffle((v), (byte_vec_t){ __VA_ARGS__ })
+#endif
+
+// Swaps whole 16-byte blocks, two per iteration, and returns the number of
+// bytes processed; the caller finishes the tail with the scalar loop.
+#define DEFINE_VECTOR_SWAP(BITS, ...) \
+static size_t vector_swap##BITS(uint8_t* data, size_t bytes) { \
+    size_t i = 0; \
+    for (; i + 32 <= bytes; i += 32) { \
+        byte_vec_t a, b; \
+        memcpy(&a, data + i, 16); \
+        memcpy(&b, data + i + 16, 16); \
+        a = SHUFFLE_BYTES(a, __VA_ARGS__); \
+        b = SHUFFLE_BYTES(b, __VA_ARGS__); \
+        memcpy(data + i, &a, 16); \
+        memcpy(data + i + 16, &b, 16); \
+    } \
+    if (i + 16 <= bytes) { \
+        byte_vec_t a; \
+        memcpy(&a, data + i, 16); \
+        a = SHUFFLE_BYTES(a, __VA_ARGS__); \
+        memcpy(data + i, &a, 16); \
+        i += 16; \
+    } \
+    return i; \
+}
+
+DEFINE_VECTOR_SWAP(16, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+DEFINE_VECTOR_SWAP(32, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+DEFINE_VECTOR_SWAP(64, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8)
+
+// Copies n bytes in reverse order, 16 at a time; returns the bytes done
+static size_t vector_reverse_copy(uint8_t* dst, const uint8_t* src, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        byte_vec_t a;
+        memcpy(&a, src + n - 16 - i, 16);
+        a = SHUFFLE_BYTES(a, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        memcpy(dst + i, &a, 16);
+    }
+    return i;
+}
+
+#if !defined(__clang__)
+// GCC also accepts a run-time mask, which backs the general byte orders
+#define ENDIAN_IO_RUNTIME_SHUFFLE 1
+
+static size_t vector_permute(uint8_t* data, size_t bytes, const uint8_t* mask) {
+    byte_vec_t m;
+    memcpy(&m, mask, 16);
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        byte_vec_t a;
+        memcpy(&a, data + i, 16);
+        a = __builtin_shuffle(a, m);
+        memcpy(data + i, &a, 16);
+    }
+    return i;
+}
+#endif
+#endif
+
+// Swaps every element of an array in place. The switch is hoisted out of the
+// loop; with ENDIAN_IO_VECTOR the bulk goes through the vector kernels and
+// the scalar loops only handle the tail.
+static void swap_array(uint8_t* data, size_t num, size_t size) {
+    size_t start = 0;
+    switch (size) {
+        case 1:
+            break;
+        case 2:
+#ifdef ENDIAN_IO_VECTOR
+            start = vector_swap16(data, num * 2) / 2;
+#endif
+            for (size_t i = start; i < num; i++) {
+                uint16_t v;
+                memcpy(&v, data + i * 2, 2);
+                v = bswap16(v);
+                memcpy(data + i * 2, &v, 2);
+            }
+            break;
+        case 4:
+#ifdef ENDIAN_IO_VECTOR
+            start = vector_swap32(data, num * 4) / 4;
+#endif
+            for (size_t i = start; i < num; i++) {
+                uint32_t v;
+                memcpy(&v, data + i * 4, 4);
+                v = bswap32(v);
+                memcpy(data + i * 4, &v, 4);
+            }
+            break;
+        case 8:
+#ifdef ENDIAN_IO_VECTOR
+            start = vector_swap64(data, num * 8) / 8;
+#endif
+            for (size_t i = start; i < num; i++) {
+                uint64_t v;
+                memcpy(&v, data + i * 8, 8);
+                v = bswap64(v);
+                memcpy(data + i * 8, &v, 8);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < num; i++)
+                reverse_bytes(data + i * size, size);
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Sources and Sinks
+// -----------------------------------------------------------------------------
+static int file_read(void* ctx, uint8_t* dst, size_t n) {
+    return fread(dst, 1, n, (FILE*)ctx) == n ? 0 : -1;
+}
+
+static int file_write(void* ctx, const uint8_t* src, size_t n) {
+    return fwrite(src, 1, n, (FILE*)ctx) == n ? 0 : -1;
+}
+
+static int file_seek(void* ctx, uint64_t offset) {
+    if (offset > LONG_MAX || fseek((FILE*)ctx, (long)offset, SEEK_SET) != 0)
         return -1;
+    return 0;
+}
 
-    const int host_little = is_little_endian();
-    const int swap_needed = (host_little && target_endian == ENDIAN_BIG) ||
-                            (!host_little && target_endian == ENDIAN_LITTLE);
+void endian_source_from_file(endian_source_t* src, FILE* file) {
+    src->read = file_read;
+    src->direct = NULL;
+    src->ctx = file;
+    src->seek = file_seek;
+}
+
+void endian_sink_from_file(endian_sink_t* sink, FILE* file) {
+    sink->write = file_write;
+    sink->direct = NULL;
+    sink->ctx = file;
+}
+
+static const uint8_t* buffer_direct_read(void* ctx, size_t n) {
+    endian_buffer_t* buf = (endian_buffer_t*)ctx;
+    if (buf->size - buf->pos < n)
+        return NULL;
+    const uint8_t* p = buf->data + buf->pos;
+    buf->pos += n;
+    return p;
+}
+
+static int buffer_read(void* ctx, uint8_t* dst, size_t n) {
+    const uint8_t* p = buffer_direct_read(ctx, n);
+    if (!p)
+        return -1;
+    if (n)
+        memcpy(dst, p, n);
+    return 0;
+}
+
+static int buffer_seek(void* ctx, uint64_t offset) {
+    endian_buffer_t* buf = (endian_buffer_t*)ctx;
+    if (offset > buf->size)
+        return -1;
+    buf->pos = (size_t)offset;
+    return 0;
+}
+
+static uint8_t* buffer_direct_write(void* ctx, size_t n) {
+    endian_buffer_t* buf = (endian_buffer_t*)ctx;
+    if (buf->size - buf->pos < n)
+        return NULL;
+    uint8_t* p = buf->data + buf->pos;
+    buf->pos += n;
+    return p;
+}
+
+static int buffer_write(void* ctx, const uint8_t* src, size_t n) {
+    uint8_t* p = buffer_direct_write(ctx, n);
+    if (!p)
+        return -1;
+    if (n)
+        memcpy(p, src, n);
+    return 0;
+}
+
+void endian_source_from_buffer(endian_source_t* src, endian_buffer_t* buf) {
+    src->read = buffer_read;
+    src->direct = buffer_direct_read;
+    src->ctx = buf;
+    src->seek = buffer_seek;
+}
+
+void endian_sink_from_buffer(endian_sink_t* sink, endian_buffer_t* buf) {
+    sink->write = buffer_write;
+    sink->direct = buffer_direct_write;
+    sink->ctx = buf;
+}
+
+int endian_source_read_at(const endian_source_t* src, uint64_t offset, uint8_t* dst, size_t n) {
+    if (!src || !src->seek || (!dst && n > 0))
+        return -1;
+    if (src->seek(src->ctx, offset) != 0)
+        return -1;
+    return n == 0 ? 0 : src->read(src->ctx, dst, n);
+}
+
+// -----------------------------------------------------------------------------
+// Buffered Writer
+// -----------------------------------------------------------------------------
+
+void endian_writer_init(endian_writer_t* w, const endian_sink_t* sink,
+                        uint8_t* buffer, size_t capacity) {
+    w->sink = *sink;
+    w->buffer = buffer;
+    w->capacity = capacity;
+    w->fill = 0;
+    w->error = 0;
+}
+
+static void drain(endian_writer_t* w) {
+    if (w->fill > 0 && !w->error && w->sink.write(w->sink.ctx, w->buffer, w->fill) != 0)
+        w->error = 1;
+    w->fill = 0;
+}
+
+uint8_t* endian_writer_reserve(endian_writer_t* w, size_t n) {
+    if (w->capacity - w->fill < n)
+        drain(w);
+    return w->error || n > w->capacity ? NULL : w->buffer + w->fill;
+}
+
+int endian_writer_write(endian_writer_t* w, const uint8_t* src, size_t n) {
+    if (w->capacity - w->fill < n) {
+        drain(w);
+        // Large writes go straight to the sink
+        if (n >= w->capacity) {
+            if (!w->error && w->sink.write(w->sink.ctx, src, n) != 0)
+                w->error = 1;
+            return w->error ? -1 : 0;
+        }
+    }
+    if (n)
+        memcpy(w->buffer + w->fill, src, n);
+    w->fill += n;
+    return w->error ? -1 : 0;
+}
+
+int endian_writer_flush(endian_writer_t* w) {
+    drain(w);
+    return w->error ? -1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Generic Stream I/O (Private)
+// -----------------------------------------------------------------------------
+
+static int write_endian_to(const endian_sink_t* sink, const uint8_t* data,
+                           size_t num, size_t size, endian_t target_endian) {
+    if (!sink || !sink->write || !data || size == 0 || num == 0 || num > SIZE_MAX / size)
+        return -1;
+
+    const int swap_needed = needs_swap(target_endian);
 
     // Fast path: same endianness → direct block write
     if (!swap_needed)
-        return fwrite(data, size, num, file) == num ? 0 : -1;
+        return sink->write(sink->ctx, data, num * size);
+
+    // Zero-copy path: convert straight into the sink's storage
+    uint8_t* direct = sink->direct ? sink->direct(sink->ctx, num * size) : NULL;
+    if (direct) {
+        memcpy(direct, data, num * size);
+        swap_array(direct, num, size);
+        return 0;
+    }
 
     // Choose a conservative, portable alignment
     const size_t buffer_size = 256;
@@ -110,26 +389,26 @@ static int write_endian(FILE* file, const uint8_t* data,
         return -1;
 
     const size_t block_elems = buffer_size / size;
+    if (block_elems == 0) {
+        // Elements larger than the staging buffer go one at a time
+        for (size_t i = 0; i < num; i++) {
+            const uint8_t* elem = data + i * size;
+            for (size_t k = size; k-- > 0; ) {
+                if (sink->write(sink->ctx, elem + k, 1) != 0)
+                    goto fail;
+            }
+        }
+    }
 
-    for (size_t offset = 0; offset < num; ) {
+    for (size_t offset = 0; block_elems && offset < num; ) {
         size_t batch = num - offset < block_elems ? num - offset : block_elems;
 
         // Copy + endian swap into buffer
-        for (size_t i = 0; i < batch; i++) {
-            uint8_t* dst = buffer + i * size;
-            const uint8_t* src = data + (offset + i) * size;
-            memcpy(dst, src, size);
-            convert_endian(dst, size);
-        }
+        memcpy(buffer, data + offset * size, batch * size);
+        swap_array(buffer, batch, size);
 
-        if (fwrite(buffer, size, batch, file) != batch) {
-#if !defined(_ISOC11_SOURCE) && !defined(_POSIX_VERSION)
-            // No free needed for stack buffer
-#else
-            free(buffer);
-#endif
-            return -1;
-        }
+        if (sink->write(sink->ctx, buffer, batch * size) != 0)
+            goto fail;
 
         offset += batch;
     }
@@ -137,27 +416,57 @@ static int write_endian(FILE* file, const uint8_t* data,
 #if defined(_ISOC11_SOURCE) || defined(_POSIX_VERSION)
     free(buffer);
 #endif
+    return 0;
+
+fail:
+#if defined(_ISOC11_SOURCE) || defined(_POSIX_VERSION)
+    free(buffer);
+#endif
+    return -1;
+}
+
+static int read_endian_from(const endian_source_t* src, uint8_t* data,
+                            size_t num, size_t size, endian_t source_endian) {
+    if (!src || !src->read || !data || size == 0 || num > SIZE_MAX / size)
+        return -1;
+
+    const int swap_needed = needs_swap(source_endian);
 
+    // Block read (or copy out of the source's storage), then swap in place
+    const uint8_t* direct = src->direct ? src->direct(src->ctx, num * size) : NULL;
+    if (direct)
+        memcpy(data, direct, num * size);
+    else if (src->read(src->ctx, data, num * size) != 0)
+        return -1;
+    if (swap_needed)
+        swap_array(data, num, size);
     return 0;
 }
 
+// FILE* adapters over the stream code
+static int write_endian(FILE* file, const uint8_t* data,
+                        size_t num, size_t size, endian_t target_endian) {
+    if (!file)
+        return -1;
+    endian_sink_t sink;
+    endian_sink_from_file(&sink, file);
+    return write_endian_to(&sink, data, num, size, target_endian);
+}
 
 static int read_endian(FILE* file, uint8_t* data,
                        size_t num, size_t size, endian_t source_endian) {
-    if (!file || !data || size == 0)
+    if (!file)
         return -1;
+    endian_source_t src;
+    endian_source_from_file(&src, file);
+    return read_endian_from(&src, data, num, size, source_endian);
+}
 
-    const int host_little = is_little_endian();
-    const int swap_needed = (host_little && source_endian == ENDIAN_BIG) ||
-                            (!host_little && source_endian == ENDIAN_LITTLE);
-
-    for (size_t i = 0; i < num; i++) {
-        uint8_t* dst = data + i * size;
-        if (fread(dst, 1, size, file) != size)
-            return -1;
-        if (swap_needed)
-            convert_endian(dst, size);
-    }
+static int convert_array(uint8_t* data, size_t num, size_t size, endian_t data_endian) {
+    if (!data || size == 0)
+        return -1;
+    if (needs_swap(data_endian))
+        swap_array(data, num, size);
     return 0;
 }
 
@@ -180,6 +489,14 @@ int read_le(FILE* file, uint8_t* data, size_t num, size_t size) {
     return read_endian(file, data, num, size, ENDIAN_LITTLE);
 }
 
+int convert_be(uint8_t* data, size_t num, size_t size) {
+    return convert_array(data, num, size, ENDIAN_BIG);
+}
+
+int convert_le(uint8_t* data, size_t num, size_t size) {
+    return convert_array(data, num, size, ENDIAN_LITTLE);
+}
+
 
 // Helper macro to generate implementations
 #define DEFINE_ENDIAN_IO_FUNCS(NUMBERTYPE, ENDIAN) \
@@ -213,3 +530,1605 @@ DEFINE_ENDIAN_IO_FUNCS(int32_t, le)
 DEFINE_ENDIAN_IO_FUNCS(int64_t, le)
 DEFINE_ENDIAN_IO_FUNCS(float, le)
 DEFINE_ENDIAN_IO_FUNCS(double, le)
+
+int write_be_to(const endian_sink_t* sink, const uint8_t* data, size_t num, size_t size) {
+    return write_endian_to(sink, data, num, size, ENDIAN_BIG);
+}
+
+int read_be_from(const endian_source_t* src, uint8_t* data, size_t num, size_t size) {
+    return read_endian_from(src, data, num, size, ENDIAN_BIG);
+}
+
+int write_le_to(const endian_sink_t* sink, const uint8_t* data, size_t num, size_t size) {
+    return write_endian_to(sink, data, num, size, ENDIAN_LITTLE);
+}
+
+int read_le_from(const endian_source_t* src, uint8_t* data, size_t num, size_t size) {
+    return read_endian_from(src, data, num, size, ENDIAN_LITTLE);
+}
+
+#define DEFINE_STREAM_IO_FUNCS(NUMBERTYPE, ENDIAN) \
+int write_##NUMBERTYPE##_##ENDIAN##_to(const endian_sink_t* sink, const NUMBERTYPE* arr, size_t n) { \
+    return write_##ENDIAN##_to(sink, (const uint8_t*)arr, n, sizeof(NUMBERTYPE)); \
+} \
+int read_##NUMBERTYPE##_##ENDIAN##_from(const endian_source_t* src, NUMBERTYPE* arr, size_t n) { \
+    return read_##ENDIAN##_from(src, (uint8_t*)arr, n, sizeof(NUMBERTYPE)); \
+}
+
+DEFINE_STREAM_IO_FUNCS(uint8_t, be)
+DEFINE_STREAM_IO_FUNCS(uint16_t, be)
+DEFINE_STREAM_IO_FUNCS(uint32_t, be)
+DEFINE_STREAM_IO_FUNCS(uint64_t, be)
+DEFINE_STREAM_IO_FUNCS(int8_t, be)
+DEFINE_STREAM_IO_FUNCS(int16_t, be)
+DEFINE_STREAM_IO_FUNCS(int32_t, be)
+DEFINE_STREAM_IO_FUNCS(int64_t, be)
+DEFINE_STREAM_IO_FUNCS(float, be)
+DEFINE_STREAM_IO_FUNCS(double, be)
+
+DEFINE_STREAM_IO_FUNCS(uint8_t, le)
+DEFINE_STREAM_IO_FUNCS(uint16_t, le)
+DEFINE_STREAM_IO_FUNCS(uint32_t, le)
+DEFINE_STREAM_IO_FUNCS(uint64_t, le)
+DEFINE_STREAM_IO_FUNCS(int8_t, le)
+DEFINE_STREAM_IO_FUNCS(int16_t, le)
+DEFINE_STREAM_IO_FUNCS(int32_t, le)
+DEFINE_STREAM_IO_FUNCS(int64_t, le)
+DEFINE_STREAM_IO_FUNCS(float, le)
+DEFINE_STREAM_IO_FUNCS(double, le)
+
+// -----------------------------------------------------------------------------
+// Bit-Packed Integer Arrays
+// -----------------------------------------------------------------------------
+#define PACKED_HEADER_SIZE 6
+#define PACKED_BUFFER_SIZE 256
+
+static unsigned bit_width_u32(uint32_t x) {
+    unsigned width = 0;
+    while (x) {
+        width++;
+        x >>= 1;
+    }
+    return width;
+}
+
+int write_packed_u32(FILE* file, const uint32_t* arr, size_t n, bit_order_t order) {
+    if (!file || !arr || n == 0)
+        return -1;
+    if (order != BIT_ORDER_MSB_FIRST && order != BIT_ORDER_LSB_FIRST)
+        return -1;
+
+    uint32_t base = arr[0], max = arr[0];
+    for (size_t i = 1; i < n; i++) {
+        if (arr[i] < base) base = arr[i];
+        if (arr[i] > max)  max = arr[i];
+    }
+    const unsigned width = bit_width_u32(max - base);
+
+    uint8_t header[PACKED_HEADER_SIZE] = {
+        (uint8_t)(base >> 24), (uint8_t)(base >> 16),
+        (uint8_t)(base >> 8),  (uint8_t)base,
+        (uint8_t)width, (uint8_t)order
+    };
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header))
+        return -1;
+    if (width == 0)
+        return 0;
+
+    // Bits accumulate in a 64-bit word and drain a byte at a time; with
+    // width <= 32 the accumulator never holds more than 39 live bits.
+    uint8_t buffer[PACKED_BUFFER_SIZE];
+    size_t fill = 0;
+    uint64_t acc = 0;
+    unsigned bits = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t v = (uint64_t)(arr[i] - base);
+        if (order == BIT_ORDER_MSB_FIRST) {
+            acc = (acc << width) | v;
+            bits += width;
+            while (bits >= 8) {
+                bits -= 8;
+                buffer[fill++] = (uint8_t)(acc >> bits);
+            }
+        } else {
+            acc |= v << bits;
+            bits += width;
+            while (bits >= 8) {
+                buffer[fill++] = (uint8_t)acc;
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        // At most 5 bytes are emitted per value
+        if (fill > PACKED_BUFFER_SIZE - 8) {
+            if (fwrite(buffer, 1, fill, file) != fill)
+                return -1;
+            fill = 0;
+        }
+    }
+
+    // Flush the trailing partial byte, padded with zero bits
+    if (bits > 0) {
+        buffer[fill++] = order == BIT_ORDER_MSB_FIRST ? (uint8_t)(acc << (8 - bits))
+                                                      : (uint8_t)acc;
+    }
+    return fwrite(buffer, 1, fill, file) == fill ? 0 : -1;
+}
+
+int read_packed_u32(FILE* file, uint32_t* arr, size_t n) {
+    if (!file || !arr || n == 0)
+        return -1;
+
+    uint8_t header[PACKED_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header))
+        return -1;
+
+    const uint32_t base = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) |
+                          ((uint32_t)header[2] << 8)  |  (uint32_t)header[3];
+    const unsigned width = header[4];
+    const bit_order_t order = (bit_order_t)header[5];
+    if (width > 32 || (order != BIT_ORDER_MSB_FIRST && order != BIT_ORDER_LSB_FIRST))
+        return -1;
+
+    if (width == 0) {
+        for (size_t i = 0; i < n; i++)
+            arr[i] = base;
+        return 0;
+    }
+
+    const uint64_t mask = ((uint64_t)1 << width) - 1;
+    size_t remaining = (n / 8) * width + ((n % 8) * width + 7) / 8;
+    uint8_t buffer[PACKED_BUFFER_SIZE];
+    size_t pos = 0, avail = 0;
+    uint64_t acc = 0;
+    unsigned bits = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        while (bits < width) {
+            if (pos == avail) {
+                avail = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+                if (fread(buffer, 1, avail, file) != avail)
+                    return -1;
+                remaining -= avail;
+                pos = 0;
+            }
+            if (order == BIT_ORDER_MSB_FIRST)
+                acc = (acc << 8) | buffer[pos++];
+            else
+                acc |= (uint64_t)buffer[pos++] << bits;
+            bits += 8;
+        }
+        if (order == BIT_ORDER_MSB_FIRST) {
+            bits -= width;
+            arr[i] = base + (uint32_t)((acc >> bits) & mask);
+        } else {
+            arr[i] = base + (uint32_t)(acc & mask);
+            acc >>= width;
+            bits -= width;
+        }
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Byte-Plane Shuffle
+// -----------------------------------------------------------------------------
+#define SHUFFLE_BUFFER_SIZE 4096
+
+// Plane k holds byte k of every element in file order. Mapping the plane to a
+// host byte index folds the endian swap into the transpose.
+static int write_shuffle_endian(FILE* file, const uint8_t* data,
+                                size_t num, size_t size, endian_t target_endian) {
+    if (!file || !data || size == 0 || num == 0)
+        return -1;
+
+    const int swap_needed = needs_swap(target_endian);
+    uint8_t buffer[SHUFFLE_BUFFER_SIZE];
+
+    for (size_t plane = 0; plane < size; plane++) {
+        const uint8_t* src = data + (swap_needed ? size - 1 - plane : plane);
+
+        for (size_t offset = 0; offset < num; ) {
+            size_t batch = num - offset < sizeof(buffer) ? num - offset : sizeof(buffer);
+
+            for (size_t i = 0; i < batch; i++)
+                buffer[i] = src[(offset + i) * size];
+
+            if (fwrite(buffer, 1, batch, file) != batch)
+                return -1;
+            offset += batch;
+        }
+    }
+    return 0;
+}
+
+static int read_shuffle_endian(FILE* file, uint8_t* data,
+                               size_t num, size_t size, endian_t source_endian) {
+    if (!file || !data || size == 0)
+        return -1;
+
+    const int swap_needed = needs_swap(source_endian);
+    uint8_t buffer[SHUFFLE_BUFFER_SIZE];
+
+    for (size_t plane = 0; plane < size; plane++) {
+        uint8_t* dst = data + (swap_needed ? size - 1 - plane : plane);
+
+        for (size_t offset = 0; offset < num; ) {
+            size_t batch = num - offset < sizeof(buffer) ? num - offset : sizeof(buffer);
+
+            if (fread(buffer, 1, batch, file) != batch)
+                return -1;
+
+            for (size_t i = 0; i < batch; i++)
+                dst[(offset + i) * size] = buffer[i];
+            offset += batch;
+        }
+    }
+    return 0;
+}
+
+int write_shuffle_be(FILE* file, const uint8_t* data, size_t num, size_t size) {
+    return write_shuffle_endian(file, data, num, size, ENDIAN_BIG);
+}
+
+int read_shuffle_be(FILE* file, uint8_t* data, size_t num, size_t size) {
+    return read_shuffle_endian(file, data, num, size, ENDIAN_BIG);
+}
+
+int write_shuffle_le(FILE* file, const uint8_t* data, size_t num, size_t size) {
+    return write_shuffle_endian(file, data, num, size, ENDIAN_LITTLE);
+}
+
+int read_shuffle_le(FILE* file, uint8_t* data, size_t num, size_t size) {
+    return read_shuffle_endian(file, data, num, size, ENDIAN_LITTLE);
+}
+
+// -----------------------------------------------------------------------------
+// Bit Streams
+// -----------------------------------------------------------------------------
+
+// Tops the cache up to at least 57 bits. With 8 bytes buffered this is a
+// single 64-bit load; bytes already partially in the cache are OR-ed in again
+// at the same position, which leaves them unchanged.
+static void bit_reader_refill(bit_reader_t* br) {
+    if (br->count > 56)
+        return;
+
+    if (br->avail - br->pos < 8) {
+        const size_t left = br->avail - br->pos;
+        memmove(br->buffer, br->buffer + br->pos, left);
+        br->pos = 0;
+        br->avail = left + fread(br->buffer + left, 1, sizeof(br->buffer) - left, br->file);
+    }
+
+    if (br->avail - br->pos >= 8) {
+        if (br->order == BIT_ORDER_MSB_FIRST)
+            br->cache |= load_be64(br->buffer + br->pos) >> br->count;
+        else
+            br->cache |= load_le64(br->buffer + br->pos) << br->count;
+        br->pos += (63 - br->count) >> 3;
+        br->count |= 56;
+        return;
+    }
+
+    // Tail of the file: refill one byte at a time
+    while (br->count <= 56 && br->pos < br->avail) {
+        const uint64_t byte = br->buffer[br->pos++];
+        if (br->order == BIT_ORDER_MSB_FIRST)
+            br->cache |= byte << (56 - br->count);
+        else
+            br->cache |= byte << br->count;
+        br->count += 8;
+    }
+}
+
+int bit_reader_init(bit_reader_t* br, FILE* file, bit_order_t order) {
+    if (!br || !file)
+        return -1;
+    if (order != BIT_ORDER_MSB_FIRST && order != BIT_ORDER_LSB_FIRST)
+        return -1;
+
+    br->file = file;
+    br->order = order;
+    br->cache = 0;
+    br->count = 0;
+    br->pos = 0;
+    br->avail = 0;
+    return 0;
+}
+
+uint64_t bit_reader_peek(bit_reader_t* br, unsigned n) {
+    // A refill only guarantees 57 bits; wider peeks are rejected like reads
+    if (!br || n == 0 || n > 56)
+        return 0;
+    if (br->count < n)
+        bit_reader_refill(br);
+    // Cache bits beyond count are either upcoming stream bits or zero
+    if (br->order == BIT_ORDER_MSB_FIRST)
+        return (br->cache >> 1) >> (63 - n);
+    return br->cache & (((uint64_t)1 << n) - 1);
+}
+
+void bit_reader_consume(bit_reader_t* br, unsigned n) {
+    if (!br)
+        return;
+    if (n > br->count)
+        n = br->count;
+    if (br->order == BIT_ORDER_MSB_FIRST)
+        br->cache <<= n;
+    else
+        br->cache >>= n;
+    br->count -= n;
+}
+
+int bit_reader_read(bit_reader_t* br, unsigned n, uint64_t* value) {
+    if (!br || !value || n > 56)
+        return -1;
+    if (br->count < n) {
+        bit_reader_refill(br);
+        if (br->count < n)
+            return -1;
+    }
+    *value = bit_reader_peek(br, n);
+    bit_reader_consume(br, n);
+    return 0;
+}
+
+int bit_reader_read_array(bit_reader_t* br, unsigned width, uint32_t* arr, size_t count) {
+    if (!br || !arr || width > 32)
+        return -1;
+
+    const uint64_t mask = ((uint64_t)1 << width) - 1;
+
+    if (br->order == BIT_ORDER_MSB_FIRST) {
+        for (size_t i = 0; i < count; i++) {
+            if (br->count < width) {
+                bit_reader_refill(br);
+                if (br->count < width)
+                    return -1;
+            }
+            arr[i] = (uint32_t)((br->cache >> 1) >> (63 - width));
+            br->cache <<= width;
+            br->count -= width;
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            if (br->count < width) {
+                bit_reader_refill(br);
+                if (br->count < width)
+                    return -1;
+            }
+            arr[i] = (uint32_t)(br->cache & mask);
+            br->cache >>= width;
+            br->count -= width;
+        }
+    }
+    return 0;
+}
+
+void bit_reader_align(bit_reader_t* br) {
+    bit_reader_consume(br, br->count & 7);
+}
+
+// Moves whole bytes from the cache into the staging buffer. The buffer always
+// has room for one unconditional 8-byte store.
+static void bit_writer_drain(bit_writer_t* bw) {
+    const unsigned bytes = bw->count >> 3;
+
+    if (bw->order == BIT_ORDER_MSB_FIRST) {
+        store_be64(bw->buffer + bw->fill, bw->cache);
+        bw->cache <<= bytes * 8;
+    } else {
+        store_le64(bw->buffer + bw->fill, bw->cache);
+        bw->cache >>= bytes * 8;
+    }
+    bw->fill += bytes;
+    bw->count &= 7;
+
+    if (bw->fill > sizeof(bw->buffer) - 8) {
+        if (fwrite(bw->buffer, 1, bw->fill, bw->file) != bw->fill)
+            bw->error = 1;
+        bw->fill = 0;
+    }
+}
+
+int bit_writer_init(bit_writer_t* bw, FILE* file, bit_order_t order) {
+    if (!bw || !file)
+        return -1;
+    if (order != BIT_ORDER_MSB_FIRST && order != BIT_ORDER_LSB_FIRST)
+        return -1;
+
+    bw->file = file;
+    bw->order = order;
+    bw->cache = 0;
+    bw->count = 0;
+    bw->fill = 0;
+    bw->error = 0;
+    return 0;
+}
+
+int bit_writer_write(bit_writer_t* bw, uint64_t value, unsigned n) {
+    if (!bw || n > 56)
+        return -1;
+    if (n == 0)
+        return bw->error ? -1 : 0;
+
+    value &= ((uint64_t)1 << n) - 1;
+    if (bw->order == BIT_ORDER_MSB_FIRST)
+        bw->cache |= value << (64 - n - bw->count);
+    else
+        bw->cache |= value << bw->count;
+    bw->count += n;
+    bit_writer_drain(bw);
+    return bw->error ? -1 : 0;
+}
+
+int bit_writer_write_array(bit_writer_t* bw, unsigned width, const uint32_t* arr, size_t count) {
+    if (!bw || !arr || width > 32)
+        return -1;
+
+    for (size_t i = 0; i < count; i++) {
+        if (bit_writer_write(bw, arr[i], width) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+int bit_writer_flush(bit_writer_t* bw) {
+    if (!bw)
+        return -1;
+
+    bw->count = (bw->count + 7) & ~7u;
+    bit_writer_drain(bw);
+    if (bw->fill > 0) {
+        if (fwrite(bw->buffer, 1, bw->fill, bw->file) != bw->fill)
+            bw->error = 1;
+        bw->fill = 0;
+    }
+    return bw->error ? -1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+// UTF-16 / UTF-32 Transcoding
+// -----------------------------------------------------------------------------
+#define UTF_BUFFER_SIZE 4096
+
+// Chunk kernel: transcodes complete code points and reports how many input
+// units and output units it used. Returns -1 on invalid input or when the
+// output does not fit (readers) and 0 otherwise.
+typedef int (*utf_chunk_fn)(const uint8_t* src, size_t n, endian_t e, int final,
+                            uint8_t* dst, size_t cap, size_t* consumed, size_t* produced);
+
+static inline uint32_t load_unit16(const uint8_t* p, endian_t e) {
+    return e == ENDIAN_BIG ? load_be16(p) : load_le16(p);
+}
+
+static inline uint32_t load_unit32(const uint8_t* p, endian_t e) {
+    return e == ENDIAN_BIG ? load_be32(p) : load_le32(p);
+}
+
+static inline uint64_t load_word64(const uint8_t* p, endian_t e) {
+    return e == ENDIAN_BIG ? load_be64(p) : load_le64(p);
+}
+
+// Returns the number of bytes written, or 0 if cp does not fit in cap.
+static inline size_t utf8_encode(uint32_t cp, uint8_t* dst, size_t cap) {
+    if (cp < 0x80) {
+        if (cap < 1) return 0;
+        dst[0] = (uint8_t)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        if (cap < 2) return 0;
+        dst[0] = (uint8_t)(0xC0 | (cp >> 6));
+        dst[1] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        if (cap < 3) return 0;
+        dst[0] = (uint8_t)(0xE0 | (cp >> 12));
+        dst[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (cap < 4) return 0;
+    dst[0] = (uint8_t)(0xF0 | (cp >> 18));
+    dst[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = (uint8_t)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// Returns the length of the sequence, or 0 if it is truncated, overlong,
+// a surrogate or beyond U+10FFFF.
+static inline size_t utf8_decode(const uint8_t* s, size_t len, uint32_t* cp) {
+    const uint8_t b0 = s[0];
+    if (b0 < 0x80) {
+        *cp = b0;
+        return 1;
+    }
+
+    size_t n;
+    uint32_t c, min;
+    if ((b0 & 0xE0) == 0xC0)      { n = 2; c = b0 & 0x1F; min = 0x80; }
+    else if ((b0 & 0xF0) == 0xE0) { n = 3; c = b0 & 0x0F; min = 0x800; }
+    else if ((b0 & 0xF8) == 0xF0) { n = 4; c = b0 & 0x07; min = 0x10000; }
+    else return 0;
+
+    if (len < n)
+        return 0;
+    for (size_t i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80)
+            return 0;
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+        return 0;
+    *cp = c;
+    return n;
+}
+
+static int utf16_to_utf8_chunk(const uint8_t* src, size_t n, endian_t e, int final,
+                               uint8_t* dst, size_t cap, size_t* consumed, size_t* produced) {
+    const uint64_t ascii_mask = 0xFF80FF80FF80FF80ULL;
+    const size_t low = e == ENDIAN_BIG ? 1 : 0;
+    size_t i = 0, o = 0;
+
+    while (i < n) {
+        // ASCII fast path: 16 code units per iteration
+        if (n - i >= 16 && cap - o >= 16) {
+            const uint8_t* p = src + 2 * i;
+            const uint64_t any = load_word64(p, e) | load_word64(p + 8, e) |
+                                 load_word64(p + 16, e) | load_word64(p + 24, e);
+            if ((any & ascii_mask) == 0) {
+                for (size_t k = 0; k < 16; k++)
+                    dst[o + k] = p[2 * k + low];
+                i += 16;
+                o += 16;
+                continue;
+            }
+        }
+
+        uint32_t cp = load_unit16(src + 2 * i, e);
+        size_t units = 1;
+        if (cp >= 0xD800 && cp <= 0xDFFF) {
+            if (cp >= 0xDC00)
+                return -1;
+            if (i + 1 >= n) {
+                if (final)
+                    return -1;
+                break; // high surrogate split across chunks
+            }
+            const uint32_t lo = load_unit16(src + 2 * i + 2, e);
+            if (lo < 0xDC00 || lo > 0xDFFF)
+                return -1;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            units = 2;
+        }
+
+        const size_t len = utf8_encode(cp, dst + o, cap - o);
+        if (len == 0)
+            return -1;
+        o += len;
+        i += units;
+    }
+
+    *consumed = i;
+    *produced = o;
+    return 0;
+}
+
+static int utf32_to_utf8_chunk(const uint8_t* src, size_t n, endian_t e, int final,
+                               uint8_t* dst, size_t cap, size_t* consumed, size_t* produced) {
+    const uint64_t ascii_mask = 0xFFFFFF80FFFFFF80ULL;
+    const size_t low = e == ENDIAN_BIG ? 3 : 0;
+    size_t i = 0, o = 0;
+    (void)final;
+
+    while (i < n) {
+        // ASCII fast path: 16 code units per iteration
+        if (n - i >= 16 && cap - o >= 16) {
+            const uint8_t* p = src + 4 * i;
+            uint64_t any = 0;
+            for (size_t k = 0; k < 8; k++)
+                any |= load_word64(p + 8 * k, e);
+            if ((any & ascii_mask) == 0) {
+                for (size_t k = 0; k < 16; k++)
+                    dst[o + k] = p[4 * k + low];
+                i += 16;
+                o += 16;
+                continue;
+            }
+        }
+
+        const uint32_t cp = load_unit32(src + 4 * i, e);
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return -1;
+
+        const size_t len = utf8_encode(cp, dst + o, cap - o);
+        if (len == 0)
+            return -1;
+        o += len;
+        i++;
+    }
+
+    *consumed = i;
+    *produced = o;
+    return 0;
+}
+
+// Writer kernels: cap is in code units and running out of room is not an
+// error; the caller flushes and continues from *consumed.
+static int utf8_to_utf16_chunk(const uint8_t* src, size_t n, endian_t e, int final,
+                               uint8_t* dst, size_t cap, size_t* consumed, size_t* produced) {
+    const size_t low = e == ENDIAN_BIG ? 1 : 0;
+    size_t i = 0, o = 0;
+    (void)final;
+
+    while (i < n) {
+        // ASCII fast path: 16 bytes per iteration
+        if (n - i >= 16 && cap - o >= 16) {
+            if (((load_le64(src + i) | load_le64(src + i + 8)) & 0x8080808080808080ULL) == 0) {
+                uint8_t* p = dst + 2 * o;
+                for (size_t k = 0; k < 16; k++) {
+                    p[2 * k + low] = src[i + k];
+                    p[2 * k + (1 - low)] = 0;
+                }
+                i += 16;
+                o += 16;
+                continue;
+            }
+        }
+
+        if (cap - o < 2)
+            break;
+        uint32_t cp;
+        const size_t len = utf8_decode(src + i, n - i, &cp);
+        if (len == 0)
+            return -1;
+
+        uint8_t* p = dst + 2 * o;
+        if (cp < 0x10000) {
+            if (e == ENDIAN_BIG) store_be16(p, (uint16_t)cp);
+            else                 store_le16(p, (uint16_t)cp);
+            o += 1;
+        } else {
+            const uint16_t hi = (uint16_t)(0xD800 + ((cp - 0x10000) >> 10));
+            const uint16_t lo = (uint16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+            if (e == ENDIAN_BIG) { store_be16(p, hi); store_be16(p + 2, lo); }
+            else                 { store_le16(p, hi); store_le16(p + 2, lo); }
+            o += 2;
+        }
+        i += len;
+    }
+
+    *consumed = i;
+    *produced = o;
+    return 0;
+}
+
+static int utf8_to_utf32_chunk(const uint8_t* src, size_t n, endian_t e, int final,
+                               uint8_t* dst, size_t cap, size_t* consumed, size_t* produced) {
+    size_t i = 0, o = 0;
+    (void)final;
+
+    while (i < n && o < cap) {
+        uint32_t cp;
+        const size_t len = utf8_decode(src + i, n - i, &cp);
+        if (len == 0)
+            return -1;
+        if (e == ENDIAN_BIG) store_be32(dst + 4 * o, cp);
+        else                 store_le32(dst + 4 * o, cp);
+        o++;
+        i += len;
+    }
+
+    *consumed = i;
+    *produced = o;
+    return 0;
+}
+
+static int read_utf_endian(FILE* file, size_t units, uint8_t* dst, size_t dst_size,
+                           size_t* length, size_t unit_size, endian_t source_endian,
+                           utf_chunk_fn kernel) {
+    if (!file || (!dst && dst_size > 0) || !length)
+        return -1;
+
+    uint8_t buffer[UTF_BUFFER_SIZE];
+    const size_t buffer_units = sizeof(buffer) / unit_size;
+    size_t held = 0, out = 0;
+
+    while (units > 0) {
+        const size_t batch = units < buffer_units - held ? units : buffer_units - held;
+        if (fread(buffer + held * unit_size, unit_size, batch, file) != batch)
+            return -1;
+        units -= batch;
+
+        size_t consumed, produced;
+        if (kernel(buffer, held + batch, source_endian, units == 0,
+                   dst + out, dst_size - out, &consumed, &produced) != 0)
+            return -1;
+        out += produced;
+
+        // Carry a split surrogate pair over to the next chunk
+        held = held + batch - consumed;
+        memmove(buffer, buffer + consumed * unit_size, held * unit_size);
+    }
+
+    *length = out;
+    return 0;
+}
+
+static int write_utf_endian(FILE* file, const char* str, size_t len, size_t* units,
+                            size_t unit_size, endian_t target_endian, utf_chunk_fn kernel) {
+    if (!file || (!str && len > 0))
+        return -1;
+
+    uint8_t buffer[UTF_BUFFER_SIZE];
+    const uint8_t* src = (const uint8_t*)str;
+    size_t total = 0;
+
+    while (len > 0) {
+        size_t consumed, produced;
+        if (kernel(src, len, target_endian, 1, buffer, sizeof(buffer) / unit_size,
+                   &consumed, &produced) != 0)
+            return -1;
+        if (fwrite(buffer, unit_size, produced, file) != produced)
+            return -1;
+        src += consumed;
+        len -= consumed;
+        total += produced;
+    }
+
+    if (units)
+        *units = total;
+    return 0;
+}
+
+int read_utf16_be(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length) {
+    return read_utf_endian(file, units, (uint8_t*)dst, dst_size, length,
+                           2, ENDIAN_BIG, utf16_to_utf8_chunk);
+}
+
+int read_utf16_le(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length) {
+    return read_utf_endian(file, units, (uint8_t*)dst, dst_size, length,
+                           2, ENDIAN_LITTLE, utf16_to_utf8_chunk);
+}
+
+int read_utf32_be(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length) {
+    return read_utf_endian(file, units, (uint8_t*)dst, dst_size, length,
+                           4, ENDIAN_BIG, utf32_to_utf8_chunk);
+}
+
+int read_utf32_le(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length) {
+    return read_utf_endian(file, units, (uint8_t*)dst, dst_size, length,
+                           4, ENDIAN_LITTLE, utf32_to_utf8_chunk);
+}
+
+int write_utf16_be(FILE* file, const char* str, size_t len, size_t* units) {
+    return write_utf_endian(file, str, len, units, 2, ENDIAN_BIG, utf8_to_utf16_chunk);
+}
+
+int write_utf16_le(FILE* file, const char* str, size_t len, size_t* units) {
+    return write_utf_endian(file, str, len, units, 2, ENDIAN_LITTLE, utf8_to_utf16_chunk);
+}
+
+int write_utf32_be(FILE* file, const char* str, size_t len, size_t* units) {
+    return write_utf_endian(file, str, len, units, 4, ENDIAN_BIG, utf8_to_utf32_chunk);
+}
+
+int write_utf32_le(FILE* file, const char* str, size_t len, size_t* units) {
+    return write_utf_endian(file, str, len, units, 4, ENDIAN_LITTLE, utf8_to_utf32_chunk);
+}
+
+// -----------------------------------------------------------------------------
+// Length-Prefixed Strings
+// -----------------------------------------------------------------------------
+#define STRING_STAGE_SIZE 65536
+
+static int write_strings_endian(FILE* file, const char* const* strs, const size_t* lengths,
+                                size_t n, endian_t target_endian) {
+    if (!file || !strs)
+        return -1;
+    if (n == 0)
+        return 0;
+
+    uint8_t* stage = (uint8_t*)malloc(STRING_STAGE_SIZE);
+    if (!stage)
+        return -1;
+
+    size_t fill = 0;
+    int status = 0;
+
+    for (size_t i = 0; i < n && status == 0; i++) {
+        // NULL entries are empty strings; check before strlen()
+        const size_t len = lengths ? lengths[i] : strs[i] ? strlen(strs[i]) : 0;
+        if (len > UINT32_MAX || (!strs[i] && len > 0)) {
+            status = -1;
+            break;
+        }
+
+        if (STRING_STAGE_SIZE - fill < 4 + len) {
+            if (fwrite(stage, 1, fill, file) != fill) {
+                status = -1;
+                break;
+            }
+            fill = 0;
+        }
+
+        if (target_endian == ENDIAN_BIG)
+            store_be32(stage + fill, (uint32_t)len);
+        else
+            store_le32(stage + fill, (uint32_t)len);
+        fill += 4;
+
+        // Strings larger than the stage bypass it
+        if (len > STRING_STAGE_SIZE - fill) {
+            if (fwrite(stage, 1, fill, file) != fill ||
+                fwrite(strs[i], 1, len, file) != len)
+                status = -1;
+            fill = 0;
+        } else if (len > 0) {
+            memcpy(stage + fill, strs[i], len);
+            fill += len;
+        }
+    }
+
+    if (status == 0 && fwrite(stage, 1, fill, file) != fill)
+        status = -1;
+
+    free(stage);
+    return status;
+}
+
+// Moves the unread stage bytes to the front and reads more behind them
+static void stage_refill(FILE* file, uint8_t* stage, size_t* pos, size_t* avail) {
+    const size_t left = *avail - *pos;
+    memmove(stage, stage + *pos, left);
+    *pos = 0;
+    *avail = left + fread(stage + left, 1, STRING_STAGE_SIZE - left, file);
+}
+
+static int read_strings_endian(FILE* file, size_t n, size_t* offsets,
+                               char** blob, size_t* blob_size, endian_t source_endian) {
+    if (!file || !offsets || !blob)
+        return -1;
+
+    size_t capacity = 0, total = 0;
+    char* data = NULL;
+    uint8_t* stage = (uint8_t*)malloc(STRING_STAGE_SIZE);
+    size_t pos = 0, avail = 0;
+    if (!stage)
+        return -1;
+
+    // Prefixes and short payloads are parsed out of a bulk-read stage, which
+    // is refilled only when a prefix crosses its end
+    offsets[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (avail - pos < 4) {
+            stage_refill(file, stage, &pos, &avail);
+            if (avail - pos < 4)
+                goto fail;
+        }
+        const size_t len = source_endian == ENDIAN_BIG ? load_be32(stage + pos)
+                                                       : load_le32(stage + pos);
+        pos += 4;
+
+        if (capacity - total < len) {
+            size_t grown = capacity ? capacity * 2 : 256;
+            while (grown - total < len)
+                grown *= 2;
+            char* resized = (char*)realloc(data, grown);
+            if (!resized)
+                goto fail;
+            data = resized;
+            capacity = grown;
+        }
+
+        // Copy the staged part; a payload crossing the stage end is read
+        // straight into the blob
+        const size_t staged = avail - pos < len ? avail - pos : len;
+        if (staged > 0)
+            memcpy(data + total, stage + pos, staged);
+        pos += staged;
+        if (staged < len && fread(data + total + staged, 1, len - staged, file) != len - staged)
+            goto fail;
+        total += len;
+        offsets[i + 1] = total;
+    }
+
+    // Give back the read-ahead so the file is positioned after the table
+    if (avail > pos && fseek(file, -(long)(avail - pos), SEEK_CUR) != 0)
+        goto fail;
+
+    free(stage);
+    *blob = data;
+    if (blob_size)
+        *blob_size = total;
+    return 0;
+
+fail:
+    free(stage);
+    free(data);
+    return -1;
+}
+
+static int view_strings_endian(const uint8_t* data, size_t size, size_t n,
+                               string_view_t* views, size_t* consumed,
+                               endian_t source_endian) {
+    if ((!data && size > 0) || (!views && n > 0))
+        return -1;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (size - pos < 4)
+            return -1;
+        const uint32_t len = source_endian == ENDIAN_BIG ? load_be32(data + pos)
+                                                         : load_le32(data + pos);
+        pos += 4;
+        if (size - pos < len)
+            return -1;
+        views[i].data = (const char*)data + pos;
+        views[i].length = len;
+        pos += len;
+    }
+
+    if (consumed)
+        *consumed = pos;
+    return 0;
+}
+
+int write_strings_be(FILE* file, const char* const* strs, const size_t* lengths, size_t n) {
+    return write_strings_endian(file, strs, lengths, n, ENDIAN_BIG);
+}
+
+int read_strings_be(FILE* file, size_t n, size_t* offsets, char** blob, size_t* blob_size) {
+    return read_strings_endian(file, n, offsets, blob, blob_size, ENDIAN_BIG);
+}
+
+int view_strings_be(const uint8_t* data, size_t size, size_t n,
+                    string_view_t* views, size_t* consumed) {
+    return view_strings_endian(data, size, n, views, consumed, ENDIAN_BIG);
+}
+
+int write_strings_le(FILE* file, const char* const* strs, const size_t* lengths, size_t n) {
+    return write_strings_endian(file, strs, lengths, n, ENDIAN_LITTLE);
+}
+
+int read_strings_le(FILE* file, size_t n, size_t* offsets, char** blob, size_t* blob_size) {
+    return read_strings_endian(file, n, offsets, blob, blob_size, ENDIAN_LITTLE);
+}
+
+int view_strings_le(const uint8_t* data, size_t size, size_t n,
+                    string_view_t* views, size_t* consumed) {
+    return view_strings_endian(data, size, n, views, consumed, ENDIAN_LITTLE);
+}
+
+
+// -----------------------------------------------------------------------------
+// Byte Permutation Orders
+// -----------------------------------------------------------------------------
+#define ORDER_IDENTITY 0
+#define ORDER_REVERSE 1
+#define ORDER_GENERAL 2
+#define ORDERED_BUFFER_SIZE 4096
+
+int endian_order_from_positions(endian_order_t* order, const uint8_t* positions, size_t size) {
+    if (!order || !positions || size == 0 || size > ENDIAN_ORDER_MAX_SIZE)
+        return -1;
+
+    // Map each stored byte to the host byte holding the same significance
+    uint8_t seen[ENDIAN_ORDER_MAX_SIZE] = {0};
+    const int host_little = is_little_endian();
+    for (size_t i = 0; i < size; i++) {
+        const size_t p = positions[i];
+        if (p >= size || seen[p])
+            return -1;
+        seen[p] = 1;
+        const uint8_t h = (uint8_t)(host_little ? size - 1 - p : p);
+        order->encode[i] = h;
+        order->decode[h] = (uint8_t)i;
+    }
+
+    int identity = 1, reverse = 1;
+    for (size_t j = 0; j < size; j++) {
+        identity &= order->decode[j] == j;
+        reverse &= order->decode[j] == size - 1 - j;
+    }
+    order->kind = identity ? ORDER_IDENTITY : reverse ? ORDER_REVERSE : ORDER_GENERAL;
+    order->size = size;
+
+    // Shuffle masks over 16-byte blocks, for sizes that tile a block
+    for (size_t k = 0; k < 16; k++) {
+        const size_t base = k - k % size;
+        const int tiles = 16 % size == 0;
+        order->decode_mask[k] = (uint8_t)(tiles ? base + order->decode[k % size] : k);
+        order->encode_mask[k] = (uint8_t)(tiles ? base + order->encode[k % size] : k);
+    }
+    return 0;
+}
+
+int endian_order_init(endian_order_t* order, const char* spec) {
+    if (!order || !spec)
+        return -1;
+
+    uint8_t positions[ENDIAN_ORDER_MAX_SIZE];
+    size_t size = 0;
+
+    // Comma-separated decimal positions, needed past 9 bytes
+    if (strchr(spec, ',')) {
+        for (const char* c = spec; ; c++) {
+            unsigned value = 0;
+            const char* digits = c;
+            while (*c >= '0' && *c <= '9' && value <= ENDIAN_ORDER_MAX_SIZE)
+                value = value * 10 + (unsigned)(*c++ - '0');
+            if (c == digits || value < 1 || value > ENDIAN_ORDER_MAX_SIZE ||
+                size == ENDIAN_ORDER_MAX_SIZE)
+                return -1;
+            positions[size++] = (uint8_t)(value - 1);
+            if (*c == '\0')
+                break;
+            if (*c != ',')
+                return -1;
+        }
+        return endian_order_from_positions(order, positions, size);
+    }
+
+    for (const char* c = spec; *c; c++) {
+        if (*c == '-')
+            continue;
+        if (*c < '1' || *c > '9' || size == ENDIAN_ORDER_MAX_SIZE)
+            return -1;
+        positions[size++] = (uint8_t)(*c - '1');
+    }
+    return endian_order_from_positions(order, positions, size);
+}
+
+// Applies out[j] = in[map[j]] to every element. Plain swaps reuse the swap
+// kernels; other orders use the compiled 16-byte mask where available.
+static void permute_array(uint8_t* data, size_t num, const endian_order_t* order,
+                          const uint8_t* map, const uint8_t* mask) {
+    const size_t size = order->size;
+    if (order->kind == ORDER_IDENTITY)
+        return;
+    if (order->kind == ORDER_REVERSE) {
+        swap_array(data, num, size);
+        return;
+    }
+
+    size_t start = 0;
+#ifdef ENDIAN_IO_RUNTIME_SHUFFLE
+    if (16 % size == 0)
+        start = vector_permute(data, num * size, mask) / size;
+#else
+    (void)mask;
+#endif
+
+    uint8_t tmp[ENDIAN_ORDER_MAX_SIZE];
+    for (size_t e = start; e < num; e++) {
+        uint8_t* p = data + e * size;
+        for (size_t j = 0; j < size; j++)
+            tmp[j] = p[map[j]];
+        memcpy(p, tmp, size);
+    }
+}
+
+int convert_from_ordered(uint8_t* data, size_t num, const endian_order_t* order) {
+    if (!data || !order)
+        return -1;
+    permute_array(data, num, order, order->decode, order->decode_mask);
+    return 0;
+}
+
+int convert_to_ordered(uint8_t* data, size_t num, const endian_order_t* order) {
+    if (!data || !order)
+        return -1;
+    permute_array(data, num, order, order->encode, order->encode_mask);
+    return 0;
+}
+
+int read_ordered(FILE* file, uint8_t* data, size_t num, const endian_order_t* order) {
+    if (!file || !data || !order)
+        return -1;
+
+    // Block read, then permute in place
+    if (fread(data, order->size, num, file) != num)
+        return -1;
+    permute_array(data, num, order, order->decode, order->decode_mask);
+    return 0;
+}
+
+int write_ordered(FILE* file, const uint8_t* data, size_t num, const endian_order_t* order) {
+    if (!file || !data || !order)
+        return -1;
+
+    const size_t size = order->size;
+    if (order->kind == ORDER_IDENTITY)
+        return fwrite(data, size, num, file) == num ? 0 : -1;
+
+    uint8_t buffer[ORDERED_BUFFER_SIZE];
+    const size_t block_elems = sizeof(buffer) / size;
+    for (size_t offset = 0; offset < num; ) {
+        const size_t batch = num - offset < block_elems ? num - offset : block_elems;
+        memcpy(buffer, data + offset * size, batch * size);
+        permute_array(buffer, batch, order, order->encode, order->encode_mask);
+        if (fwrite(buffer, size, batch, file) != batch)
+            return -1;
+        offset += batch;
+    }
+    return 0;
+}
+
+#define DEFINE_ORDERED_IO_FUNCS(NUMBERTYPE) \
+int write_##NUMBERTYPE##_ordered(FILE* file, const NUMBERTYPE* arr, size_t n, \
+                                 const endian_order_t* order) { \
+    if (!order || order->size != sizeof(NUMBERTYPE)) \
+        return -1; \
+    return write_ordered(file, (const uint8_t*)arr, n, order); \
+} \
+int read_##NUMBERTYPE##_ordered(FILE* file, NUMBERTYPE* arr, size_t n, \
+                                const endian_order_t* order) { \
+    if (!order || order->size != sizeof(NUMBERTYPE)) \
+        return -1; \
+    return read_ordered(file, (uint8_t*)arr, n, order); \
+}
+
+DEFINE_ORDERED_IO_FUNCS(uint16_t)
+DEFINE_ORDERED_IO_FUNCS(uint32_t)
+DEFINE_ORDERED_IO_FUNCS(uint64_t)
+DEFINE_ORDERED_IO_FUNCS(int16_t)
+DEFINE_ORDERED_IO_FUNCS(int32_t)
+DEFINE_ORDERED_IO_FUNCS(int64_t)
+DEFINE_ORDERED_IO_FUNCS(float)
+DEFINE_ORDERED_IO_FUNCS(double)
+
+
+// -----------------------------------------------------------------------------
+// Fixed-Point Conversion
+// -----------------------------------------------------------------------------
+#define FIXED_BUFFER_SIZE 4096
+
+static inline int fixed_args_valid(unsigned bits, unsigned frac_bits) {
+    return (bits == 16 || bits == 32) && frac_bits <= bits;
+}
+
+// Rounds half away from zero and clamps to [-max - 1, max]; NaN becomes 0
+static inline int32_t fixed_quantize(double x, double max) {
+    if (x != x)
+        return 0;
+    x += x >= 0 ? 0.5 : -0.5;
+    if (x >= max)      return (int32_t)max;
+    if (x <= -max - 1) return (int32_t)(-max - 1);
+    return (int32_t)x;
+}
+
+// One loop per stored layout so the compiler can vectorize the load, swap
+// and multiply together.
+#define FIXED_DECODE_LOOP(LOAD, STRIDE)                             \
+    for (size_t i = 0; i < n; i++)                                  \
+        out[i] = (double)LOAD(raw + i * (STRIDE)) * scale;          \
+    break;
+
+// The layouts are selected by bits * 2 + big_endian: 32/33 for 16-bit LE/BE
+// and 64/65 for 32-bit LE/BE.
+#define FIXED_ENCODE_LOOP(STORE, UTYPE, STRIDE)                     \
+    for (size_t i = 0; i < n; i++)                                  \
+        STORE(raw + i * (STRIDE),                                   \
+              (UTYPE)fixed_quantize((double)in[i] * scale, max));   \
+    break;
+
+#define DEFINE_FIXED_IO(TYPE, SUFFIX)                                               \
+int decode_fixed_##SUFFIX(const uint8_t* raw, TYPE* out, size_t n,                  \
+                          unsigned bits, unsigned frac_bits, int big_endian) {      \
+    if (!raw || !out || !fixed_args_valid(bits, frac_bits))                         \
+        return -1;                                                                  \
+    const double scale = 1.0 / (double)((uint64_t)1 << frac_bits);                  \
+    switch (bits * 2 + (big_endian != 0)) {                                         \
+        case 33: FIXED_DECODE_LOOP((int16_t)load_be16, 2)                           \
+        case 32: FIXED_DECODE_LOOP((int16_t)load_le16, 2)                           \
+        case 65: FIXED_DECODE_LOOP((int32_t)load_be32, 4)                           \
+        default: FIXED_DECODE_LOOP((int32_t)load_le32, 4)                           \
+    }                                                                               \
+    return 0;                                                                       \
+}                                                                                   \
+                                                                                    \
+int encode_fixed_##SUFFIX(const TYPE* in, uint8_t* raw, size_t n,                   \
+                          unsigned bits, unsigned frac_bits, int big_endian) {      \
+    if (!in || !raw || !fixed_args_valid(bits, frac_bits))                          \
+        return -1;                                                                  \
+    const double scale = (double)((uint64_t)1 << frac_bits);                        \
+    const double max = (double)(((uint64_t)1 << (bits - 1)) - 1);                   \
+    switch (bits * 2 + (big_endian != 0)) {                                         \
+        case 33: FIXED_ENCODE_LOOP(store_be16, uint16_t, 2)                         \
+        case 32: FIXED_ENCODE_LOOP(store_le16, uint16_t, 2)                         \
+        case 65: FIXED_ENCODE_LOOP(store_be32, uint32_t, 4)                         \
+        default: FIXED_ENCODE_LOOP(store_le32, uint32_t, 4)                         \
+    }                                                                               \
+    return 0;                                                                       \
+}                                                                                   \
+                                                                                    \
+int read_fixed_##SUFFIX(FILE* file, TYPE* out, size_t n,                            \
+                        unsigned bits, unsigned frac_bits, int big_endian) {        \
+    if (!file || !out || !fixed_args_valid(bits, frac_bits))                        \
+        return -1;                                                                  \
+    uint8_t buffer[FIXED_BUFFER_SIZE];                                              \
+    const size_t size = bits / 8;                                                   \
+    const size_t block = sizeof(buffer) / size;                                     \
+    for (size_t done = 0; done < n; ) {                                             \
+        const size_t batch = n - done < block ? n - done : block;                   \
+        if (fread(buffer, size, batch, file) != batch)                              \
+            return -1;                                                              \
+        decode_fixed_##SUFFIX(buffer, out + done, batch, bits, frac_bits, big_endian); \
+        done += batch;                                                              \
+    }                                                                               \
+    return 0;                                                                       \
+}                                                                                   \
+                                                                                    \
+int write_fixed_##SUFFIX(FILE* file, const TYPE* in, size_t n,                      \
+                         unsigned bits, unsigned frac_bits, int big_endian) {       \
+    if (!file || !in || !fixed_args_valid(bits, frac_bits))                         \
+        return -1;                                                                  \
+    uint8_t buffer[FIXED_BUFFER_SIZE];                                              \
+    const size_t size = bits / 8;                                                   \
+    const size_t block = sizeof(buffer) / size;                                     \
+    for (size_t done = 0; done < n; ) {                                             \
+        const size_t batch = n - done < block ? n - done : block;                   \
+        encode_fixed_##SUFFIX(in + done, buffer, batch, bits, frac_bits, big_endian); \
+        if (fwrite(buffer, size, batch, file) != batch)                             \
+            return -1;                                                              \
+        done += batch;                                                              \
+    }                                                                               \
+    return 0;                                                                       \
+}
+
+DEFINE_FIXED_IO(float, f32)
+DEFINE_FIXED_IO(double, f64)
+
+#define DEFINE_Q_FORMAT_FUNCS(Q, BITS, TYPE, SUFFIX)                                \
+int read_##Q##be_to_##SUFFIX(FILE* file, TYPE* out, size_t n) {                     \
+    return read_fixed_##SUFFIX(file, out, n, BITS, BITS - 1, 1);                    \
+}                                                                                   \
+int read_##Q##le_to_##SUFFIX(FILE* file, TYPE* out, size_t n) {                     \
+    return read_fixed_##SUFFIX(file, out, n, BITS, BITS - 1, 0);                    \
+}                                                                                   \
+int write_##SUFFIX##_to_##Q##be(FILE* file, const TYPE* in, size_t n) {             \
+    return write_fixed_##SUFFIX(file, in, n, BITS, BITS - 1, 1);                    \
+}                                                                                   \
+int write_##SUFFIX##_to_##Q##le(FILE* file, const TYPE* in, size_t n) {             \
+    return write_fixed_##SUFFIX(file, in, n, BITS, BITS - 1, 0);                    \
+}
+
+DEFINE_Q_FORMAT_FUNCS(q15, 16, float, f32)
+DEFINE_Q_FORMAT_FUNCS(q31, 32, float, f32)
+DEFINE_Q_FORMAT_FUNCS(q15, 16, double, f64)
+DEFINE_Q_FORMAT_FUNCS(q31, 32, double, f64)
+
+
+// -----------------------------------------------------------------------------
+// Block-Quantized Tensors
+// -----------------------------------------------------------------------------
+#define QUANT8_BUFFER_SIZE 16384
+
+size_t quant8_block_bytes(const quant8_format_t* fmt) {
+    if (!fmt || fmt->block_size == 0 || fmt->block_size > QUANT8_BUFFER_SIZE - 8)
+        return 0;
+    return (fmt->is_signed ? 4 : 8) + fmt->block_size;
+}
+
+static inline float load_param(const uint8_t* p, int big_endian) {
+    const uint32_t bits = big_endian ? load_be32(p) : load_le32(p);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline void store_param(uint8_t* p, float f, int big_endian) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    if (big_endian)
+        store_be32(p, bits);
+    else
+        store_le32(p, bits);
+}
+
+int decode_quant8_f32(const quant8_format_t* fmt, const uint8_t* raw, size_t nblocks,
+                      float* out) {
+    const size_t block_bytes = quant8_block_bytes(fmt);
+    if (!block_bytes || !raw || !out)
+        return -1;
+
+    const size_t bs = fmt->block_size;
+    for (size_t b = 0; b < nblocks; b++, raw += block_bytes, out += bs) {
+        const float d = load_param(raw, fmt->big_endian);
+        if (fmt->is_signed) {
+            const int8_t* q = (const int8_t*)(raw + 4);
+            for (size_t j = 0; j < bs; j++)
+                out[j] = d * (float)q[j];
+        } else {
+            const float m = load_param(raw + 4, fmt->big_endian);
+            const uint8_t* q = raw + 8;
+            for (size_t j = 0; j < bs; j++)
+                out[j] = d * (float)q[j] + m;
+        }
+    }
+    return 0;
+}
+
+int encode_quant8_f32(const quant8_format_t* fmt, const float* in, size_t nblocks,
+                      uint8_t* raw) {
+    const size_t block_bytes = quant8_block_bytes(fmt);
+    if (!block_bytes || !in || !raw)
+        return -1;
+
+    const size_t bs = fmt->block_size;
+    for (size_t b = 0; b < nblocks; b++, raw += block_bytes, in += bs) {
+        if (fmt->is_signed) {
+            float amax = 0.0f;
+            for (size_t j = 0; j < bs; j++) {
+                const float a = in[j] < 0 ? -in[j] : in[j];
+                amax = a > amax ? a : amax;
+            }
+            const float d = amax / 127.0f;
+            const float inv = d > 0 ? 1.0f / d : 0.0f;
+            store_param(raw, d, fmt->big_endian);
+            for (size_t j = 0; j < bs; j++) {
+                float x = in[j] * inv;
+                x += x >= 0 ? 0.5f : -0.5f;
+                x = x > 127.0f ? 127.0f : x < -127.0f ? -127.0f : x;
+                x = x != x ? 0.0f : x;
+                raw[4 + j] = (uint8_t)(int8_t)x;
+            }
+        } else {
+            float lo = in[0], hi = in[0];
+            for (size_t j = 1; j < bs; j++) {
+                lo = in[j] < lo ? in[j] : lo;
+                hi = in[j] > hi ? in[j] : hi;
+            }
+            const float d = (hi - lo) / 255.0f;
+            const float inv = d > 0 ? 1.0f / d : 0.0f;
+            store_param(raw, d, fmt->big_endian);
+            store_param(raw + 4, lo, fmt->big_endian);
+            for (size_t j = 0; j < bs; j++) {
+                float x = (in[j] - lo) * inv + 0.5f;
+                x = x > 255.0f ? 255.0f : x < 0.0f ? 0.0f : x;
+                x = x != x ? 0.0f : x;
+                raw[8 + j] = (uint8_t)x;
+            }
+        }
+    }
+    return 0;
+}
+
+int read_quant8_f32(FILE* file, const quant8_format_t* fmt, float* out, size_t nblocks) {
+    const size_t block_bytes = quant8_block_bytes(fmt);
+    if (!file || !block_bytes || !out)
+        return -1;
+
+    uint8_t buffer[QUANT8_BUFFER_SIZE];
+    const size_t per_chunk = sizeof(buffer) / block_bytes;
+    for (size_t done = 0; done < nblocks; ) {
+        const size_t batch = nblocks - done < per_chunk ? nblocks - done : per_chunk;
+        if (fread(buffer, block_bytes, batch, file) != batch)
+            return -1;
+        decode_quant8_f32(fmt, buffer, batch, out + done * fmt->block_size);
+        done += batch;
+    }
+    return 0;
+}
+
+int write_quant8_f32(FILE* file, const quant8_format_t* fmt, const float* in, size_t nblocks) {
+    const size_t block_bytes = quant8_block_bytes(fmt);
+    if (!file || !block_bytes || !in)
+        return -1;
+
+    uint8_t buffer[QUANT8_BUFFER_SIZE];
+    const size_t per_chunk = sizeof(buffer) / block_bytes;
+    for (size_t done = 0; done < nblocks; ) {
+        const size_t batch = nblocks - done < per_chunk ? nblocks - done : per_chunk;
+        encode_quant8_f32(fmt, in + done * fmt->block_size, batch, buffer);
+        if (fwrite(buffer, block_bytes, batch, file) != batch)
+            return -1;
+        done += batch;
+    }
+    return 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// Big-Integer Limbs
+// -----------------------------------------------------------------------------
+static void reverse_copy(uint8_t* dst, const uint8_t* src, size_t n) {
+    size_t i = 0;
+#ifdef ENDIAN_IO_VECTOR
+    i = vector_reverse_copy(dst, src, n);
+#endif
+    for (; i < n; i++)
+        dst[i] = src[n - 1 - i];
+}
+
+// Number of bytes needed to hold value (0 for zero)
+static inline size_t limb_bytes(uint64_t value) {
+    size_t n = 0;
+    for (; value; value >>= 8)
+        n++;
+    return n;
+}
+
+// Drops zero high limbs and returns the magnitude size in bytes
+static size_t bigint_size(const uint64_t* limbs, size_t* nlimbs) {
+    while (*nlimbs > 0 && limbs[*nlimbs - 1] == 0)
+        (*nlimbs)--;
+    return *nlimbs ? (*nlimbs - 1) * 8 + limb_bytes(limbs[*nlimbs - 1]) : 0;
+}
+
+static inline int bigint_fits(size_t nbytes, size_t nlimbs) {
+    return nlimbs >= SIZE_MAX / 8 || nbytes <= nlimbs * 8;
+}
+
+int endian_bigint_import_be(uint64_t* limbs, size_t nlimbs, const uint8_t* bytes, size_t nbytes) {
+    if (!limbs || (!bytes && nbytes))
+        return -1;
+    while (nbytes > 0 && bytes[0] == 0) {
+        bytes++;
+        nbytes--;
+    }
+    if (!bigint_fits(nbytes, nlimbs))
+        return -1;
+
+    // Full limbs come from the tail of the string, the partial one from the head
+    const size_t full = nbytes / 8, head = nbytes % 8;
+    if (is_little_endian()) {
+        reverse_copy((uint8_t*)limbs, bytes + head, full * 8);
+    } else {
+        for (size_t i = 0; i < full; i++)
+            limbs[i] = load_be64(bytes + nbytes - 8 * (i + 1));
+    }
+    size_t used = full;
+    if (head) {
+        uint64_t v = 0;
+        for (size_t k = 0; k < head; k++)
+            v = (v << 8) | bytes[k];
+        limbs[used++] = v;
+    }
+    for (size_t i = used; i < nlimbs; i++)
+        limbs[i] = 0;
+    return 0;
+}
+
+int endian_bigint_export_be(uint8_t* bytes, size_t nbytes, const uint64_t* limbs, size_t nlimbs) {
+    if ((!bytes && nbytes) || (!limbs && nlimbs))
+        return -1;
+    const size_t sig = bigint_size(limbs, &nlimbs);
+    if (sig > nbytes)
+        return -1;
+    memset(bytes, 0, nbytes - sig);
+    if (!sig)
+        return 0;
+
+    // Partial top limb first, then the full limbs from most significant down
+    uint8_t* p = bytes + nbytes - sig;
+    const size_t full = nlimbs - 1;
+    const size_t head = sig - full * 8;
+    const uint64_t top = limbs[full];
+    for (size_t k = 0; k < head; k++)
+        p[k] = (uint8_t)(top >> (8 * (head - 1 - k)));
+    p += head;
+    if (is_little_endian()) {
+        reverse_copy(p, (const uint8_t*)limbs, full * 8);
+    } else {
+        for (size_t i = 0; i < full; i++)
+            store_be64(p + 8 * (full - 1 - i), limbs[i]);
+    }
+    return 0;
+}
+
+int endian_bigint_import_le(uint64_t* limbs, size_t nlimbs, const uint8_t* bytes, size_t nbytes) {
+    if (!limbs || (!bytes && nbytes))
+        return -1;
+    while (nbytes > 0 && bytes[nbytes - 1] == 0)
+        nbytes--;
+    if (!bigint_fits(nbytes, nlimbs))
+        return -1;
+
+    const size_t full = nbytes / 8, tail = nbytes % 8;
+    if (is_little_endian()) {
+        memcpy(limbs, bytes, full * 8);
+    } else {
+        for (size_t i = 0; i < full; i++)
+            limbs[i] = load_le64(bytes + 8 * i);
+    }
+    size_t used = full;
+    if (tail) {
+        uint64_t v = 0;
+        for (size_t k = tail; k-- > 0; )
+            v = (v << 8) | bytes[full * 8 + k];
+        limbs[used++] = v;
+    }
+    for (size_t i = used; i < nlimbs; i++)
+        limbs[i] = 0;
+    return 0;
+}
+
+int endian_bigint_export_le(uint8_t* bytes, size_t nbytes, const uint64_t* limbs, size_t nlimbs) {
+    if ((!bytes && nbytes) || (!limbs && nlimbs))
+        return -1;
+    const size_t sig = bigint_size(limbs, &nlimbs);
+    if (sig > nbytes)
+        return -1;
+    memset(bytes + sig, 0, nbytes - sig);
+    if (!sig)
+        return 0;
+
+    const size_t full = nlimbs - 1;
+    if (is_little_endian()) {
+        memcpy(bytes, limbs, full * 8);
+    } else {
+        for (size_t i = 0; i < full; i++)
+            store_le64(bytes + 8 * i, limbs[i]);
+    }
+    const uint64_t top = limbs[full];
+    for (size_t k = 0; k < sig - full * 8; k++)
+        bytes[full * 8 + k] = (uint8_t)(top >> (8 * k));
+    return 0;
+}
+
+
+// -----------------------------------------------------------------------------
+// Atomic Fixed-Order Integers
+// -----------------------------------------------------------------------------
+#if defined(__GNUC__) || defined(__clang__)
+
+#define ENDIAN_ENUM_be ENDIAN_BIG
+#define ENDIAN_ENUM_le ENDIAN_LITTLE
+
+#define DEFINE_ATOMIC_FUNCS(BITS, ENDIAN)                                           \
+static inline uint##BITS##_t atomic_order_##ENDIAN##BITS(uint##BITS##_t v) {        \
+    return needs_swap(ENDIAN_ENUM_##ENDIAN) ? bswap##BITS(v) : v;                   \
+}                                                                                   \
+                                                                                    \
+uint##BITS##_t endian_atomic_load_##ENDIAN##BITS(const uint##BITS##_t* p) {         \
+    return atomic_order_##ENDIAN##BITS(__atomic_load_n(p, __ATOMIC_ACQUIRE));       \
+}                                                                                   \
+                                                                                    \
+void endian_atomic_store_##ENDIAN##BITS(uint##BITS##_t* p, uint##BITS##_t value) {  \
+    __atomic_store_n(p, atomic_order_##ENDIAN##BITS(value), __ATOMIC_RELEASE);      \
+}                                                                                   \
+                                                                                    \
+uint##BITS##_t endian_atomic_exchange_##ENDIAN##BITS(uint##BITS##_t* p,             \
+                                                     uint##BITS##_t value) {        \
+    return atomic_order_##ENDIAN##BITS(                                             \
+        __atomic_exchange_n(p, atomic_order_##ENDIAN##BITS(value), __ATOMIC_SEQ_CST)); \
+}                                                                                   \
+                                                                                    \
+uint##BITS##_t endian_atomic_fetch_add_##ENDIAN##BITS(uint##BITS##_t* p,            \
+                                                      uint##BITS##_t delta) {       \
+    if (!needs_swap(ENDIAN_ENUM_##ENDIAN))                                          \
+        return __atomic_fetch_add(p, delta, __ATOMIC_SEQ_CST);                      \
+                                                                                    \
+    /* Add in host order, retry until no other writer intervened */                 \
+    uint##BITS##_t raw = __atomic_load_n(p, __ATOMIC_RELAXED);                      \
+    uint##BITS##_t old;                                                             \
+    do {                                                                            \
+        old = bswap##BITS(raw);                                                     \
+    } while (!__atomic_compare_exchange_n(p, &raw, bswap##BITS((uint##BITS##_t)(old + delta)), \
+                                          1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));  \
+    return old;                                                                     \
+}                                                                                   \
+                                                                                    \
+int endian_atomic_cas_##ENDIAN##BITS(uint##BITS##_t* p, uint##BITS##_t* expected,   \
+                                     uint##BITS##_t desired) {                      \
+    uint##BITS##_t raw = atomic_order_##ENDIAN##BITS(*expected);                    \
+    if (__atomic_compare_exchange_n(p, &raw, atomic_order_##ENDIAN##BITS(desired),  \
+                                    0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))         \
+        return 1;                                                                   \
+    *expected = atomic_order_##ENDIAN##BITS(raw);                                   \
+    return 0;                                                                       \
+}
+
+DEFINE_ATOMIC_FUNCS(32, be)
+DEFINE_ATOMIC_FUNCS(64, be)
+DEFINE_ATOMIC_FUNCS(32, le)
+DEFINE_ATOMIC_FUNCS(64, le)
+
+#endif
@@ -8,6 +8,94 @@
 extern "C" {
 #endif
 
+// -----------------------------------------------------------------------------
+// Inline Load/Store Helpers
+// -----------------------------------------------------------------------------
+// Unaligned loads and stores of fixed-order integers from memory. Compilers
+// turn these byte patterns into a single (byte-swapping) load or store.
+
+static inline uint16_t load_be16(const void* p) {
+    const uint8_t* b = (const uint8_t*)p;
+    return (uint16_t)(((uint16_t)b[0] << 8) | b[1]);
+}
+
+static inline uint32_t load_be32(const void* p) {
+    const uint8_t* b = (const uint8_t*)p;
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) |
+           ((uint32_t)b[2] << 8)  |  (uint32_t)b[3];
+}
+
+static inline uint64_t load_be64(const void* p) {
+    const uint8_t* b = (const uint8_t*)p;
+    return ((uint64_t)load_be32(b) << 32) | load_be32(b + 4);
+}
+
+static inline uint16_t load_le16(const void* p) {
+    const uint8_t* b = (const uint8_t*)p;
+    return (uint16_t)(b[0] | ((uint16_t)b[1] << 8));
+}
+
+static inline uint32_t load_le32(const void* p) {
+    const uint8_t* b = (const uint8_t*)p;
+    return  (uint32_t)b[0]        | ((uint32_t)b[1] << 8) |
+           ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static inline uint64_t load_le64(const void* p) {
+    const uint8_t* b = (const uint8_t*)p;
+    return load_le32(b) | ((uint64_t)load_le32(b + 4) << 32);
+}
+
+static inline void store_be16(void* p, uint16_t v) {
+    uint8_t* b = (uint8_t*)p;
+    b[0] = (uint8_t)(v >> 8);
+    b[1] = (uint8_t)v;
+}
+
+static inline void store_be32(void* p, uint32_t v) {
+    uint8_t* b = (uint8_t*)p;
+    b[0] = (uint8_t)(v >> 24);
+    b[1] = (uint8_t)(v >> 16);
+    b[2] = (uint8_t)(v >> 8);
+    b[3] = (uint8_t)v;
+}
+
+static inline void store_be64(void* p, uint64_t v) {
+    uint8_t* b = (uint8_t*)p;
+    store_be32(b, (uint32_t)(v >> 32));
+    store_be32(b + 4, (uint32_t)v);
+}
+
+static inline void store_le16(void* p, uint16_t v) {
+    uint8_t* b = (uint8_t*)p;
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+}
+
+static inline void store_le32(void* p, uint32_t v) {
+    uint8_t* b = (uint8_t*)p;
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+    b[2] = (uint8_t)(v >> 16);
+    b[3] = (uint8_t)(v >> 24);
+}
+
+static inline void store_le64(void* p, uint64_t v) {
+    uint8_t* b = (uint8_t*)p;
+    store_le32(b, (uint32_t)v);
+    store_le32(b + 4, (uint32_t)(v >> 32));
+}
+
+// Stores the low size (1, 2, 4 or 8) bytes of v in the given order
+static inline void store_sized(void* p, uint64_t v, size_t size, int big_endian) {
+    switch (size) {
+        case 1: *(uint8_t*)p = (uint8_t)v; break;
+        case 2: if (big_endian) store_be16(p, (uint16_t)v); else store_le16(p, (uint16_t)v); break;
+        case 4: if (big_endian) store_be32(p, (uint32_t)v); else store_le32(p, (uint32_t)v); break;
+        default: if (big_endian) store_be64(p, v); else store_le64(p, v); break;
+    }
+}
+
 /**
  * @brief Writes an array of elements to a file in big-endian byte order.
  *
@@ -56,6 +144,29 @@ int write_le(FILE* file, const uint8_t* data, size_t num, size_t size);
  */
 int read_le(FILE* file, uint8_t* data, size_t num, size_t size);
 
+/**
+ * @brief Converts an array in memory between big-endian and host order.
+ *
+ * The conversion is its own inverse, so the same call decodes big-endian data
+ * that was loaded or mapped into memory and encodes host data for output.
+ *
+ * @param data  Pointer to the array, converted in place.
+ * @param num   Number of elements.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int convert_be(uint8_t* data, size_t num, size_t size);
+
+/**
+ * @brief Converts an array in memory between little-endian and host order.
+ *
+ * @param data  Pointer to the array, converted in place.
+ * @param num   Number of elements.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int convert_le(uint8_t* data, size_t num, size_t size);
+
 
 // Generic macro to declare endian functions for any number type
 #define DECLARE_ENDIAN_IO_FUNCS(NUMBERTYPE, ENDIAN) \
@@ -85,6 +196,812 @@ DECLARE_ENDIAN_IO_FUNCS(int64_t, le)
 DECLARE_ENDIAN_IO_FUNCS(float, le)
 DECLARE_ENDIAN_IO_FUNCS(double, le)
 
+// -----------------------------------------------------------------------------
+// Sources and Sinks
+// -----------------------------------------------------------------------------
+// Byte streams other than FILE* (decompressors, network buffers, custom
+// storage) plug in through a small vtable. read_be()/write_be(), the _le pair
+// and the typed array functions above are thin adapters over the same code,
+// as are the TIFF and WAV/AIFF readers, the netCDF reader and the buffered
+// Java data and template writers. Random-access formats need the seek hook.
+// The remaining array readers and writers (packed, shuffled, string, ordered
+// and fixed-point) and the other format modules take a FILE* only.
+
+/// Readable byte stream.
+typedef struct {
+    /// Reads exactly n bytes into dst; returns 0 on success, -1 on short read.
+    int (*read)(void* ctx, uint8_t* dst, size_t n);
+    /// Optional zero-copy hook: consumes and returns the next n bytes from the
+    /// stream's own storage, or returns NULL to fall back to read.
+    const uint8_t* (*direct)(void* ctx, size_t n);
+    void* ctx;
+    /// Optional random-access hook: moves to an absolute offset; returns 0 on
+    /// success, -1 past the end. NULL for forward-only streams.
+    int (*seek)(void* ctx, uint64_t offset);
+} endian_source_t;
+
+/// Writable byte stream.
+typedef struct {
+    /// Writes n bytes from src; returns 0 on success, -1 on error.
+    int (*write)(void* ctx, const uint8_t* src, size_t n);
+    /// Optional zero-copy hook: reserves and returns n bytes of the stream's
+    /// own storage, which count as written once filled, or returns NULL to
+    /// fall back to write.
+    uint8_t* (*direct)(void* ctx, size_t n);
+    void* ctx;
+} endian_sink_t;
+
+/// Memory region used by the buffer source and sink.
+typedef struct {
+    uint8_t* data;      ///< Storage (only read by sources)
+    size_t size;
+    size_t pos;         ///< Bytes consumed or produced so far
+} endian_buffer_t;
+
+/// Sets up a source reading from file, seekable up to LONG_MAX.
+void endian_source_from_file(endian_source_t* src, FILE* file);
+
+/// Sets up a sink writing to file.
+void endian_sink_from_file(endian_sink_t* sink, FILE* file);
+
+/// Sets up a source reading buf->data from buf->pos, with direct and seek hooks.
+void endian_source_from_buffer(endian_source_t* src, endian_buffer_t* buf);
+
+/// Sets up a sink filling buf->data from buf->pos, with a direct hook.
+void endian_sink_from_buffer(endian_sink_t* sink, endian_buffer_t* buf);
+
+/**
+ * @brief Reads n bytes at an absolute offset of a seekable source.
+ *
+ * @param src     Input stream with a seek hook.
+ * @param offset  Offset of the first byte.
+ * @param dst     Output buffer of n bytes.
+ * @param n       Number of bytes to read.
+ * @return 0 on success, -1 on a short read or if src cannot seek.
+ */
+int endian_source_read_at(const endian_source_t* src, uint64_t offset, uint8_t* dst, size_t n);
+
+/// Buffered writer over a sink. Small writes are staged in caller-owned
+/// storage and passed on in blocks; larger ones go straight to the sink.
+typedef struct {
+    endian_sink_t sink;
+    uint8_t* buffer;    ///< Staging storage of capacity bytes
+    size_t capacity;
+    size_t fill;        ///< Number of bytes staged in buffer
+    int error;          ///< Set once a write to the sink has failed
+} endian_writer_t;
+
+/// Sets up a writer staging up to capacity bytes in buffer before writing to sink.
+void endian_writer_init(endian_writer_t* w, const endian_sink_t* sink,
+                        uint8_t* buffer, size_t capacity);
+
+/**
+ * @brief Makes room for n staged bytes, writing out the buffer if needed.
+ *
+ * The caller fills the returned bytes and then adds n to w->fill.
+ *
+ * @param w  Writer.
+ * @param n  Number of bytes, at most w->capacity.
+ * @return Pointer to buffer + fill, or NULL once a write has failed.
+ */
+uint8_t* endian_writer_reserve(endian_writer_t* w, size_t n);
+
+/// Stages or writes n bytes; returns 0 on success, -1 once a write has failed.
+int endian_writer_write(endian_writer_t* w, const uint8_t* src, size_t n);
+
+/// Writes out the staged bytes; returns 0 on success, -1 once a write has failed.
+int endian_writer_flush(endian_writer_t* w);
+
+/**
+ * @brief Writes an array to a sink in big-endian byte order.
+ *
+ * With a direct hook the elements are converted straight into the sink's
+ * storage; otherwise they are staged through a small buffer.
+ *
+ * @param sink  Output stream.
+ * @param data  Pointer to input data array.
+ * @param num   Number of elements to write.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int write_be_to(const endian_sink_t* sink, const uint8_t* data, size_t num, size_t size);
+
+/**
+ * @brief Reads an array from a source and converts it from big-endian to host order.
+ *
+ * @param src   Input stream.
+ * @param data  Pointer to output buffer.
+ * @param num   Number of elements to read.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int read_be_from(const endian_source_t* src, uint8_t* data, size_t num, size_t size);
+
+/// Little-endian counterpart of write_be_to().
+int write_le_to(const endian_sink_t* sink, const uint8_t* data, size_t num, size_t size);
+
+/// Little-endian counterpart of read_be_from().
+int read_le_from(const endian_source_t* src, uint8_t* data, size_t num, size_t size);
+
+#define DECLARE_STREAM_IO_FUNCS(NUMBERTYPE, ENDIAN) \
+    int write_##NUMBERTYPE##_##ENDIAN##_to(const endian_sink_t* sink, const NUMBERTYPE* arr, size_t n); \
+    int read_##NUMBERTYPE##_##ENDIAN##_from(const endian_source_t* src, NUMBERTYPE* arr, size_t n);
+
+DECLARE_STREAM_IO_FUNCS(uint8_t, be)
+DECLARE_STREAM_IO_FUNCS(uint16_t, be)
+DECLARE_STREAM_IO_FUNCS(uint32_t, be)
+DECLARE_STREAM_IO_FUNCS(uint64_t, be)
+DECLARE_STREAM_IO_FUNCS(int8_t, be)
+DECLARE_STREAM_IO_FUNCS(int16_t, be)
+DECLARE_STREAM_IO_FUNCS(int32_t, be)
+DECLARE_STREAM_IO_FUNCS(int64_t, be)
+DECLARE_STREAM_IO_FUNCS(float, be)
+DECLARE_STREAM_IO_FUNCS(double, be)
+
+DECLARE_STREAM_IO_FUNCS(uint8_t, le)
+DECLARE_STREAM_IO_FUNCS(uint16_t, le)
+DECLARE_STREAM_IO_FUNCS(uint32_t, le)
+DECLARE_STREAM_IO_FUNCS(uint64_t, le)
+DECLARE_STREAM_IO_FUNCS(int8_t, le)
+DECLARE_STREAM_IO_FUNCS(int16_t, le)
+DECLARE_STREAM_IO_FUNCS(int32_t, le)
+DECLARE_STREAM_IO_FUNCS(int64_t, le)
+DECLARE_STREAM_IO_FUNCS(float, le)
+DECLARE_STREAM_IO_FUNCS(double, le)
+
+// -----------------------------------------------------------------------------
+// Bit-Packed Integer Arrays
+// -----------------------------------------------------------------------------
+
+/// Order in which bits are filled within each byte of a packed stream.
+typedef enum {
+    BIT_ORDER_MSB_FIRST, ///< First field occupies the high bits (network style)
+    BIT_ORDER_LSB_FIRST  ///< First field occupies the low bits (DEFLATE style)
+} bit_order_t;
+
+/**
+ * @brief Writes an array of uint32_t values as frame-of-reference packed fields.
+ *
+ * The minimum value is stored as the base and every element is written as
+ * (value - base) using the smallest bit width that fits the range. The stream
+ * starts with a 6-byte header: base (uint32_t, big-endian), bit width (uint8_t)
+ * and bit order (uint8_t), followed by ceil(n * width / 8) payload bytes.
+ *
+ * @param file   Open binary file for writing.
+ * @param arr    Pointer to input values.
+ * @param n      Number of values to write.
+ * @param order  Bit order used to fill the payload bytes.
+ * @return 0 on success, -1 on error.
+ */
+int write_packed_u32(FILE* file, const uint32_t* arr, size_t n, bit_order_t order);
+
+/**
+ * @brief Reads an array written by write_packed_u32().
+ *
+ * The base, bit width and bit order are taken from the stream header.
+ *
+ * @param file  Open binary file for reading.
+ * @param arr   Pointer to output buffer.
+ * @param n     Number of values to read (must match the written count).
+ * @return 0 on success, -1 on error or malformed header.
+ */
+int read_packed_u32(FILE* file, uint32_t* arr, size_t n);
+
+// -----------------------------------------------------------------------------
+// Byte-Plane Shuffle
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Writes an array as byte planes with big-endian plane order.
+ *
+ * Byte-shuffle (Blosc-style) layout: plane 0 holds the most significant byte
+ * of every element, plane 1 the next byte, and so on. Grouping bytes of equal
+ * significance makes numeric arrays far more compressible. The transpose and
+ * the endian conversion are done in a single pass.
+ *
+ * @param file  Open binary file for writing.
+ * @param data  Pointer to input data array.
+ * @param num   Number of elements to write.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int write_shuffle_be(FILE* file, const uint8_t* data, size_t num, size_t size);
+
+/**
+ * @brief Reads an array written by write_shuffle_be() back into host order.
+ *
+ * @param file  Open binary file for reading.
+ * @param data  Pointer to output buffer.
+ * @param num   Number of elements to read.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int read_shuffle_be(FILE* file, uint8_t* data, size_t num, size_t size);
+
+/**
+ * @brief Writes an array as byte planes with little-endian plane order.
+ *
+ * Plane 0 holds the least significant byte of every element.
+ *
+ * @param file  Open binary file for writing.
+ * @param data  Pointer to input data array.
+ * @param num   Number of elements to write.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int write_shuffle_le(FILE* file, const uint8_t* data, size_t num, size_t size);
+
+/**
+ * @brief Reads an array written by write_shuffle_le() back into host order.
+ *
+ * @param file  Open binary file for reading.
+ * @param data  Pointer to output buffer.
+ * @param num   Number of elements to read.
+ * @param size  Size of each element in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int read_shuffle_le(FILE* file, uint8_t* data, size_t num, size_t size);
+
+// -----------------------------------------------------------------------------
+// Bit Streams
+// -----------------------------------------------------------------------------
+#define BIT_STREAM_BUFFER_SIZE 4096
+
+/// Buffered reader of bit fields; fields are at most 56 bits wide.
+typedef struct {
+    FILE* file;
+    bit_order_t order;
+    uint64_t cache;   ///< Pending bits, left-aligned (MSB) or right-aligned (LSB)
+    unsigned count;   ///< Number of valid bits in cache
+    size_t pos;       ///< Read position in buffer
+    size_t avail;     ///< Number of valid bytes in buffer
+    uint8_t buffer[BIT_STREAM_BUFFER_SIZE];
+} bit_reader_t;
+
+/// Buffered writer of bit fields; fields are at most 56 bits wide.
+typedef struct {
+    FILE* file;
+    bit_order_t order;
+    uint64_t cache;   ///< Pending bits, left-aligned (MSB) or right-aligned (LSB)
+    unsigned count;   ///< Number of valid bits in cache
+    size_t fill;      ///< Number of bytes staged in buffer
+    int error;        ///< Set once a write has failed
+    uint8_t buffer[BIT_STREAM_BUFFER_SIZE];
+} bit_writer_t;
+
+/**
+ * @brief Initializes a bit reader on an open binary file.
+ *
+ * @param br     Reader to initialize.
+ * @param file   Open binary file for reading.
+ * @param order  Bit order of the stream.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int bit_reader_init(bit_reader_t* br, FILE* file, bit_order_t order);
+
+/**
+ * @brief Returns the next n bits without consuming them.
+ *
+ * Bits past the end of the file read as zero.
+ *
+ * @param br  Bit reader.
+ * @param n   Number of bits (0 to 56).
+ * @return The next n bits, right-aligned; 0 if n is 0 or out of range.
+ */
+uint64_t bit_reader_peek(bit_reader_t* br, unsigned n);
+
+/**
+ * @brief Discards n bits previously made available by bit_reader_peek().
+ *
+ * @param br  Bit reader.
+ * @param n   Number of bits (0 to 56), at most the number just peeked.
+ *            Counts past the end of the stream are clamped.
+ */
+void bit_reader_consume(bit_reader_t* br, unsigned n);
+
+/**
+ * @brief Reads one n-bit field.
+ *
+ * @param br     Bit reader.
+ * @param n      Field width in bits (0 to 56).
+ * @param value  Receives the field, right-aligned.
+ * @return 0 on success, -1 on error or end of file.
+ */
+int bit_reader_read(bit_reader_t* br, unsigned n, uint64_t* value);
+
+/**
+ * @brief Reads count fields of the same width.
+ *
+ * @param br     Bit reader.
+ * @param width  Field width in bits (0 to 32).
+ * @param arr    Pointer to output buffer.
+ * @param count  Number of fields to read.
+ * @return 0 on success, -1 on error or end of file.
+ */
+int bit_reader_read_array(bit_reader_t* br, unsigned width, uint32_t* arr, size_t count);
+
+/**
+ * @brief Skips to the next byte boundary of the stream.
+ *
+ * @param br  Bit reader.
+ */
+void bit_reader_align(bit_reader_t* br);
+
+/**
+ * @brief Initializes a bit writer on an open binary file.
+ *
+ * @param bw     Writer to initialize.
+ * @param file   Open binary file for writing.
+ * @param order  Bit order of the stream.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int bit_writer_init(bit_writer_t* bw, FILE* file, bit_order_t order);
+
+/**
+ * @brief Writes one n-bit field. Bits of value above n are ignored.
+ *
+ * @param bw     Bit writer.
+ * @param value  Field value.
+ * @param n      Field width in bits (0 to 56).
+ * @return 0 on success, -1 on error.
+ */
+int bit_writer_write(bit_writer_t* bw, uint64_t value, unsigned n);
+
+/**
+ * @brief Writes count fields of the same width.
+ *
+ * @param bw     Bit writer.
+ * @param width  Field width in bits (0 to 32).
+ * @param arr    Pointer to input values.
+ * @param count  Number of fields to write.
+ * @return 0 on success, -1 on error.
+ */
+int bit_writer_write_array(bit_writer_t* bw, unsigned width, const uint32_t* arr, size_t count);
+
+/**
+ * @brief Pads the stream with zero bits to a byte boundary and writes all
+ *        staged bytes to the file.
+ *
+ * @param bw  Bit writer.
+ * @return 0 on success, -1 if any write has failed.
+ */
+int bit_writer_flush(bit_writer_t* bw);
+
+// -----------------------------------------------------------------------------
+// UTF-16 / UTF-32 Text
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Reads UTF-16 big-endian code units from a file and transcodes them
+ *        to UTF-8.
+ *
+ * Byte swapping, validation and transcoding happen in a single pass. Unpaired
+ * surrogates are rejected. The output is not NUL-terminated.
+ *
+ * @param file      Open binary file for reading.
+ * @param units     Number of 16-bit code units to read.
+ * @param dst       Output buffer for UTF-8 text.
+ * @param dst_size  Size of the output buffer in bytes (3 * units always fits).
+ * @param length    Receives the number of UTF-8 bytes written.
+ * @return 0 on success, -1 on I/O error, invalid text or insufficient space.
+ */
+int read_utf16_be(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length);
+
+/**
+ * @brief Reads UTF-16 little-endian code units and transcodes them to UTF-8.
+ *
+ * See read_utf16_be() for details.
+ */
+int read_utf16_le(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length);
+
+/**
+ * @brief Reads UTF-32 big-endian code units and transcodes them to UTF-8.
+ *
+ * Code points above U+10FFFF and surrogates are rejected. 4 * units bytes of
+ * output always fit.
+ */
+int read_utf32_be(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length);
+
+/**
+ * @brief Reads UTF-32 little-endian code units and transcodes them to UTF-8.
+ *
+ * See read_utf32_be() for details.
+ */
+int read_utf32_le(FILE* file, size_t units, char* dst, size_t dst_size, size_t* length);
+
+/**
+ * @brief Transcodes UTF-8 text to UTF-16 big-endian and writes it to a file.
+ *
+ * Malformed UTF-8 (overlong forms, surrogates, truncated sequences) is
+ * rejected; output written before the error is not rolled back.
+ *
+ * @param file   Open binary file for writing.
+ * @param str    UTF-8 input text.
+ * @param len    Length of the input in bytes.
+ * @param units  If not NULL, receives the number of code units written.
+ * @return 0 on success, -1 on I/O error or invalid text.
+ */
+int write_utf16_be(FILE* file, const char* str, size_t len, size_t* units);
+
+/// Little-endian counterpart of write_utf16_be().
+int write_utf16_le(FILE* file, const char* str, size_t len, size_t* units);
+
+/// UTF-32 big-endian counterpart of write_utf16_be().
+int write_utf32_be(FILE* file, const char* str, size_t len, size_t* units);
+
+/// UTF-32 little-endian counterpart of write_utf16_be().
+int write_utf32_le(FILE* file, const char* str, size_t len, size_t* units);
+
+// -----------------------------------------------------------------------------
+// Length-Prefixed Strings
+// -----------------------------------------------------------------------------
+
+/// Non-owning view of a string inside a caller-owned buffer.
+typedef struct {
+    const char* data;   ///< First byte of the string (not NUL-terminated)
+    uint32_t length;    ///< Length in bytes
+} string_view_t;
+
+/**
+ * @brief Writes strings as a big-endian uint32_t length followed by the bytes.
+ *
+ * Lengths and bytes of consecutive strings are staged into one buffer and
+ * written with as few I/O calls as possible.
+ *
+ * @param file     Open binary file for writing.
+ * @param strs     Array of n strings; NULL entries are written as empty.
+ * @param lengths  Array of n lengths in bytes, or NULL to use strlen().
+ * @param n        Number of strings.
+ * @return 0 on success, -1 on error or if a string is longer than UINT32_MAX.
+ */
+int write_strings_be(FILE* file, const char* const* strs, const size_t* lengths, size_t n);
+
+/**
+ * @brief Reads a table of n strings written by write_strings_be().
+ *
+ * All string bytes are stored back to back in a single allocated blob;
+ * string i spans [offsets[i], offsets[i + 1]). The blob is not NUL-terminated
+ * and must be released with free().
+ *
+ * The table is read in 64 KiB blocks. Bytes read past the end of the table
+ * are given back with fseek(), so if data follows the table the file must be
+ * seekable.
+ *
+ * @param file       Open binary file for reading.
+ * @param n          Number of strings to read.
+ * @param offsets    Output array of n + 1 offsets into the blob.
+ * @param blob       Receives the allocated blob (NULL if all strings are empty).
+ * @param blob_size  If not NULL, receives the blob size in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int read_strings_be(FILE* file, size_t n, size_t* offsets, char** blob, size_t* blob_size);
+
+/**
+ * @brief Parses n length-prefixed big-endian strings from memory without copying.
+ *
+ * Intended for memory-mapped files: the views point into data.
+ *
+ * @param data      Encoded string table.
+ * @param size      Size of data in bytes.
+ * @param n         Number of strings to parse.
+ * @param views     Output array of n views.
+ * @param consumed  If not NULL, receives the number of bytes parsed.
+ * @return 0 on success, -1 if the table is truncated.
+ */
+int view_strings_be(const uint8_t* data, size_t size, size_t n,
+                    string_view_t* views, size_t* consumed);
+
+/// Little-endian counterpart of write_strings_be().
+int write_strings_le(FILE* file, const char* const* strs, const size_t* lengths, size_t n);
+
+/// Little-endian counterpart of read_strings_be().
+int read_strings_le(FILE* file, size_t n, size_t* offsets, char** blob, size_t* blob_size);
+
+/// Little-endian counterpart of view_strings_be().
+int view_strings_le(const uint8_t* data, size_t size, size_t n,
+                    string_view_t* views, size_t* consumed);
+
+// -----------------------------------------------------------------------------
+// Byte Permutation Orders
+// -----------------------------------------------------------------------------
+#define ENDIAN_ORDER_MAX_SIZE 16
+
+/**
+ * Arbitrary byte order of a fixed-size element, e.g. word-swapped 32-bit
+ * Modbus register pairs ("3412") or legacy ARM FPA doubles ("43218765").
+ * Built by endian_order_init() and treated as opaque afterwards.
+ */
+typedef struct {
+    size_t size;                            ///< Element size in bytes
+    int kind;                               ///< Identity, full reversal or general
+    uint8_t decode[ENDIAN_ORDER_MAX_SIZE];  ///< Host byte j comes from stored byte decode[j]
+    uint8_t encode[ENDIAN_ORDER_MAX_SIZE];  ///< Stored byte i comes from host byte encode[i]
+    uint8_t decode_mask[16];                ///< decode replicated across a 16-byte block
+    uint8_t encode_mask[16];                ///< encode replicated across a 16-byte block
+} endian_order_t;
+
+/**
+ * @brief Compiles a byte order from its significance list.
+ *
+ * The spec lists, for each stored byte in file order, the significance of
+ * the value byte it holds, counting from 1 for the most significant byte:
+ * "1234" is big-endian, "4321" little-endian, "3412" word-swapped and
+ * "2143" byte-swapped within words. Dashes between digits are ignored
+ * ("3-4-1-2"). Elements of 10 to 16 bytes need the comma-separated form,
+ * which takes decimal positions ("9,10,11,12,13,14,15,16,1,2,3,4,5,6,7,8").
+ *
+ * Orders are accepted by read_ordered(), write_ordered(),
+ * convert_from_ordered(), convert_to_ordered() and the typed _ordered
+ * functions; the other readers and writers take only big or little endian.
+ *
+ * @param order  Receives the compiled order.
+ * @param spec   Significance list.
+ * @return 0 on success, -1 if spec is not a permutation.
+ */
+int endian_order_init(endian_order_t* order, const char* spec);
+
+/**
+ * @brief Compiles a byte order from 0-based significances.
+ *
+ * positions[i] is the significance (0 = most significant) of the value byte
+ * held by stored byte i. Supports elements of up to ENDIAN_ORDER_MAX_SIZE
+ * bytes.
+ *
+ * @param order      Receives the compiled order.
+ * @param positions  Permutation of 0 .. size - 1.
+ * @param size       Element size in bytes.
+ * @return 0 on success, -1 if positions is not a permutation.
+ */
+int endian_order_from_positions(endian_order_t* order, const uint8_t* positions, size_t size);
+
+/**
+ * @brief Writes num elements of order->size bytes, stored in the given order.
+ *
+ * @param file   Open binary file for writing.
+ * @param data   Elements in host order.
+ * @param num    Number of elements.
+ * @param order  Byte order in the file.
+ * @return 0 on success, -1 on error.
+ */
+int write_ordered(FILE* file, const uint8_t* data, size_t num, const endian_order_t* order);
+
+/**
+ * @brief Reads num elements stored in the given order into host order.
+ *
+ * @param file   Open binary file for reading.
+ * @param data   Output array of num * order->size bytes.
+ * @param num    Number of elements.
+ * @param order  Byte order in the file.
+ * @return 0 on success, -1 on error.
+ */
+int read_ordered(FILE* file, uint8_t* data, size_t num, const endian_order_t* order);
+
+/**
+ * @brief Converts an in-memory array from the given order to host order.
+ *
+ * @param data   Array converted in place.
+ * @param num    Number of elements.
+ * @param order  Byte order of the input.
+ * @return 0 on success, -1 on error.
+ */
+int convert_from_ordered(uint8_t* data, size_t num, const endian_order_t* order);
+
+/**
+ * @brief Converts an in-memory array from host order to the given order.
+ *
+ * @param data   Array converted in place.
+ * @param num    Number of elements.
+ * @param order  Byte order of the output.
+ * @return 0 on success, -1 on error.
+ */
+int convert_to_ordered(uint8_t* data, size_t num, const endian_order_t* order);
+
+// Typed wrappers; they fail if order->size differs from the type size
+#define DECLARE_ORDERED_IO_FUNCS(NUMBERTYPE) \
+    int write_##NUMBERTYPE##_ordered(FILE* file, const NUMBERTYPE* arr, size_t n, \
+                                     const endian_order_t* order); \
+    int read_##NUMBERTYPE##_ordered(FILE* file, NUMBERTYPE* arr, size_t n, \
+                                    const endian_order_t* order);
+
+DECLARE_ORDERED_IO_FUNCS(uint16_t)
+DECLARE_ORDERED_IO_FUNCS(uint32_t)
+DECLARE_ORDERED_IO_FUNCS(uint64_t)
+DECLARE_ORDERED_IO_FUNCS(int16_t)
+DECLARE_ORDERED_IO_FUNCS(int32_t)
+DECLARE_ORDERED_IO_FUNCS(int64_t)
+DECLARE_ORDERED_IO_FUNCS(float)
+DECLARE_ORDERED_IO_FUNCS(double)
+
+// -----------------------------------------------------------------------------
+// Fixed-Point Conversion
+// -----------------------------------------------------------------------------
+// Signed 16- or 32-bit fixed-point values with frac_bits fractional bits
+// (Q15 is bits = 16, frac_bits = 15). Decoding, swapping and scaling happen
+// in one pass; encoding rounds to nearest (ties away from zero), saturates
+// to the integer range and maps NaN to 0.
+
+/**
+ * @brief Decodes fixed-point values from memory to float.
+ *
+ * @param raw         Input of n * bits / 8 bytes.
+ * @param out         Output array of n floats.
+ * @param n           Number of values.
+ * @param bits        Stored width, 16 or 32.
+ * @param frac_bits   Fractional bits, at most bits.
+ * @param big_endian  1 if the input is big-endian, 0 for little-endian.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int decode_fixed_f32(const uint8_t* raw, float* out, size_t n,
+                     unsigned bits, unsigned frac_bits, int big_endian);
+
+/**
+ * @brief Encodes floats to fixed-point in memory, rounding and saturating.
+ *
+ * @param in          Input array of n floats.
+ * @param raw         Output of n * bits / 8 bytes.
+ * @param n           Number of values.
+ * @param bits        Stored width, 16 or 32.
+ * @param frac_bits   Fractional bits, at most bits.
+ * @param big_endian  1 to store big-endian values, 0 for little-endian.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int encode_fixed_f32(const float* in, uint8_t* raw, size_t n,
+                     unsigned bits, unsigned frac_bits, int big_endian);
+
+/// Reads n fixed-point values through a chunk buffer; see decode_fixed_f32().
+int read_fixed_f32(FILE* file, float* out, size_t n,
+                   unsigned bits, unsigned frac_bits, int big_endian);
+
+/// Writes n floats as fixed-point through a chunk buffer; see encode_fixed_f32().
+int write_fixed_f32(FILE* file, const float* in, size_t n,
+                    unsigned bits, unsigned frac_bits, int big_endian);
+
+/// double counterparts, which keep the full precision of 32-bit values.
+int decode_fixed_f64(const uint8_t* raw, double* out, size_t n,
+                     unsigned bits, unsigned frac_bits, int big_endian);
+int encode_fixed_f64(const double* in, uint8_t* raw, size_t n,
+                     unsigned bits, unsigned frac_bits, int big_endian);
+int read_fixed_f64(FILE* file, double* out, size_t n,
+                   unsigned bits, unsigned frac_bits, int big_endian);
+int write_fixed_f64(FILE* file, const double* in, size_t n,
+                    unsigned bits, unsigned frac_bits, int big_endian);
+
+// Q15 / Q31 shorthands, e.g. read_q15be_to_f32() and write_f32_to_q31le()
+#define DECLARE_Q_FORMAT_FUNCS(Q, TYPE, SUFFIX) \
+    int read_##Q##be_to_##SUFFIX(FILE* file, TYPE* out, size_t n); \
+    int read_##Q##le_to_##SUFFIX(FILE* file, TYPE* out, size_t n); \
+    int write_##SUFFIX##_to_##Q##be(FILE* file, const TYPE* in, size_t n); \
+    int write_##SUFFIX##_to_##Q##le(FILE* file, const TYPE* in, size_t n);
+
+DECLARE_Q_FORMAT_FUNCS(q15, float, f32)
+DECLARE_Q_FORMAT_FUNCS(q31, float, f32)
+DECLARE_Q_FORMAT_FUNCS(q15, double, f64)
+DECLARE_Q_FORMAT_FUNCS(q31, double, f64)
+
+// -----------------------------------------------------------------------------
+// Block-Quantized Tensors
+// -----------------------------------------------------------------------------
+
+/**
+ * Layout of 8-bit block-quantized data. Each block of block_size values is
+ * stored as its float32 parameters followed by one byte per value:
+ *   - signed:   scale d, then int8 q;  value = d * q, with |q| <= 127
+ *   - unsigned: scale d, minimum m, then uint8 q;  value = d * q + m
+ */
+typedef struct {
+    size_t block_size;  ///< Values per block, e.g. 32 or 64
+    int is_signed;      ///< 1 for int8 blocks, 0 for uint8 blocks with a minimum
+    int big_endian;     ///< Byte order of the float32 parameters
+} quant8_format_t;
+
+/**
+ * @brief Returns the stored size of one block, or 0 if fmt is invalid.
+ */
+size_t quant8_block_bytes(const quant8_format_t* fmt);
+
+/**
+ * @brief Decodes whole blocks from memory to float.
+ *
+ * Blocks are independent, so large tensors can be split into block ranges
+ * and decoded in parallel by the caller.
+ *
+ * @param fmt      Block layout.
+ * @param raw      Input of nblocks * quant8_block_bytes(fmt) bytes.
+ * @param nblocks  Number of blocks.
+ * @param out      Output array of nblocks * fmt->block_size floats.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int decode_quant8_f32(const quant8_format_t* fmt, const uint8_t* raw, size_t nblocks,
+                      float* out);
+
+/**
+ * @brief Quantizes floats to whole blocks in memory.
+ *
+ * Signed blocks use d = max|x| / 127; unsigned blocks use m = min(x) and
+ * d = (max(x) - min(x)) / 255. Values are rounded to nearest.
+ *
+ * @param fmt      Block layout.
+ * @param in       Input array of nblocks * fmt->block_size floats.
+ * @param nblocks  Number of blocks.
+ * @param raw      Output of nblocks * quant8_block_bytes(fmt) bytes.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int encode_quant8_f32(const quant8_format_t* fmt, const float* in, size_t nblocks,
+                      uint8_t* raw);
+
+/// Reads nblocks blocks through a chunk buffer; see decode_quant8_f32().
+int read_quant8_f32(FILE* file, const quant8_format_t* fmt, float* out, size_t nblocks);
+
+/// Writes nblocks blocks through a chunk buffer; see encode_quant8_f32().
+int write_quant8_f32(FILE* file, const quant8_format_t* fmt, const float* in, size_t nblocks);
+
+// -----------------------------------------------------------------------------
+// Big-Integer Limbs
+// -----------------------------------------------------------------------------
+// Conversion between unsigned integers stored as byte strings (RSA moduli,
+// EC coordinates, ...) and arrays of native uint64_t limbs, least
+// significant limb first. A leading partial limb is handled, and the full
+// limbs are converted with a block reverse on little-endian hosts.
+
+/**
+ * @brief Imports a big-endian byte string into little-endian-ordered limbs.
+ *
+ * Limbs above the value are zeroed; leading zero bytes are ignored.
+ *
+ * @param limbs   Output array of nlimbs limbs.
+ * @param nlimbs  Number of limbs.
+ * @param bytes   Big-endian magnitude.
+ * @param nbytes  Length of bytes.
+ * @return 0 on success, -1 if the value does not fit in nlimbs limbs.
+ */
+int endian_bigint_import_be(uint64_t* limbs, size_t nlimbs, const uint8_t* bytes, size_t nbytes);
+
+/**
+ * @brief Exports limbs as a big-endian byte string of exactly nbytes bytes.
+ *
+ * The value is left-padded with zero bytes.
+ *
+ * @param bytes   Output buffer of nbytes bytes.
+ * @param nbytes  Length of the output.
+ * @param limbs   Input limbs, least significant first.
+ * @param nlimbs  Number of limbs.
+ * @return 0 on success, -1 if the value needs more than nbytes bytes.
+ */
+int endian_bigint_export_be(uint8_t* bytes, size_t nbytes, const uint64_t* limbs, size_t nlimbs);
+
+/// Little-endian byte string counterpart of endian_bigint_import_be().
+int endian_bigint_import_le(uint64_t* limbs, size_t nlimbs, const uint8_t* bytes, size_t nbytes);
+
+/// Little-endian byte string counterpart of endian_bigint_export_be().
+int endian_bigint_export_le(uint8_t* bytes, size_t nbytes, const uint64_t* limbs, size_t nlimbs);
+
+// -----------------------------------------------------------------------------
+// Atomic Fixed-Order Integers
+// -----------------------------------------------------------------------------
+// Atomic operations on naturally aligned big- or little-endian integers, e.g.
+// counters in a shared mmapped file updated by several processes. Values are
+// passed and returned in host order. When the stored order matches the host
+// the native instruction is used (lock xadd on x86); otherwise the update is
+// a compare-and-swap loop over the swapped value. Loads have acquire and
+// stores release semantics; the read-modify-write operations are sequentially
+// consistent. Available with GCC and Clang.
+
+#define DECLARE_ATOMIC_FUNCS(BITS, ENDIAN) \
+    uint##BITS##_t endian_atomic_load_##ENDIAN##BITS(const uint##BITS##_t* p); \
+    void endian_atomic_store_##ENDIAN##BITS(uint##BITS##_t* p, uint##BITS##_t value); \
+    uint##BITS##_t endian_atomic_exchange_##ENDIAN##BITS(uint##BITS##_t* p, uint##BITS##_t value); \
+    uint##BITS##_t endian_atomic_fetch_add_##ENDIAN##BITS(uint##BITS##_t* p, uint##BITS##_t delta); \
+    int endian_atomic_cas_##ENDIAN##BITS(uint##BITS##_t* p, uint##BITS##_t* expected, \
+                                         uint##BITS##_t desired);
+
+// endian_atomic_cas_*() stores desired and returns 1 if the current value
+// equals *expected; otherwise it loads the current value into *expected and
+// returns 0.
+DECLARE_ATOMIC_FUNCS(32, be)
+DECLARE_ATOMIC_FUNCS(64, be)
+DECLARE_ATOMIC_FUNCS(32, le)
+DECLARE_ATOMIC_FUNCS(64, le)
+
 #ifdef __cplusplus
 }
 #endif
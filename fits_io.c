@@ -0,0 +1,448 @@
+#include "fits_io.h"
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define FITS_CARDS_PER_BLOCK (FITS_BLOCK_SIZE / FITS_CARD_SIZE)
+#define FITS_BUFFER_SIZE 65536
+
+static inline size_t pad_to_block(size_t size) {
+    return (size + FITS_BLOCK_SIZE - 1) / FITS_BLOCK_SIZE * FITS_BLOCK_SIZE;
+}
+
+static inline size_t pixel_size(int bitpix) {
+    return (size_t)(bitpix < 0 ? -bitpix : bitpix) / 8;
+}
+
+// -----------------------------------------------------------------------------
+// Header Parsing
+// -----------------------------------------------------------------------------
+
+static void init_hdu(fits_hdu_t* hdu) {
+    memset(hdu, 0, sizeof(*hdu));
+    hdu->bscale = 1.0;
+    hdu->gcount = 1;
+    for (size_t i = 0; i < FITS_MAX_COLUMNS; i++)
+        hdu->columns[i].scale = 1.0;
+}
+
+// Matches keywords such as NAXIS2 or TFORM12 and returns the index.
+static int indexed_keyword(const char* keyword, const char* prefix, size_t* index) {
+    const size_t len = strlen(prefix);
+    if (strncmp(keyword, prefix, len) != 0 || keyword[len] == '\0')
+        return 0;
+
+    size_t n = 0;
+    for (const char* p = keyword + len; *p; p++) {
+        if (*p < '0' || *p > '9')
+            return 0;
+        n = n * 10 + (size_t)(*p - '0');
+    }
+    *index = n;
+    return n > 0;
+}
+
+// Copies a quoted string value, without trailing blanks.
+static void string_value(const char* value, char* out, size_t out_size) {
+    size_t len = 0;
+    while (*value == ' ')
+        value++;
+    if (*value == '\'') {
+        for (value++; *value && len + 1 < out_size; value++) {
+            if (*value == '\'') {
+                if (value[1] != '\'')
+                    break;
+                value++; // escaped quote
+            }
+            out[len++] = *value;
+        }
+    }
+    while (len > 0 && out[len - 1] == ' ')
+        len--;
+    out[len] = '\0';
+}
+
+// FITS allows a 'D' exponent in floating point values
+static double number_value(const char* value) {
+    char text[FITS_CARD_SIZE];
+    size_t len = 0;
+    for (; *value && *value != '/' && len + 1 < sizeof(text); value++)
+        text[len++] = (*value == 'D' || *value == 'd') ? 'E' : *value;
+    text[len] = '\0';
+    return strtod(text, NULL);
+}
+
+static int parse_tform(const char* tform, fits_column_t* column) {
+    size_t repeat = 0;
+    int has_repeat = 0;
+    while (*tform >= '0' && *tform <= '9') {
+        const size_t digit = (size_t)(*tform++ - '0');
+        if (repeat > (SIZE_MAX / 16 - digit) / 10)
+            return -1; // keeps every width below within size_t
+        repeat = repeat * 10 + digit;
+        has_repeat = 1;
+    }
+    column->repeat = has_repeat ? repeat : 1;
+    column->type = *tform;
+
+    switch (column->type) {
+        case 'L': case 'B': case 'A': column->width = column->repeat;      break;
+        case 'X': column->width = (column->repeat + 7) / 8;                break;
+        case 'I': column->width = column->repeat * 2;                      break;
+        case 'J': case 'E': column->width = column->repeat * 4;            break;
+        case 'K': case 'D': case 'C': case 'P': column->width = column->repeat * 8; break;
+        case 'M': case 'Q': column->width = column->repeat * 16;           break;
+        default: return -1;
+    }
+    return 0;
+}
+
+// Processes the 36 cards of one header block; sets *end at the END card.
+static int parse_block(const char* block, fits_hdu_t* hdu, int first_block, int* end) {
+    for (size_t c = 0; c < FITS_CARDS_PER_BLOCK; c++) {
+        const char* card = block + c * FITS_CARD_SIZE;
+
+        char keyword[9];
+        size_t len = 0;
+        while (len < 8 && card[len] != ' ') {
+            keyword[len] = card[len];
+            len++;
+        }
+        keyword[len] = '\0';
+
+        if (first_block && c == 0 &&
+            strcmp(keyword, "SIMPLE") != 0 && strcmp(keyword, "XTENSION") != 0)
+            return -1;
+        if (strcmp(keyword, "END") == 0) {
+            *end = 1;
+            return 0;
+        }
+        if (card[8] != '=' || card[9] != ' ')
+            continue; // COMMENT, HISTORY and blank cards
+
+        char value[FITS_CARD_SIZE];
+        memcpy(value, card + 10, FITS_CARD_SIZE - 10);
+        value[FITS_CARD_SIZE - 10] = '\0';
+
+        size_t index;
+        if (strcmp(keyword, "BITPIX") == 0) {
+            hdu->bitpix = (int)number_value(value);
+        } else if (strcmp(keyword, "NAXIS") == 0) {
+            hdu->naxis = (size_t)number_value(value);
+            if (hdu->naxis > FITS_MAX_AXES)
+                return -1;
+        } else if (indexed_keyword(keyword, "NAXIS", &index)) {
+            if (index > FITS_MAX_AXES)
+                return -1;
+            hdu->axes[index - 1] = (size_t)number_value(value);
+        } else if (strcmp(keyword, "BSCALE") == 0) {
+            hdu->bscale = number_value(value);
+        } else if (strcmp(keyword, "BZERO") == 0) {
+            hdu->bzero = number_value(value);
+        } else if (strcmp(keyword, "PCOUNT") == 0) {
+            hdu->pcount = (size_t)number_value(value);
+        } else if (strcmp(keyword, "GCOUNT") == 0) {
+            hdu->gcount = (size_t)number_value(value);
+        } else if (strcmp(keyword, "XTENSION") == 0) {
+            char name[FITS_CARD_SIZE];
+            string_value(value, name, sizeof(name));
+            hdu->bintable = strcmp(name, "BINTABLE") == 0;
+        } else if (strcmp(keyword, "TFIELDS") == 0) {
+            hdu->tfields = (size_t)number_value(value);
+            if (hdu->tfields > FITS_MAX_COLUMNS)
+                return -1;
+        } else if (indexed_keyword(keyword, "TFORM", &index)) {
+            char tform[FITS_CARD_SIZE];
+            string_value(value, tform, sizeof(tform));
+            if (index > FITS_MAX_COLUMNS || parse_tform(tform, &hdu->columns[index - 1]) != 0)
+                return -1;
+        } else if (indexed_keyword(keyword, "TSCAL", &index)) {
+            if (index > FITS_MAX_COLUMNS)
+                return -1;
+            hdu->columns[index - 1].scale = number_value(value);
+        } else if (indexed_keyword(keyword, "TZERO", &index)) {
+            if (index > FITS_MAX_COLUMNS)
+                return -1;
+            hdu->columns[index - 1].zero = number_value(value);
+        }
+    }
+    return 0;
+}
+
+static int finish_header(fits_hdu_t* hdu) {
+    if (pixel_size(hdu->bitpix) == 0 ||
+        (hdu->bitpix != 8 && hdu->bitpix != 16 && hdu->bitpix != 32 && hdu->bitpix != 64 &&
+         hdu->bitpix != -32 && hdu->bitpix != -64))
+        return -1;
+
+    // Reject headers whose data size does not fit in size_t, padding included
+    size_t elements = 0;
+    if (hdu->naxis > 0) {
+        elements = 1;
+        for (size_t i = 0; i < hdu->naxis; i++) {
+            if (hdu->axes[i] != 0 && elements > SIZE_MAX / hdu->axes[i])
+                return -1;
+            elements *= hdu->axes[i];
+        }
+    }
+    const size_t size = pixel_size(hdu->bitpix);
+    if (hdu->pcount > SIZE_MAX - elements)
+        return -1;
+    const size_t per_group = hdu->pcount + elements;
+    if (hdu->gcount != 0 && size > SIZE_MAX / hdu->gcount)
+        return -1;
+    if (per_group != 0 && size * hdu->gcount > (SIZE_MAX - FITS_BLOCK_SIZE) / per_group)
+        return -1;
+    hdu->data_size = size * hdu->gcount * per_group;
+
+    if (hdu->bintable) {
+        size_t offset = 0;
+        for (size_t i = 0; i < hdu->tfields; i++) {
+            if (hdu->columns[i].type == '\0')
+                return -1;
+            if (hdu->columns[i].width > SIZE_MAX - offset)
+                return -1;
+            hdu->columns[i].offset = offset;
+            offset += hdu->columns[i].width;
+        }
+        if (hdu->naxis != 2 || offset > hdu->axes[0])
+            return -1;
+    }
+    return 0;
+}
+
+int fits_read_header(FILE* file, fits_hdu_t* hdu) {
+    if (!file || !hdu)
+        return -1;
+
+    init_hdu(hdu);
+    char block[FITS_BLOCK_SIZE];
+    int end = 0;
+    for (size_t blocks = 0; !end; blocks++) {
+        if (fread(block, 1, sizeof(block), file) != sizeof(block))
+            return -1;
+        if (parse_block(block, hdu, blocks == 0, &end) != 0)
+            return -1;
+    }
+
+    const long offset = ftell(file);
+    if (offset < 0)
+        return -1;
+    hdu->data_offset = (size_t)offset;
+    return finish_header(hdu);
+}
+
+// Seeks to a byte offset within the data unit of an HDU
+static int seek_data(FILE* file, const fits_hdu_t* hdu, size_t offset) {
+    if (hdu->data_offset > (size_t)LONG_MAX || offset > (size_t)LONG_MAX - hdu->data_offset)
+        return -1;
+    return fseek(file, (long)(hdu->data_offset + offset), SEEK_SET) == 0 ? 0 : -1;
+}
+
+int fits_skip_data(FILE* file, const fits_hdu_t* hdu) {
+    if (!file || !hdu)
+        return -1;
+    return seek_data(file, hdu, pad_to_block(hdu->data_size));
+}
+
+int fits_parse_header(const uint8_t* data, size_t size, fits_hdu_t* hdu) {
+    if (!data || !hdu)
+        return -1;
+
+    init_hdu(hdu);
+    size_t offset = 0;
+    int end = 0;
+    while (!end) {
+        if (size - offset < FITS_BLOCK_SIZE)
+            return -1;
+        if (parse_block((const char*)data + offset, hdu, offset == 0, &end) != 0)
+            return -1;
+        offset += FITS_BLOCK_SIZE;
+    }
+
+    hdu->data_offset = offset;
+    return finish_header(hdu);
+}
+
+// -----------------------------------------------------------------------------
+// Fused Decode Kernels
+// -----------------------------------------------------------------------------
+
+// Swap, convert and scale in one pass per BITPIX. Integer pixels are signed
+// except for BITPIX 8; the loops have no cross-iteration dependencies.
+#define DEFINE_FITS_DECODE(TYPE, SUFFIX)                                          \
+static int decode_pixels_##SUFFIX(const uint8_t* raw, size_t n, int bitpix,       \
+                                  double scale, double zero, TYPE* out) {         \
+    switch (bitpix) {                                                             \
+        case 8:                                                                   \
+            for (size_t i = 0; i < n; i++)                                        \
+                out[i] = (TYPE)(raw[i] * scale + zero);                           \
+            return 0;                                                             \
+        case 16:                                                                  \
+            for (size_t i = 0; i < n; i++)                                        \
+                out[i] = (TYPE)((int16_t)load_be16(raw + 2 * i) * scale + zero);  \
+            return 0;                                                             \
+        case 32:                                                                  \
+            for (size_t i = 0; i < n; i++)                                        \
+                out[i] = (TYPE)((int32_t)load_be32(raw + 4 * i) * scale + zero);  \
+            return 0;                                                             \
+        case 64:                                                                  \
+            for (size_t i = 0; i < n; i++)                                        \
+                out[i] = (TYPE)((double)(int64_t)load_be64(raw + 8 * i) * scale + zero); \
+            return 0;                                                             \
+        case -32:                                                                 \
+            for (size_t i = 0; i < n; i++) {                                      \
+                const uint32_t bits = load_be32(raw + 4 * i);                     \
+                float value;                                                      \
+                memcpy(&value, &bits, sizeof(value));                             \
+                out[i] = (TYPE)(value * scale + zero);                            \
+            }                                                                     \
+            return 0;                                                             \
+        case -64:                                                                 \
+            for (size_t i = 0; i < n; i++) {                                      \
+                const uint64_t bits = load_be64(raw + 8 * i);                     \
+                double value;                                                     \
+                memcpy(&value, &bits, sizeof(value));                             \
+                out[i] = (TYPE)(value * scale + zero);                            \
+            }                                                                     \
+            return 0;                                                             \
+        default:                                                                  \
+            return -1;                                                            \
+    }                                                                             \
+}                                                                                 \
+                                                                                  \
+/* Reads n pixels at the current file position through a staging buffer */      \
+static int read_pixels_##SUFFIX(FILE* file, uint8_t* buffer, size_t n,            \
+                                const fits_hdu_t* hdu, TYPE* out) {               \
+    const size_t size = pixel_size(hdu->bitpix);                                  \
+    const size_t block = FITS_BUFFER_SIZE / size;                                 \
+    for (size_t done = 0; done < n; ) {                                           \
+        const size_t batch = n - done < block ? n - done : block;                 \
+        if (fread(buffer, size, batch, file) != batch)                            \
+            return -1;                                                            \
+        decode_pixels_##SUFFIX(buffer, batch, hdu->bitpix,                        \
+                               hdu->bscale, hdu->bzero, out + done);              \
+        done += batch;                                                            \
+    }                                                                             \
+    return 0;                                                                     \
+}                                                                                 \
+                                                                                  \
+int fits_decode_##SUFFIX(const uint8_t* raw, size_t n, const fits_hdu_t* hdu, TYPE* out) { \
+    if (!raw || !hdu || !out)                                                     \
+        return -1;                                                                \
+    return decode_pixels_##SUFFIX(raw, n, hdu->bitpix, hdu->bscale, hdu->bzero, out); \
+}                                                                                 \
+                                                                                  \
+int fits_read_image_##SUFFIX(FILE* file, const fits_hdu_t* hdu, TYPE* out) {      \
+    size_t start[FITS_MAX_AXES] = {0};                                            \
+    if (!hdu)                                                                     \
+        return -1;                                                                \
+    return fits_read_cutout_##SUFFIX(file, hdu, start, hdu->axes, out);           \
+}                                                                                 \
+                                                                                  \
+int fits_read_cutout_##SUFFIX(FILE* file, const fits_hdu_t* hdu,                  \
+                              const size_t* start, const size_t* count, TYPE* out) { \
+    if (!file || !hdu || !start || !count || !out || hdu->naxis == 0 || hdu->bintable) \
+        return -1;                                                                \
+    for (size_t i = 0; i < hdu->naxis; i++) {                                     \
+        if (start[i] > hdu->axes[i] || count[i] > hdu->axes[i] - start[i])        \
+            return -1;                                                            \
+    }                                                                             \
+                                                                                  \
+    /* Leading axes read in full are contiguous on disk, so they merge with */    \
+    /* the next axis into a single run; only the remaining axes need seeks */     \
+    size_t run = count[0];                                                        \
+    size_t outer = 1;                                                             \
+    while (outer < hdu->naxis && count[outer - 1] == hdu->axes[outer - 1])        \
+        run *= count[outer++];                                                    \
+    size_t rows = 1;                                                              \
+    for (size_t i = outer; i < hdu->naxis; i++)                                   \
+        rows *= count[i];                                                         \
+    if (run == 0 || rows == 0)                                                    \
+        return 0;                                                                 \
+                                                                                  \
+    uint8_t* buffer = (uint8_t*)malloc(FITS_BUFFER_SIZE);                         \
+    if (!buffer)                                                                  \
+        return -1;                                                                \
+                                                                                  \
+    const size_t size = pixel_size(hdu->bitpix);                                  \
+    size_t index[FITS_MAX_AXES] = {0};                                            \
+    int status = 0;                                                               \
+    for (size_t row = 0; row < rows && status == 0; row++) {                      \
+        /* Linear pixel index of the first pixel of this run */                   \
+        size_t pixel = 0;                                                         \
+        for (size_t i = hdu->naxis; i-- > 0; )                                    \
+            pixel = pixel * hdu->axes[i] + start[i] + index[i];                   \
+                                                                                  \
+        if (seek_data(file, hdu, pixel * size) != 0 ||                            \
+            read_pixels_##SUFFIX(file, buffer, run, hdu, out + row * run) != 0)   \
+            status = -1;                                                          \
+                                                                                  \
+        for (size_t i = outer; i < hdu->naxis; i++) {                             \
+            if (++index[i] < count[i])                                            \
+                break;                                                            \
+            index[i] = 0;                                                         \
+        }                                                                         \
+    }                                                                             \
+                                                                                  \
+    free(buffer);                                                                 \
+    return status;                                                                \
+}
+
+DEFINE_FITS_DECODE(float, f32)
+DEFINE_FITS_DECODE(double, f64)
+
+// -----------------------------------------------------------------------------
+// Binary Tables
+// -----------------------------------------------------------------------------
+
+static int column_bitpix(char type) {
+    switch (type) {
+        case 'B': return 8;
+        case 'I': return 16;
+        case 'J': return 32;
+        case 'K': return 64;
+        case 'E': return -32;
+        case 'D': return -64;
+        default:  return 0;
+    }
+}
+
+int fits_read_column_f64(FILE* file, const fits_hdu_t* hdu, size_t column,
+                         size_t first_row, size_t nrows, double* out) {
+    if (!file || !hdu || !out || !hdu->bintable || column >= hdu->tfields)
+        return -1;
+
+    const fits_column_t* col = &hdu->columns[column];
+    const int bitpix = column_bitpix(col->type);
+    const size_t row_size = hdu->axes[0];
+    if (bitpix == 0 || first_row > hdu->axes[1] || nrows > hdu->axes[1] - first_row)
+        return -1;
+    if (nrows == 0)
+        return 0;
+
+    // Whole rows are read in large blocks and the column is gathered from them
+    const size_t block_rows = row_size < FITS_BUFFER_SIZE ? FITS_BUFFER_SIZE / row_size : 1;
+    uint8_t* buffer = (uint8_t*)malloc(block_rows * row_size);
+    if (!buffer)
+        return -1;
+
+    int status = 0;
+    if (seek_data(file, hdu, first_row * row_size) != 0)
+        status = -1;
+
+    for (size_t done = 0; done < nrows && status == 0; ) {
+        const size_t batch = nrows - done < block_rows ? nrows - done : block_rows;
+        if (fread(buffer, row_size, batch, file) != batch) {
+            status = -1;
+            break;
+        }
+        for (size_t r = 0; r < batch; r++)
+            decode_pixels_f64(buffer + r * row_size + col->offset, col->repeat, bitpix,
+                              col->scale, col->zero, out + (done + r) * col->repeat);
+        done += batch;
+    }
+
+    free(buffer);
+    return status;
+}
@@ -0,0 +1,143 @@
+#ifndef FITS_IO_H
+#define FITS_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FITS_BLOCK_SIZE 2880
+#define FITS_CARD_SIZE 80
+#define FITS_MAX_AXES 16
+#define FITS_MAX_COLUMNS 999
+
+/// Binary table column described by TFORMn, TSCALn and TZEROn.
+typedef struct {
+    char type;          ///< TFORM type code: 'L', 'X', 'B', 'I', 'J', 'K', 'A', 'E', 'D', ...
+    size_t repeat;      ///< Repeat count
+    size_t offset;      ///< Byte offset of the field within a row
+    size_t width;       ///< Field width in bytes
+    double scale;       ///< TSCALn (default 1)
+    double zero;        ///< TZEROn (default 0)
+} fits_column_t;
+
+/// Parsed header of one header-data unit (HDU).
+typedef struct {
+    int bitpix;                     ///< 8, 16, 32, 64, -32 or -64
+    size_t naxis;                   ///< Number of axes
+    size_t axes[FITS_MAX_AXES];     ///< NAXISn; axes[0] varies fastest
+    double bscale;                  ///< BSCALE (default 1)
+    double bzero;                   ///< BZERO (default 0)
+    size_t pcount;                  ///< PCOUNT (heap size for binary tables)
+    size_t gcount;                  ///< GCOUNT
+    int bintable;                   ///< 1 for XTENSION = 'BINTABLE'
+    size_t tfields;                 ///< Number of binary table columns
+    fits_column_t columns[FITS_MAX_COLUMNS];
+    size_t data_offset;             ///< Offset of the data unit from the source start
+    size_t data_size;               ///< Size of the data unit without padding
+} fits_hdu_t;
+
+/**
+ * @brief Reads and parses an HDU header, leaving the file at its data unit.
+ *
+ * @param file  Open binary file positioned at the start of an HDU.
+ * @param hdu   Receives the parsed header.
+ * @return 0 on success, -1 on error or malformed header.
+ */
+int fits_read_header(FILE* file, fits_hdu_t* hdu);
+
+/**
+ * @brief Seeks past the (padded) data unit to the next HDU.
+ *
+ * @param file  Open binary file.
+ * @param hdu   Header returned by fits_read_header().
+ * @return 0 on success, -1 on error.
+ */
+int fits_skip_data(FILE* file, const fits_hdu_t* hdu);
+
+/**
+ * @brief Parses an HDU header from memory, e.g. an mmapped file.
+ *
+ * hdu->data_offset is relative to data, so the data unit of the next HDU
+ * starts FITS_BLOCK_SIZE-aligned after data + data_offset + data_size.
+ *
+ * @param data  Start of the HDU.
+ * @param size  Number of bytes available.
+ * @param hdu   Receives the parsed header.
+ * @return 0 on success, -1 on malformed or truncated header.
+ */
+int fits_parse_header(const uint8_t* data, size_t size, fits_hdu_t* hdu);
+
+/**
+ * @brief Decodes big-endian image pixels with BSCALE/BZERO applied.
+ *
+ * The byte swap, integer/float conversion and scaling are fused into a
+ * single pass.
+ *
+ * @param raw  Pixels as stored in the data unit.
+ * @param n    Number of pixels.
+ * @param hdu  Header providing BITPIX, BSCALE and BZERO.
+ * @param out  Output array of n physical values.
+ * @return 0 on success, -1 on unsupported BITPIX.
+ */
+int fits_decode_f32(const uint8_t* raw, size_t n, const fits_hdu_t* hdu, float* out);
+
+/// Double precision counterpart of fits_decode_f32().
+int fits_decode_f64(const uint8_t* raw, size_t n, const fits_hdu_t* hdu, double* out);
+
+/**
+ * @brief Reads the full image of an HDU as physical values.
+ *
+ * @param file  Open binary file.
+ * @param hdu   Header returned by fits_read_header().
+ * @param out   Output array holding the product of all axes.
+ * @return 0 on success, -1 on error.
+ */
+int fits_read_image_f32(FILE* file, const fits_hdu_t* hdu, float* out);
+
+/// Double precision counterpart of fits_read_image_f32().
+int fits_read_image_f64(FILE* file, const fits_hdu_t* hdu, double* out);
+
+/**
+ * @brief Reads a sub-rectangle (cutout) of an image.
+ *
+ * Each contiguous run is read with a single I/O call: a row segment along
+ * axis 0, or whole planes and beyond when the leading axes are read in full.
+ *
+ * @param file   Open binary file.
+ * @param hdu    Header returned by fits_read_header().
+ * @param start  First pixel along each of the hdu->naxis axes (0-based).
+ * @param count  Number of pixels along each axis.
+ * @param out    Output array of the product of count, axis 0 fastest.
+ * @return 0 on success, -1 on error or if the cutout is out of bounds.
+ */
+int fits_read_cutout_f32(FILE* file, const fits_hdu_t* hdu,
+                         const size_t* start, const size_t* count, float* out);
+
+/// Double precision counterpart of fits_read_cutout_f32().
+int fits_read_cutout_f64(FILE* file, const fits_hdu_t* hdu,
+                         const size_t* start, const size_t* count, double* out);
+
+/**
+ * @brief Reads a numeric binary table column as physical values.
+ *
+ * Supported column types are B, I, J, K, E and D; TSCALn/TZEROn are applied.
+ * Each row contributes columns[column].repeat values.
+ *
+ * @param file       Open binary file.
+ * @param hdu        Binary table header returned by fits_read_header().
+ * @param column     Column index (0-based).
+ * @param first_row  First row to read (0-based).
+ * @param nrows      Number of rows to read.
+ * @param out        Output array of nrows * repeat values.
+ * @return 0 on success, -1 on error or unsupported column type.
+ */
+int fits_read_column_f64(FILE* file, const fits_hdu_t* hdu, size_t column,
+                         size_t first_row, size_t nrows, double* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FITS_IO_H
@@ -0,0 +1,422 @@
+#include "jdata_io.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Buffering
+// -----------------------------------------------------------------------------
+
+int jdata_reader_init(jdata_reader_t* r, FILE* file) {
+    if (!r || !file)
+        return -1;
+    r->file = file;
+    r->pos = 0;
+    r->avail = 0;
+    return 0;
+}
+
+int jdata_writer_init(jdata_writer_t* w, FILE* file) {
+    if (!w || !file)
+        return -1;
+    endian_sink_t sink;
+    endian_sink_from_file(&sink, file);
+    return jdata_writer_init_sink(w, &sink);
+}
+
+int jdata_writer_init_sink(jdata_writer_t* w, const endian_sink_t* sink) {
+    if (!w || !sink || !sink->write)
+        return -1;
+    endian_writer_init(&w->out, sink, w->buffer, sizeof(w->buffer));
+    return 0;
+}
+
+// Makes at least n (<= JDATA_BUFFER_SIZE) bytes available at r->pos
+static int fill(jdata_reader_t* r, size_t n) {
+    const size_t rest = r->avail - r->pos;
+    if (rest >= n)
+        return 0;
+
+    memmove(r->buffer, r->buffer + r->pos, rest);
+    r->pos = 0;
+    r->avail = rest + fread(r->buffer + rest, 1, sizeof(r->buffer) - rest, r->file);
+    return r->avail >= n ? 0 : -1;
+}
+
+int jdata_writer_flush(jdata_writer_t* w) {
+    if (!w)
+        return -1;
+    return endian_writer_flush(&w->out);
+}
+
+int jdata_read_fully(jdata_reader_t* r, uint8_t* dst, size_t n) {
+    if (!r || (!dst && n > 0))
+        return -1;
+
+    const size_t have = r->avail - r->pos;
+    if (have >= n) {
+        memcpy(dst, r->buffer + r->pos, n);
+        r->pos += n;
+        return 0;
+    }
+
+    memcpy(dst, r->buffer + r->pos, have);
+    r->pos = r->avail;
+    dst += have;
+    n -= have;
+
+    // Large requests go straight to the destination
+    if (n >= sizeof(r->buffer))
+        return fread(dst, 1, n, r->file) == n ? 0 : -1;
+    if (fill(r, n) != 0)
+        return -1;
+    memcpy(dst, r->buffer, n);
+    r->pos = n;
+    return 0;
+}
+
+int jdata_write_bytes(jdata_writer_t* w, const uint8_t* src, size_t n) {
+    if (!w || (!src && n > 0))
+        return -1;
+    return endian_writer_write(&w->out, src, n);
+}
+
+// -----------------------------------------------------------------------------
+// Primitives
+// -----------------------------------------------------------------------------
+
+int jdata_read_unsigned_byte(jdata_reader_t* r, uint8_t* value) {
+    if (!r || !value || fill(r, 1) != 0)
+        return -1;
+    *value = r->buffer[r->pos++];
+    return 0;
+}
+
+int jdata_read_byte(jdata_reader_t* r, int8_t* value) {
+    uint8_t b;
+    if (!value || jdata_read_unsigned_byte(r, &b) != 0)
+        return -1;
+    *value = (int8_t)b;
+    return 0;
+}
+
+int jdata_read_boolean(jdata_reader_t* r, int* value) {
+    uint8_t b;
+    if (!value || jdata_read_unsigned_byte(r, &b) != 0)
+        return -1;
+    *value = b != 0;
+    return 0;
+}
+
+int jdata_write_byte(jdata_writer_t* w, int8_t value) {
+    uint8_t* dst;
+    if (!w || !(dst = endian_writer_reserve(&w->out, 1)))
+        return -1;
+    dst[0] = (uint8_t)value;
+    w->out.fill++;
+    return 0;
+}
+
+int jdata_write_boolean(jdata_writer_t* w, int value) {
+    return jdata_write_byte(w, value ? 1 : 0);
+}
+
+// Fixed-size big-endian primitives. Values are moved through their bit
+// pattern, which covers the integer and floating-point types alike.
+#define DEFINE_JDATA_SCALAR(NAME, TYPE, BITS) \
+int jdata_read_##NAME(jdata_reader_t* r, TYPE* value) { \
+    if (!r || !value || fill(r, BITS / 8) != 0) \
+        return -1; \
+    const uint##BITS##_t bits = load_be##BITS(r->buffer + r->pos); \
+    memcpy(value, &bits, sizeof(bits)); \
+    r->pos += BITS / 8; \
+    return 0; \
+}
+
+#define DEFINE_JDATA_SCALAR_WRITE(NAME, TYPE, BITS) \
+int jdata_write_##NAME(jdata_writer_t* w, TYPE value) { \
+    uint##BITS##_t bits; \
+    memcpy(&bits, &value, sizeof(bits)); \
+    uint8_t* dst; \
+    if (!w || !(dst = endian_writer_reserve(&w->out, BITS / 8))) \
+        return -1; \
+    store_be##BITS(dst, bits); \
+    w->out.fill += BITS / 8; \
+    return 0; \
+}
+
+DEFINE_JDATA_SCALAR(short, int16_t, 16)
+DEFINE_JDATA_SCALAR(unsigned_short, uint16_t, 16)
+DEFINE_JDATA_SCALAR(char, uint16_t, 16)
+DEFINE_JDATA_SCALAR(int, int32_t, 32)
+DEFINE_JDATA_SCALAR(long, int64_t, 64)
+DEFINE_JDATA_SCALAR(float, float, 32)
+DEFINE_JDATA_SCALAR(double, double, 64)
+
+DEFINE_JDATA_SCALAR_WRITE(short, int16_t, 16)
+DEFINE_JDATA_SCALAR_WRITE(char, uint16_t, 16)
+DEFINE_JDATA_SCALAR_WRITE(int, int32_t, 32)
+DEFINE_JDATA_SCALAR_WRITE(long, int64_t, 64)
+DEFINE_JDATA_SCALAR_WRITE(float, float, 32)
+DEFINE_JDATA_SCALAR_WRITE(double, double, 64)
+
+// -----------------------------------------------------------------------------
+// Bulk Arrays
+// -----------------------------------------------------------------------------
+
+static int read_array(jdata_reader_t* r, uint8_t* data, size_t num, size_t size) {
+    if (!r || (!data && num > 0) || num > SIZE_MAX / size)
+        return -1;
+    if (jdata_read_fully(r, data, num * size) != 0)
+        return -1;
+    return convert_be(data, num, size);
+}
+
+// Elements are staged into the buffer and swapped there, leaving the
+// caller's array untouched.
+static int write_array(jdata_writer_t* w, const uint8_t* data, size_t num, size_t size) {
+    if (!w || (!data && num > 0))
+        return -1;
+
+    endian_writer_t* out = &w->out;
+    while (num > 0) {
+        // Room for at least one element, writing out the buffer if needed
+        if (!endian_writer_reserve(out, size))
+            return -1;
+        size_t batch = (out->capacity - out->fill) / size;
+        if (batch > num)
+            batch = num;
+
+        uint8_t* dst = out->buffer + out->fill;
+        memcpy(dst, data, batch * size);
+        convert_be(dst, batch, size);
+        out->fill += batch * size;
+        data += batch * size;
+        num -= batch;
+    }
+    return 0;
+}
+
+#define DEFINE_JDATA_ARRAY_FUNCS(NAME, TYPE) \
+int jdata_read_##NAME##_array(jdata_reader_t* r, TYPE* arr, size_t n) { \
+    return read_array(r, (uint8_t*)arr, n, sizeof(TYPE)); \
+} \
+int jdata_write_##NAME##_array(jdata_writer_t* w, const TYPE* arr, size_t n) { \
+    return write_array(w, (const uint8_t*)arr, n, sizeof(TYPE)); \
+}
+
+DEFINE_JDATA_ARRAY_FUNCS(short, int16_t)
+DEFINE_JDATA_ARRAY_FUNCS(char, uint16_t)
+DEFINE_JDATA_ARRAY_FUNCS(int, int32_t)
+DEFINE_JDATA_ARRAY_FUNCS(long, int64_t)
+DEFINE_JDATA_ARRAY_FUNCS(float, float)
+DEFINE_JDATA_ARRAY_FUNCS(double, double)
+
+// -----------------------------------------------------------------------------
+// Modified UTF-8
+// -----------------------------------------------------------------------------
+
+// Longest encoded sequence: a surrogate pair of two three-byte forms
+#define JDATA_MAX_SEQUENCE 6
+
+// Decodes s[0, n). Unless last is set, decoding stops before the final
+// JDATA_MAX_SEQUENCE bytes so no sequence is cut short; *consumed reports
+// where the next piece must resume.
+static int decode_modified_utf8(const uint8_t* s, size_t n, int last, uint8_t* dst, size_t cap,
+                                size_t* consumed, size_t* length) {
+    const size_t limit = last ? n : n > JDATA_MAX_SEQUENCE ? n - JDATA_MAX_SEQUENCE : 0;
+    size_t i = 0, o = 0;
+    while (i < limit) {
+        // Runs of ASCII are copied eight bytes at a time
+        while (i + 8 <= n && o + 8 <= cap) {
+            uint64_t v;
+            memcpy(&v, s + i, 8);
+            if (v & 0x8080808080808080ULL)
+                break;
+            memcpy(dst + o, &v, 8);
+            i += 8;
+            o += 8;
+        }
+        if (i >= n)
+            break;
+
+        const uint8_t c = s[i];
+        uint32_t unit;
+        switch (c >> 4) {
+            case 0: case 1: case 2: case 3: case 4: case 5: case 6: case 7:
+                unit = c;
+                i += 1;
+                break;
+            case 12: case 13:
+                if (i + 2 > n || (s[i + 1] & 0xC0) != 0x80)
+                    return -1;
+                unit = ((uint32_t)(c & 0x1F) << 6) | (s[i + 1] & 0x3F);
+                i += 2;
+                break;
+            case 14:
+                if (i + 3 > n || (s[i + 1] & 0xC0) != 0x80 || (s[i + 2] & 0xC0) != 0x80)
+                    return -1;
+                unit = ((uint32_t)(c & 0x0F) << 12) | ((uint32_t)(s[i + 1] & 0x3F) << 6) |
+                       (s[i + 2] & 0x3F);
+                i += 3;
+                break;
+            default:
+                return -1;
+        }
+
+        // A high surrogate must be followed by a low surrogate (ED B0..BF xx)
+        uint32_t cp = unit;
+        if (unit >= 0xD800 && unit <= 0xDFFF) {
+            if (unit > 0xDBFF || i + 3 > n || s[i] != 0xED || (s[i + 1] & 0xF0) != 0xB0 ||
+                (s[i + 2] & 0xC0) != 0x80)
+                return -1;
+            const uint32_t low = 0xD000 | ((uint32_t)(s[i + 1] & 0x3F) << 6) | (s[i + 2] & 0x3F);
+            cp = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+            i += 3;
+        }
+
+        size_t m;
+        if (cp < 0x80)         m = 1;
+        else if (cp < 0x800)   m = 2;
+        else if (cp < 0x10000) m = 3;
+        else                   m = 4;
+        if (cap - o < m)
+            return -1;
+
+        switch (m) {
+            case 1:
+                dst[o] = (uint8_t)cp;
+                break;
+            case 2:
+                dst[o]     = (uint8_t)(0xC0 | (cp >> 6));
+                dst[o + 1] = (uint8_t)(0x80 | (cp & 0x3F));
+                break;
+            case 3:
+                dst[o]     = (uint8_t)(0xE0 | (cp >> 12));
+                dst[o + 1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+                dst[o + 2] = (uint8_t)(0x80 | (cp & 0x3F));
+                break;
+            default:
+                dst[o]     = (uint8_t)(0xF0 | (cp >> 18));
+                dst[o + 1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+                dst[o + 2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+                dst[o + 3] = (uint8_t)(0x80 | (cp & 0x3F));
+                break;
+        }
+        o += m;
+    }
+
+    *consumed = i;
+    *length = o;
+    return 0;
+}
+
+int jdata_read_utf(jdata_reader_t* r, char* dst, size_t dst_size, size_t* length) {
+    uint16_t utflen;
+    if (!dst || !length || jdata_read_unsigned_short(r, &utflen) != 0)
+        return -1;
+
+    // Decoded in place from the read buffer, one buffer-sized piece at a time;
+    // a sequence cut by the end of a piece is carried over by the next fill
+    size_t remaining = utflen, o = 0;
+    while (remaining > 0) {
+        const size_t piece = remaining < sizeof(r->buffer) ? remaining : sizeof(r->buffer);
+        size_t used, produced;
+        if (fill(r, piece) != 0 ||
+            decode_modified_utf8(r->buffer + r->pos, piece, piece == remaining,
+                                 (uint8_t*)dst + o, dst_size - o, &used, &produced) != 0)
+            return -1;
+        r->pos += used;
+        remaining -= used;
+        o += produced;
+    }
+    *length = o;
+    return 0;
+}
+
+// Decodes one well-formed UTF-8 sequence; returns its length or 0 if it is
+// truncated, overlong, a surrogate or beyond U+10FFFF.
+static size_t next_code_point(const uint8_t* s, size_t len, uint32_t* cp) {
+    const uint8_t b0 = s[0];
+    size_t n;
+    uint32_t c, min;
+    if (b0 < 0x80)                { *cp = b0; return 1; }
+    else if ((b0 & 0xE0) == 0xC0) { n = 2; c = b0 & 0x1F; min = 0x80; }
+    else if ((b0 & 0xF0) == 0xE0) { n = 3; c = b0 & 0x0F; min = 0x800; }
+    else if ((b0 & 0xF8) == 0xF0) { n = 4; c = b0 & 0x07; min = 0x10000; }
+    else return 0;
+
+    if (len < n)
+        return 0;
+    for (size_t i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80)
+            return 0;
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+        return 0;
+    *cp = c;
+    return n;
+}
+
+static inline size_t put_unit(uint8_t* dst, uint32_t unit) {
+    if (unit != 0 && unit < 0x80) {
+        dst[0] = (uint8_t)unit;
+        return 1;
+    }
+    if (unit < 0x800) {
+        dst[0] = (uint8_t)(0xC0 | (unit >> 6));
+        dst[1] = (uint8_t)(0x80 | (unit & 0x3F));
+        return 2;
+    }
+    dst[0] = (uint8_t)(0xE0 | (unit >> 12));
+    dst[1] = (uint8_t)(0x80 | ((unit >> 6) & 0x3F));
+    dst[2] = (uint8_t)(0x80 | (unit & 0x3F));
+    return 3;
+}
+
+int jdata_write_utf(jdata_writer_t* w, const char* str, size_t len) {
+    if (!w || (!str && len > 0))
+        return -1;
+    const uint8_t* s = (const uint8_t*)str;
+
+    // First pass validates the input and sizes the encoded form
+    size_t utflen = 0;
+    for (size_t i = 0; i < len; ) {
+        uint32_t cp;
+        const size_t n = next_code_point(s + i, len - i, &cp);
+        if (n == 0)
+            return -1;
+        utflen += cp == 0 ? 2 : n == 4 ? 6 : n;
+        if (utflen > JDATA_MAX_UTF)
+            return -1;
+        i += n;
+    }
+    if (jdata_write_short(w, (int16_t)(uint16_t)utflen) != 0)
+        return -1;
+
+    for (size_t i = 0; i < len; ) {
+        // Runs of non-NUL ASCII are already in modified UTF-8
+        size_t j = i;
+        while (j < len && (uint8_t)(s[j] - 1) < 0x7F)
+            j++;
+        if (j > i) {
+            if (jdata_write_bytes(w, s + i, j - i) != 0)
+                return -1;
+            i = j;
+            continue;
+        }
+
+        uint32_t cp;
+        i += next_code_point(s + i, len - i, &cp);
+        uint8_t* dst = endian_writer_reserve(&w->out, 6);
+        if (!dst)
+            return -1;
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            const size_t high = put_unit(dst, 0xD800 | (cp >> 10));
+            w->out.fill += high + put_unit(dst + high, 0xDC00 | (cp & 0x3FF));
+        } else {
+            w->out.fill += put_unit(dst, cp);
+        }
+    }
+    return w->out.error ? -1 : 0;
+}
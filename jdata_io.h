@@ -0,0 +1,161 @@
+#ifndef JDATA_IO_H
+#define JDATA_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JDATA_BUFFER_SIZE 8192
+
+/// Longest encoded string accepted by readUTF/writeUTF.
+#define JDATA_MAX_UTF 65535
+
+/// Buffered reader compatible with java.io.DataInputStream.
+typedef struct {
+    FILE* file;
+    size_t pos;       ///< Read position in buffer
+    size_t avail;     ///< Number of valid bytes in buffer
+    uint8_t buffer[JDATA_BUFFER_SIZE];
+} jdata_reader_t;
+
+/// Buffered writer compatible with java.io.DataOutputStream.
+typedef struct {
+    endian_writer_t out;    ///< Stages bytes in buffer for the sink
+    uint8_t buffer[JDATA_BUFFER_SIZE];
+} jdata_writer_t;
+
+/**
+ * @brief Initializes a reader on an open binary file.
+ *
+ * @param r     Reader to initialize.
+ * @param file  Open binary file for reading.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int jdata_reader_init(jdata_reader_t* r, FILE* file);
+
+/**
+ * @brief Initializes a writer on an open binary file.
+ *
+ * @param w     Writer to initialize.
+ * @param file  Open binary file for writing.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int jdata_writer_init(jdata_writer_t* w, FILE* file);
+
+/**
+ * @brief Initializes a writer on a sink; jdata_writer_init() adapts a FILE*.
+ *
+ * @param w     Writer to initialize.
+ * @param sink  Output stream, copied into the writer.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int jdata_writer_init_sink(jdata_writer_t* w, const endian_sink_t* sink);
+
+/**
+ * @brief Writes all staged bytes to the file or sink.
+ *
+ * @param w  Writer.
+ * @return 0 on success, -1 if this or any earlier write failed.
+ */
+int jdata_writer_flush(jdata_writer_t* w);
+
+// -----------------------------------------------------------------------------
+// Primitives
+// -----------------------------------------------------------------------------
+
+// Each reader returns 0 on success and -1 at end of file (Java's EOFException).
+// Each writer returns 0 on success and -1 once the stream has failed.
+
+int jdata_read_boolean(jdata_reader_t* r, int* value);
+int jdata_read_byte(jdata_reader_t* r, int8_t* value);
+int jdata_read_unsigned_byte(jdata_reader_t* r, uint8_t* value);
+int jdata_read_short(jdata_reader_t* r, int16_t* value);
+int jdata_read_unsigned_short(jdata_reader_t* r, uint16_t* value);
+int jdata_read_char(jdata_reader_t* r, uint16_t* value);
+int jdata_read_int(jdata_reader_t* r, int32_t* value);
+int jdata_read_long(jdata_reader_t* r, int64_t* value);
+int jdata_read_float(jdata_reader_t* r, float* value);
+int jdata_read_double(jdata_reader_t* r, double* value);
+
+int jdata_write_boolean(jdata_writer_t* w, int value);
+int jdata_write_byte(jdata_writer_t* w, int8_t value);
+int jdata_write_short(jdata_writer_t* w, int16_t value);
+int jdata_write_char(jdata_writer_t* w, uint16_t value);
+int jdata_write_int(jdata_writer_t* w, int32_t value);
+int jdata_write_long(jdata_writer_t* w, int64_t value);
+int jdata_write_float(jdata_writer_t* w, float value);
+int jdata_write_double(jdata_writer_t* w, double value);
+
+/**
+ * @brief Reads exactly n bytes (DataInput.readFully).
+ */
+int jdata_read_fully(jdata_reader_t* r, uint8_t* dst, size_t n);
+
+/**
+ * @brief Writes n raw bytes (DataOutput.write).
+ */
+int jdata_write_bytes(jdata_writer_t* w, const uint8_t* src, size_t n);
+
+// -----------------------------------------------------------------------------
+// Bulk Arrays
+// -----------------------------------------------------------------------------
+
+// Arrays are laid out exactly as repeated writeShort/writeInt/... calls.
+// Large arrays bypass the buffer and are swapped in one pass.
+
+#define DECLARE_JDATA_ARRAY_FUNCS(NAME, TYPE) \
+    int jdata_read_##NAME##_array(jdata_reader_t* r, TYPE* arr, size_t n); \
+    int jdata_write_##NAME##_array(jdata_writer_t* w, const TYPE* arr, size_t n);
+
+DECLARE_JDATA_ARRAY_FUNCS(short, int16_t)
+DECLARE_JDATA_ARRAY_FUNCS(char, uint16_t)
+DECLARE_JDATA_ARRAY_FUNCS(int, int32_t)
+DECLARE_JDATA_ARRAY_FUNCS(long, int64_t)
+DECLARE_JDATA_ARRAY_FUNCS(float, float)
+DECLARE_JDATA_ARRAY_FUNCS(double, double)
+
+// -----------------------------------------------------------------------------
+// Modified UTF-8
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Reads a string written by DataOutput.writeUTF and converts it to
+ *        standard UTF-8.
+ *
+ * The decoder follows DataInput.readUTF: a 16-bit length, then one- to
+ * three-byte sequences; 10xxxxxx and 1111xxxx lead bytes are rejected, and
+ * the two-byte form C0 80 yields U+0000. Surrogate pairs (each encoded as a
+ * three-byte sequence) are combined into four-byte UTF-8; unpaired
+ * surrogates cannot be represented in UTF-8 and are rejected. The output is
+ * not NUL-terminated and never longer than the encoded form, so a
+ * JDATA_MAX_UTF byte buffer always fits.
+ *
+ * @param r         Reader.
+ * @param dst       Output buffer for UTF-8 text.
+ * @param dst_size  Size of the output buffer in bytes.
+ * @param length    Receives the number of bytes written.
+ * @return 0 on success, -1 on end of file, malformed input or insufficient space.
+ */
+int jdata_read_utf(jdata_reader_t* r, char* dst, size_t dst_size, size_t* length);
+
+/**
+ * @brief Writes UTF-8 text in the DataOutput.writeUTF format.
+ *
+ * U+0000 is written as C0 80 and supplementary characters as two
+ * three-byte surrogates.
+ *
+ * @param w    Writer.
+ * @param str  UTF-8 input text (may contain NUL bytes).
+ * @param len  Length of the input in bytes.
+ * @return 0 on success, -1 on invalid UTF-8, an encoded length above
+ *         JDATA_MAX_UTF, or write error.
+ */
+int jdata_write_utf(jdata_writer_t* w, const char* str, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JDATA_IO_H
@@ -0,0 +1,376 @@
+#include "msgpack_io.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Encoding
+// -----------------------------------------------------------------------------
+
+void msgpack_encoder_init(msgpack_encoder_t* enc, uint8_t* buffer, size_t size) {
+    enc->data = buffer;
+    enc->size = size;
+    enc->pos = 0;
+}
+
+// Reserves n bytes and returns a pointer to them, or NULL if they do not fit
+static inline uint8_t* reserve(msgpack_encoder_t* enc, size_t n) {
+    if (!enc || enc->size - enc->pos < n)
+        return NULL;
+    uint8_t* p = enc->data + enc->pos;
+    enc->pos += n;
+    return p;
+}
+
+// Writes a one-byte code followed by a 0/1/2/4/8-byte big-endian argument
+static int put_code(msgpack_encoder_t* enc, uint8_t code, uint64_t arg, size_t width) {
+    uint8_t* p = reserve(enc, 1 + width);
+    if (!p)
+        return -1;
+    p[0] = code;
+    switch (width) {
+        case 1: p[1] = (uint8_t)arg; break;
+        case 2: store_be16(p + 1, (uint16_t)arg); break;
+        case 4: store_be32(p + 1, (uint32_t)arg); break;
+        case 8: store_be64(p + 1, arg); break;
+    }
+    return 0;
+}
+
+int msgpack_encode_nil(msgpack_encoder_t* enc) {
+    return put_code(enc, 0xC0, 0, 0);
+}
+
+int msgpack_encode_bool(msgpack_encoder_t* enc, int value) {
+    return put_code(enc, value ? 0xC3 : 0xC2, 0, 0);
+}
+
+int msgpack_encode_uint(msgpack_encoder_t* enc, uint64_t value) {
+    if (value < 0x80)        return put_code(enc, (uint8_t)value, 0, 0);
+    if (value <= 0xFF)       return put_code(enc, 0xCC, value, 1);
+    if (value <= 0xFFFF)     return put_code(enc, 0xCD, value, 2);
+    if (value <= 0xFFFFFFFF) return put_code(enc, 0xCE, value, 4);
+    return put_code(enc, 0xCF, value, 8);
+}
+
+int msgpack_encode_int(msgpack_encoder_t* enc, int64_t value) {
+    if (value >= 0)
+        return msgpack_encode_uint(enc, (uint64_t)value);
+    if (value >= -32)        return put_code(enc, (uint8_t)value, 0, 0);
+    if (value >= INT8_MIN)   return put_code(enc, 0xD0, (uint64_t)value, 1);
+    if (value >= INT16_MIN)  return put_code(enc, 0xD1, (uint64_t)value, 2);
+    if (value >= INT32_MIN)  return put_code(enc, 0xD2, (uint64_t)value, 4);
+    return put_code(enc, 0xD3, (uint64_t)value, 8);
+}
+
+int msgpack_encode_float(msgpack_encoder_t* enc, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_code(enc, 0xCA, bits, 4);
+}
+
+int msgpack_encode_double(msgpack_encoder_t* enc, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_code(enc, 0xCB, bits, 8);
+}
+
+// Writes a length-prefixed payload; the code of the 8-bit length form comes
+// first in codes, followed by the 16- and 32-bit forms.
+static int put_payload(msgpack_encoder_t* enc, const uint8_t codes[3], uint8_t fix_base,
+                       size_t fix_limit, const void* data, size_t len) {
+    if (!enc || (!data && len > 0) || len > 0xFFFFFFFFu)
+        return -1;
+
+    const size_t start = enc->pos;
+    int status;
+    if (len < fix_limit)   status = put_code(enc, (uint8_t)(fix_base | len), 0, 0);
+    else if (len <= 0xFF)   status = put_code(enc, codes[0], len, 1);
+    else if (len <= 0xFFFF) status = put_code(enc, codes[1], len, 2);
+    else                    status = put_code(enc, codes[2], len, 4);
+
+    uint8_t* p = status == 0 ? reserve(enc, len) : NULL;
+    if (!p) {
+        enc->pos = start;
+        return -1;
+    }
+    if (len > 0)
+        memcpy(p, data, len);
+    return 0;
+}
+
+int msgpack_encode_str(msgpack_encoder_t* enc, const char* str, size_t len) {
+    static const uint8_t codes[3] = { 0xD9, 0xDA, 0xDB };
+    return put_payload(enc, codes, 0xA0, 32, str, len);
+}
+
+int msgpack_encode_bin(msgpack_encoder_t* enc, const uint8_t* data, size_t len) {
+    static const uint8_t codes[3] = { 0xC4, 0xC5, 0xC6 };
+    return put_payload(enc, codes, 0, 0, data, len);
+}
+
+int msgpack_encode_array(msgpack_encoder_t* enc, uint32_t count) {
+    if (count < 16)      return put_code(enc, (uint8_t)(0x90 | count), 0, 0);
+    if (count <= 0xFFFF) return put_code(enc, 0xDC, count, 2);
+    return put_code(enc, 0xDD, count, 4);
+}
+
+int msgpack_encode_map(msgpack_encoder_t* enc, uint32_t pairs) {
+    if (pairs < 16)      return put_code(enc, (uint8_t)(0x80 | pairs), 0, 0);
+    if (pairs <= 0xFFFF) return put_code(enc, 0xDE, pairs, 2);
+    return put_code(enc, 0xDF, pairs, 4);
+}
+
+int msgpack_encode_ext(msgpack_encoder_t* enc, int8_t type, const uint8_t* data, size_t len) {
+    if (!enc || (!data && len > 0) || len > 0xFFFFFFFFu)
+        return -1;
+
+    const size_t start = enc->pos;
+    int status;
+    switch (len) {
+        case 1:  status = put_code(enc, 0xD4, 0, 0); break;
+        case 2:  status = put_code(enc, 0xD5, 0, 0); break;
+        case 4:  status = put_code(enc, 0xD6, 0, 0); break;
+        case 8:  status = put_code(enc, 0xD7, 0, 0); break;
+        case 16: status = put_code(enc, 0xD8, 0, 0); break;
+        default:
+            status = len <= 0xFF   ? put_code(enc, 0xC7, len, 1)
+                   : len <= 0xFFFF ? put_code(enc, 0xC8, len, 2)
+                                   : put_code(enc, 0xC9, len, 4);
+    }
+
+    uint8_t* p = status == 0 ? reserve(enc, 1 + len) : NULL;
+    if (!p) {
+        enc->pos = start;
+        return -1;
+    }
+    p[0] = (uint8_t)type;
+    if (len > 0)
+        memcpy(p + 1, data, len);
+    return 0;
+}
+
+// Fixed-width float arrays: one capacity check, then a store loop
+#define DEFINE_MSGPACK_FLOAT_ARRAY(NAME, TYPE, CODE, BITS) \
+int msgpack_encode_##NAME##_array(msgpack_encoder_t* enc, const TYPE* arr, size_t count) { \
+    if (!enc || (!arr && count > 0) || count > 0xFFFFFFFFu) \
+        return -1; \
+    const size_t start = enc->pos; \
+    const size_t stride = 1 + BITS / 8; \
+    if (msgpack_encode_array(enc, (uint32_t)count) != 0) \
+        return -1; \
+    uint8_t* p = count <= (enc->size - enc->pos) / stride ? reserve(enc, count * stride) : NULL; \
+    if (!p) { \
+        enc->pos = start; \
+        return -1; \
+    } \
+    for (size_t i = 0; i < count; i++) { \
+        uint##BITS##_t bits; \
+        memcpy(&bits, &arr[i], sizeof(bits)); \
+        p[i * stride] = CODE; \
+        store_be##BITS(p + i * stride + 1, bits); \
+    } \
+    return 0; \
+}
+
+DEFINE_MSGPACK_FLOAT_ARRAY(float, float, 0xCA, 32)
+DEFINE_MSGPACK_FLOAT_ARRAY(double, double, 0xCB, 64)
+
+// -----------------------------------------------------------------------------
+// Decoding
+// -----------------------------------------------------------------------------
+
+void msgpack_decoder_init(msgpack_decoder_t* dec, const uint8_t* data, size_t size) {
+    dec->data = data;
+    dec->size = size;
+    dec->pos = 0;
+}
+
+static inline uint64_t load_arg(const uint8_t* p, size_t width) {
+    switch (width) {
+        case 1:  return p[0];
+        case 2:  return load_be16(p);
+        case 4:  return load_be32(p);
+        default: return load_be64(p);
+    }
+}
+
+int msgpack_decode_next(msgpack_decoder_t* dec, msgpack_item_t* item) {
+    if (!dec || !item || dec->pos >= dec->size)
+        return -1;
+
+    const uint8_t* p = dec->data + dec->pos;
+    const size_t avail = dec->size - dec->pos;
+    const uint8_t code = p[0];
+
+    item->value = 0;
+    item->integer = 0;
+    item->number = 0.0;
+    item->data = NULL;
+    item->ext_type = 0;
+
+    // Fixed forms carry their argument in the code byte
+    if (code < 0x80) {
+        item->type = MSGPACK_UINT;
+        item->value = code;
+        dec->pos += 1;
+        return 0;
+    }
+    if (code >= 0xE0) {
+        item->type = MSGPACK_INT;
+        item->integer = (int8_t)code;
+        dec->pos += 1;
+        return 0;
+    }
+
+    size_t width = 0;           // bytes of the argument after the code
+    size_t payload = 0;         // bytes of data after the argument
+    int has_payload = 0;
+    int ext = 0;
+
+    if (code <= 0x8F) {
+        item->type = MSGPACK_MAP;
+        item->value = code & 0x0F;
+    } else if (code <= 0x9F) {
+        item->type = MSGPACK_ARRAY;
+        item->value = code & 0x0F;
+    } else if (code <= 0xBF) {
+        item->type = MSGPACK_STR;
+        payload = code & 0x1F;
+        has_payload = 1;
+    } else {
+        switch (code) {
+            case 0xC0: item->type = MSGPACK_NIL; break;
+            case 0xC2:
+            case 0xC3: item->type = MSGPACK_BOOL; item->value = code - 0xC2; break;
+            case 0xC4: case 0xC5: case 0xC6:
+                item->type = MSGPACK_BIN; width = (size_t)1 << (code - 0xC4); has_payload = 1; break;
+            case 0xC7: case 0xC8: case 0xC9:
+                item->type = MSGPACK_EXT; width = (size_t)1 << (code - 0xC7); has_payload = ext = 1; break;
+            case 0xCA: item->type = MSGPACK_FLOAT; width = 4; break;
+            case 0xCB: item->type = MSGPACK_FLOAT; width = 8; break;
+            case 0xCC: case 0xCD: case 0xCE: case 0xCF:
+                item->type = MSGPACK_UINT; width = (size_t)1 << (code - 0xCC); break;
+            case 0xD0: case 0xD1: case 0xD2: case 0xD3:
+                item->type = MSGPACK_INT; width = (size_t)1 << (code - 0xD0); break;
+            case 0xD4: case 0xD5: case 0xD6: case 0xD7: case 0xD8:
+                item->type = MSGPACK_EXT; payload = (size_t)1 << (code - 0xD4); has_payload = ext = 1; break;
+            case 0xD9: case 0xDA: case 0xDB:
+                item->type = MSGPACK_STR; width = (size_t)1 << (code - 0xD9); has_payload = 1; break;
+            case 0xDC: case 0xDD:
+                item->type = MSGPACK_ARRAY; width = code == 0xDC ? 2 : 4; break;
+            case 0xDE: case 0xDF:
+                item->type = MSGPACK_MAP; width = code == 0xDE ? 2 : 4; break;
+            default:
+                return -1;      // 0xC1 is never used
+        }
+    }
+
+    if (avail - 1 < width)
+        return -1;
+    const uint64_t arg = width ? load_arg(p + 1, width) : 0;
+    size_t n = 1 + width;
+
+    switch (item->type) {
+        case MSGPACK_FLOAT:
+            if (width == 4) {
+                const uint32_t bits = (uint32_t)arg;
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                item->number = f;
+            } else {
+                memcpy(&item->number, &arg, sizeof(arg));
+            }
+            break;
+        case MSGPACK_INT:
+            // Sign-extend from the argument width
+            item->integer = width == 1 ? (int8_t)arg : width == 2 ? (int16_t)arg
+                          : width == 4 ? (int32_t)arg : (int64_t)arg;
+            break;
+        case MSGPACK_UINT:
+        case MSGPACK_ARRAY:
+        case MSGPACK_MAP:
+            if (width)
+                item->value = arg;
+            break;
+        default:
+            break;
+    }
+
+    if (has_payload) {
+        if (width)
+            payload = (size_t)arg;
+        if (avail - n < (size_t)ext || avail - n - ext < payload)
+            return -1;
+        if (ext)
+            item->ext_type = (int8_t)p[n];
+        item->data = p + n + ext;
+        item->value = payload;
+        n += ext + payload;
+    }
+
+    dec->pos += n;
+    return 0;
+}
+
+int msgpack_skip(msgpack_decoder_t* dec) {
+    if (!dec)
+        return -1;
+
+    // Containers only add to the number of objects still to be consumed
+    const size_t start = dec->pos;
+    uint64_t remaining = 1;
+    while (remaining > 0) {
+        msgpack_item_t item;
+        if (msgpack_decode_next(dec, &item) != 0) {
+            dec->pos = start;
+            return -1;
+        }
+        remaining--;
+        if (item.type == MSGPACK_ARRAY)
+            remaining += item.value;
+        else if (item.type == MSGPACK_MAP)
+            remaining += 2 * item.value;
+    }
+    return 0;
+}
+
+int msgpack_decode_double_array(msgpack_decoder_t* dec, double* out, size_t capacity,
+                                size_t* count) {
+    if (!dec || !count || (!out && capacity > 0))
+        return -1;
+
+    const size_t start = dec->pos;
+    msgpack_item_t item;
+    if (msgpack_decode_next(dec, &item) != 0 || item.type != MSGPACK_ARRAY ||
+        item.value > capacity) {
+        dec->pos = start;
+        return -1;
+    }
+
+    const size_t n = (size_t)item.value;
+    for (size_t i = 0; i < n; i++) {
+        // float64 elements are decoded inline
+        const uint8_t* p = dec->data + dec->pos;
+        if (dec->size - dec->pos >= 9 && p[0] == 0xCB) {
+            const uint64_t bits = load_be64(p + 1);
+            memcpy(&out[i], &bits, sizeof(bits));
+            dec->pos += 9;
+            continue;
+        }
+
+        if (msgpack_decode_next(dec, &item) != 0) {
+            dec->pos = start;
+            return -1;
+        }
+        switch (item.type) {
+            case MSGPACK_FLOAT: out[i] = item.number; break;
+            case MSGPACK_UINT:  out[i] = (double)item.value; break;
+            case MSGPACK_INT:   out[i] = (double)item.integer; break;
+            default:
+                dec->pos = start;
+                return -1;
+        }
+    }
+
+    *count = n;
+    return 0;
+}
@@ -0,0 +1,131 @@
+#ifndef MSGPACK_IO_H
+#define MSGPACK_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Kind of a decoded MessagePack object.
+typedef enum {
+    MSGPACK_NIL,
+    MSGPACK_BOOL,       ///< value is 0 or 1
+    MSGPACK_UINT,       ///< value holds the integer
+    MSGPACK_INT,        ///< integer holds a negative integer
+    MSGPACK_FLOAT,      ///< number holds a float32 or float64 value
+    MSGPACK_STR,        ///< value UTF-8 bytes at data
+    MSGPACK_BIN,        ///< value bytes at data
+    MSGPACK_ARRAY,      ///< value objects follow
+    MSGPACK_MAP,        ///< value key/value pairs follow
+    MSGPACK_EXT         ///< value bytes of extension ext_type at data
+} msgpack_type_t;
+
+/// Header of one object; payloads point into the input buffer.
+typedef struct {
+    msgpack_type_t type;
+    uint64_t value;
+    int64_t integer;
+    double number;
+    const uint8_t* data;
+    int8_t ext_type;
+} msgpack_item_t;
+
+/// Encoder writing into a caller-provided buffer.
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t pos;     ///< Bytes written so far
+} msgpack_encoder_t;
+
+/// Pull decoder reading from a caller-provided buffer.
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;     ///< Bytes consumed so far
+} msgpack_decoder_t;
+
+// -----------------------------------------------------------------------------
+// Encoding
+// -----------------------------------------------------------------------------
+
+// Each encoder uses the shortest form, returns 0 on success and -1 if the
+// object does not fit; a failed call leaves the encoder unchanged.
+
+void msgpack_encoder_init(msgpack_encoder_t* enc, uint8_t* buffer, size_t size);
+
+int msgpack_encode_nil(msgpack_encoder_t* enc);
+int msgpack_encode_bool(msgpack_encoder_t* enc, int value);
+int msgpack_encode_uint(msgpack_encoder_t* enc, uint64_t value);
+int msgpack_encode_int(msgpack_encoder_t* enc, int64_t value);
+int msgpack_encode_float(msgpack_encoder_t* enc, float value);
+int msgpack_encode_double(msgpack_encoder_t* enc, double value);
+int msgpack_encode_str(msgpack_encoder_t* enc, const char* str, size_t len);
+int msgpack_encode_bin(msgpack_encoder_t* enc, const uint8_t* data, size_t len);
+int msgpack_encode_array(msgpack_encoder_t* enc, uint32_t count);
+int msgpack_encode_map(msgpack_encoder_t* enc, uint32_t pairs);
+int msgpack_encode_ext(msgpack_encoder_t* enc, int8_t type, const uint8_t* data, size_t len);
+
+/**
+ * @brief Encodes an array of float64 objects.
+ *
+ * Every element has the same 9-byte form, so the array is emitted in one
+ * tight loop after a single capacity check.
+ *
+ * @param enc    Encoder.
+ * @param arr    Values to encode.
+ * @param count  Number of values (at most UINT32_MAX).
+ * @return 0 on success, -1 if the array does not fit.
+ */
+int msgpack_encode_double_array(msgpack_encoder_t* enc, const double* arr, size_t count);
+
+/// float32 counterpart of msgpack_encode_double_array().
+int msgpack_encode_float_array(msgpack_encoder_t* enc, const float* arr, size_t count);
+
+// -----------------------------------------------------------------------------
+// Decoding
+// -----------------------------------------------------------------------------
+
+void msgpack_decoder_init(msgpack_decoder_t* dec, const uint8_t* data, size_t size);
+
+/**
+ * @brief Decodes the next object header.
+ *
+ * Arrays and maps return only their header; the enclosed objects are
+ * returned by subsequent calls. Strings, binaries and extensions are
+ * consumed whole and returned as a pointer into the input.
+ *
+ * @param dec   Decoder.
+ * @param item  Receives the object.
+ * @return 0 on success, -1 on truncated or malformed input.
+ */
+int msgpack_decode_next(msgpack_decoder_t* dec, msgpack_item_t* item);
+
+/**
+ * @brief Skips the next complete object, including nested objects.
+ *
+ * @return 0 on success, -1 on truncated or malformed input.
+ */
+int msgpack_skip(msgpack_decoder_t* dec);
+
+/**
+ * @brief Decodes an array of numbers into doubles.
+ *
+ * Elements may be any integer or float form; runs of float64 elements are
+ * decoded on a fast path.
+ *
+ * @param dec       Decoder.
+ * @param out       Output array.
+ * @param capacity  Number of elements out can hold.
+ * @param count     Receives the number of elements.
+ * @return 0 on success, -1 on malformed input, non-numeric elements or
+ *         insufficient space.
+ */
+int msgpack_decode_double_array(msgpack_decoder_t* dec, double* out, size_t capacity,
+                                size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MSGPACK_IO_H
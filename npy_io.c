@@ -0,0 +1,296 @@
+#include "npy_io.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_SIZE 6
+#define NPY_PREFIX_SIZE 8   // magic + major + minor version
+#define NPY_ALIGNMENT 64
+#define NPY_MAX_HEADER_TEXT (1u << 20)
+
+static inline int host_is_big_endian(void) {
+    uint16_t x = 1;
+    return *((uint8_t*)&x) == 0;
+}
+
+// Complex numbers are swapped as two independent floats
+static inline size_t swap_unit(const npy_header_t* hdr) {
+    return hdr->kind == 'c' ? hdr->item_size / 2 : hdr->item_size;
+}
+
+static inline size_t unit_count(const npy_header_t* hdr) {
+    return npy_count(hdr) * (hdr->item_size / swap_unit(hdr));
+}
+
+// Product of the shape, or SIZE_MAX if it does not fit
+static size_t shape_product(const size_t* shape, size_t ndim) {
+    for (size_t i = 0; i < ndim; i++)
+        if (shape[i] == 0)
+            return 0;
+    size_t count = 1;
+    for (size_t i = 0; i < ndim; i++) {
+        if (count > SIZE_MAX / shape[i])
+            return SIZE_MAX;
+        count *= shape[i];
+    }
+    return count;
+}
+
+size_t npy_count(const npy_header_t* hdr) {
+    return shape_product(hdr->shape, hdr->ndim);
+}
+
+// -----------------------------------------------------------------------------
+// Header Parsing
+// -----------------------------------------------------------------------------
+
+// Returns a pointer to the value of 'key' in the header dict, or NULL.
+static const char* find_value(const char* text, const char* end, const char* key) {
+    const size_t key_len = strlen(key);
+
+    for (const char* p = text; p + key_len + 2 <= end; p++) {
+        if ((*p != '\'' && *p != '"') || memcmp(p + 1, key, key_len) != 0 ||
+            p[key_len + 1] != *p)
+            continue;
+        p += key_len + 2;
+        while (p < end && (*p == ' ' || *p == ':'))
+            p++;
+        return p < end ? p : NULL;
+    }
+    return NULL;
+}
+
+// Parses a run of decimal digits, failing if the value does not fit in size_t
+static int parse_size(const char** p, const char* end, size_t* value) {
+    size_t n = 0;
+    for (; *p < end && **p >= '0' && **p <= '9'; (*p)++) {
+        const size_t digit = (size_t)(**p - '0');
+        if (n > (SIZE_MAX - digit) / 10)
+            return -1;
+        n = n * 10 + digit;
+    }
+    *value = n;
+    return 0;
+}
+
+static int parse_descr(const char* p, const char* end, npy_header_t* hdr) {
+    if (p >= end || (*p != '\'' && *p != '"'))
+        return -1;
+    const char quote = *p++;
+
+    if (end - p < 3)
+        return -1;
+    switch (*p++) {
+        case '<': hdr->big_endian = 0; break;
+        case '>': hdr->big_endian = 1; break;
+        case '|':
+        case '=': hdr->big_endian = host_is_big_endian(); break;
+        default: return -1;
+    }
+
+    hdr->kind = *p++;
+    if (hdr->kind == '\0' || !strchr("biufc", hdr->kind))
+        return -1;
+
+    size_t size = 0;
+    if (parse_size(&p, end, &size) != 0)
+        return -1;
+    if (p >= end || *p != quote || size == 0)
+        return -1;
+    if (hdr->kind == 'c' && size % 2 != 0)
+        return -1;
+
+    hdr->item_size = size;
+    return 0;
+}
+
+static int parse_shape(const char* p, const char* end, npy_header_t* hdr) {
+    if (p >= end || *p++ != '(')
+        return -1;
+
+    hdr->ndim = 0;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == ','))
+            p++;
+        if (p < end && *p == ')')
+            return 0;
+        if (p >= end || *p < '0' || *p > '9' || hdr->ndim == NPY_MAX_DIMS)
+            return -1;
+
+        size_t dim = 0;
+        if (parse_size(&p, end, &dim) != 0)
+            return -1;
+        if (p < end && *p == 'L')
+            p++;
+        hdr->shape[hdr->ndim++] = dim;
+    }
+    return -1;
+}
+
+int npy_parse_header(const uint8_t* data, size_t size, npy_header_t* hdr) {
+    if (!data || !hdr || size < NPY_PREFIX_SIZE + 2)
+        return -1;
+    if (memcmp(data, NPY_MAGIC, NPY_MAGIC_SIZE) != 0)
+        return -1;
+
+    // Version 1.x uses a 2-byte header length, 2.x and 3.x a 4-byte one
+    const uint8_t major = data[NPY_MAGIC_SIZE];
+    size_t start, text_len;
+    if (major == 1) {
+        start = NPY_PREFIX_SIZE + 2;
+        text_len = load_le16(data + NPY_PREFIX_SIZE);
+    } else if (major == 2 || major == 3) {
+        if (size < NPY_PREFIX_SIZE + 4)
+            return -1;
+        start = NPY_PREFIX_SIZE + 4;
+        text_len = load_le32(data + NPY_PREFIX_SIZE);
+    } else {
+        return -1;
+    }
+    if (size - start < text_len)
+        return -1;
+
+    const char* text = (const char*)data + start;
+    const char* end = text + text_len;
+    const char* value;
+
+    if (!(value = find_value(text, end, "descr")) || parse_descr(value, end, hdr) != 0)
+        return -1;
+    if (!(value = find_value(text, end, "fortran_order")))
+        return -1;
+    if (end - value >= 4 && memcmp(value, "True", 4) == 0)
+        hdr->fortran_order = 1;
+    else if (end - value >= 5 && memcmp(value, "False", 5) == 0)
+        hdr->fortran_order = 0;
+    else
+        return -1;
+    if (!(value = find_value(text, end, "shape")) || parse_shape(value, end, hdr) != 0)
+        return -1;
+
+    // The payload size must be representable, or the bounds checks could wrap
+    const size_t count = npy_count(hdr);
+    if (count == SIZE_MAX || (count != 0 && hdr->item_size > SIZE_MAX / count))
+        return -1;
+
+    hdr->header_size = start + text_len;
+    return 0;
+}
+
+int npy_read_header(FILE* file, npy_header_t* hdr) {
+    if (!file || !hdr)
+        return -1;
+
+    uint8_t prefix[NPY_PREFIX_SIZE + 4];
+    if (fread(prefix, 1, NPY_PREFIX_SIZE + 2, file) != NPY_PREFIX_SIZE + 2)
+        return -1;
+
+    size_t start = NPY_PREFIX_SIZE + 2;
+    size_t text_len = load_le16(prefix + NPY_PREFIX_SIZE);
+    if (prefix[NPY_MAGIC_SIZE] == 2 || prefix[NPY_MAGIC_SIZE] == 3) {
+        if (fread(prefix + start, 1, 2, file) != 2)
+            return -1;
+        start += 2;
+        text_len = load_le32(prefix + NPY_PREFIX_SIZE);
+    }
+    if (text_len > NPY_MAX_HEADER_TEXT)
+        return -1;
+
+    uint8_t* header = (uint8_t*)malloc(start + text_len);
+    if (!header)
+        return -1;
+    memcpy(header, prefix, start);
+
+    int status = -1;
+    if (fread(header + start, 1, text_len, file) == text_len)
+        status = npy_parse_header(header, start + text_len, hdr);
+
+    free(header);
+    return status;
+}
+
+// -----------------------------------------------------------------------------
+// Payload I/O
+// -----------------------------------------------------------------------------
+
+int npy_read(FILE* file, const npy_header_t* hdr, void* data) {
+    if (!file || !hdr || !data)
+        return -1;
+
+    const size_t units = unit_count(hdr);
+    if (units == 0)
+        return 0;
+
+    return hdr->big_endian ? read_be(file, (uint8_t*)data, units, swap_unit(hdr))
+                           : read_le(file, (uint8_t*)data, units, swap_unit(hdr));
+}
+
+int npy_view(const uint8_t* data, size_t size, npy_header_t* hdr,
+             const void** payload, void* scratch) {
+    if (!payload || npy_parse_header(data, size, hdr) != 0)
+        return -1;
+
+    // Cannot wrap: npy_parse_header() rejected oversized payloads
+    const size_t bytes = npy_count(hdr) * hdr->item_size;
+    if (size - hdr->header_size < bytes)
+        return -1;
+
+    const uint8_t* raw = data + hdr->header_size;
+    if (hdr->big_endian == host_is_big_endian() || swap_unit(hdr) == 1) {
+        *payload = raw;
+        return 0;
+    }
+
+    if (!scratch)
+        return -1;
+    memcpy(scratch, raw, bytes);
+    if (hdr->big_endian)
+        convert_be((uint8_t*)scratch, unit_count(hdr), swap_unit(hdr));
+    else
+        convert_le((uint8_t*)scratch, unit_count(hdr), swap_unit(hdr));
+    *payload = scratch;
+    return 0;
+}
+
+int npy_write(FILE* file, const void* data, char kind, size_t item_size,
+              const size_t* shape, size_t ndim, int fortran_order) {
+    if (!file || item_size == 0 || ndim > NPY_MAX_DIMS || (!shape && ndim > 0))
+        return -1;
+    if (kind == '\0' || !strchr("biufc", kind) || (kind == 'c' && item_size % 2 != 0))
+        return -1;
+    const size_t count = shape_product(shape, ndim);
+    if (count == SIZE_MAX || (count != 0 && item_size > SIZE_MAX / count))
+        return -1;
+
+    const char order = item_size == 1 ? '|' : host_is_big_endian() ? '>' : '<';
+    char text[128 + NPY_MAX_DIMS * 24];
+    int len = snprintf(text, sizeof(text), "{'descr': '%c%c%zu', 'fortran_order': %s, 'shape': (",
+                       order, kind, item_size, fortran_order ? "True" : "False");
+    for (size_t i = 0; i < ndim; i++)
+        len += snprintf(text + len, sizeof(text) - (size_t)len, ndim == 1 ? "%zu," : i ? ", %zu" : "%zu",
+                        shape[i]);
+    len += snprintf(text + len, sizeof(text) - (size_t)len, "), }");
+
+    // Pad with spaces and a newline so the payload starts 64-byte aligned
+    const size_t prefix = NPY_PREFIX_SIZE + 2;
+    const size_t total = (prefix + (size_t)len + 1 + NPY_ALIGNMENT - 1) / NPY_ALIGNMENT * NPY_ALIGNMENT;
+    const size_t text_len = total - prefix;
+    memset(text + len, ' ', text_len - (size_t)len - 1);
+    text[text_len - 1] = '\n';
+
+    uint8_t head[NPY_PREFIX_SIZE + 2];
+    memcpy(head, NPY_MAGIC, NPY_MAGIC_SIZE);
+    head[NPY_MAGIC_SIZE] = 1;
+    head[NPY_MAGIC_SIZE + 1] = 0;
+    store_le16(head + NPY_PREFIX_SIZE, (uint16_t)text_len);
+    if (fwrite(head, 1, sizeof(head), file) != sizeof(head) ||
+        fwrite(text, 1, text_len, file) != text_len)
+        return -1;
+
+    if (count == 0)
+        return 0;
+    if (!data)
+        return -1;
+
+    // Host order needs no conversion
+    return fwrite(data, item_size, count, file) == count ? 0 : -1;
+}
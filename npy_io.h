@@ -0,0 +1,99 @@
+#ifndef NPY_IO_H
+#define NPY_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NPY_MAX_DIMS 32
+
+/// Parsed header of a NumPy .npy file.
+typedef struct {
+    char kind;              ///< dtype kind: 'b', 'i', 'u', 'f' or 'c'
+    size_t item_size;       ///< Size of one element in bytes
+    int big_endian;         ///< 1 if the payload is big-endian ('>')
+    int fortran_order;      ///< 1 if the array is stored column-major
+    size_t ndim;            ///< Number of dimensions
+    size_t shape[NPY_MAX_DIMS];
+    size_t header_size;     ///< Offset of the payload from the start of the file
+} npy_header_t;
+
+/**
+ * @brief Returns the number of elements described by a header.
+ *
+ * @param hdr  Parsed header.
+ * @return Product of the shape (1 for a 0-d array), or SIZE_MAX if it
+ *         overflows; npy_parse_header() rejects such headers.
+ */
+size_t npy_count(const npy_header_t* hdr);
+
+/**
+ * @brief Parses a .npy header from memory.
+ *
+ * @param data  Start of the file contents.
+ * @param size  Number of bytes available.
+ * @param hdr   Receives the parsed header.
+ * @return 0 on success, -1 if the header is malformed or unsupported.
+ */
+int npy_parse_header(const uint8_t* data, size_t size, npy_header_t* hdr);
+
+/**
+ * @brief Reads and parses a .npy header, leaving the file at the payload.
+ *
+ * @param file  Open binary file for reading, positioned at the magic string.
+ * @param hdr   Receives the parsed header.
+ * @return 0 on success, -1 on error.
+ */
+int npy_read_header(FILE* file, npy_header_t* hdr);
+
+/**
+ * @brief Reads the payload that follows a header into host byte order.
+ *
+ * @param file  Open binary file positioned at the payload.
+ * @param hdr   Header returned by npy_read_header().
+ * @param data  Output buffer of npy_count(hdr) * hdr->item_size bytes.
+ * @return 0 on success, -1 on error.
+ */
+int npy_read(FILE* file, const npy_header_t* hdr, void* data);
+
+/**
+ * @brief Gives access to the payload of a .npy file held in memory.
+ *
+ * When the file byte order matches the host, the returned payload points
+ * into data (zero-copy, e.g. into an mmapped file). Otherwise the payload is
+ * converted into scratch, which must then hold the whole array.
+ *
+ * @param data     Start of the file contents.
+ * @param size     Number of bytes available.
+ * @param hdr      Receives the parsed header.
+ * @param payload  Receives a pointer to the host-order elements.
+ * @param scratch  Conversion buffer, or NULL to allow zero-copy only.
+ * @return 0 on success, -1 on error or if conversion is needed without scratch.
+ */
+int npy_view(const uint8_t* data, size_t size, npy_header_t* hdr,
+             const void** payload, void* scratch);
+
+/**
+ * @brief Writes an array as a version 1.0 .npy file in host byte order.
+ *
+ * Host order needs no conversion and is read by NumPy on any platform.
+ *
+ * @param file           Open binary file for writing.
+ * @param data           Array elements in host order.
+ * @param kind           dtype kind: 'b', 'i', 'u', 'f' or 'c'.
+ * @param item_size      Size of one element in bytes.
+ * @param shape          Array of ndim dimensions.
+ * @param ndim           Number of dimensions (0 to NPY_MAX_DIMS).
+ * @param fortran_order  1 if data is stored column-major.
+ * @return 0 on success, -1 on error.
+ */
+int npy_write(FILE* file, const void* data, char kind, size_t item_size,
+              const size_t* shape, size_t ndim, int fortran_order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NPY_IO_H
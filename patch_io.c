@@ -0,0 +1,270 @@
+#include "patch_io.h"
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#define PATCH_BUFFER_SIZE 65536
+
+// -----------------------------------------------------------------------------
+// Queue
+// -----------------------------------------------------------------------------
+
+void patch_set_init(patch_set_t* ps) {
+    if (ps)
+        memset(ps, 0, sizeof(*ps));
+}
+
+void patch_set_free(patch_set_t* ps) {
+    if (!ps)
+        return;
+    free(ps->entries);
+    free(ps->fixups);
+    memset(ps, 0, sizeof(*ps));
+}
+
+void patch_set_clear(patch_set_t* ps) {
+    if (!ps)
+        return;
+    ps->count = 0;
+    ps->num_fixups = 0;
+}
+
+// Grows an array to hold one more element
+static int reserve(void** items, size_t* capacity, size_t count, size_t item_size) {
+    if (count < *capacity)
+        return 0;
+    const size_t grown = *capacity ? *capacity * 2 : 64;
+    void* resized = realloc(*items, grown * item_size);
+    if (!resized)
+        return -1;
+    *items = resized;
+    *capacity = grown;
+    return 0;
+}
+
+int patch_set_add(patch_set_t* ps, uint64_t offset, uint64_t value, size_t size,
+                  int big_endian) {
+    if (!ps || (size != 1 && size != 2 && size != 4 && size != 8) ||
+        offset > UINT64_MAX - size)
+        return -1;
+    if (reserve((void**)&ps->entries, &ps->capacity, ps->count, sizeof(patch_entry_t)) != 0)
+        return -1;
+
+    patch_entry_t* e = &ps->entries[ps->count];
+    e->offset = offset;
+    e->value = value;
+    e->seq = ps->count;
+    e->size = (uint8_t)size;
+    e->big_endian = big_endian != 0;
+    ps->count++;
+    return 0;
+}
+
+int patch_set_add_float(patch_set_t* ps, uint64_t offset, float value, int big_endian) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return patch_set_add(ps, offset, bits, 4, big_endian);
+}
+
+int patch_set_add_double(patch_set_t* ps, uint64_t offset, double value, int big_endian) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return patch_set_add(ps, offset, bits, 8, big_endian);
+}
+
+int patch_set_add_checksum(patch_set_t* ps, uint64_t field_offset, int big_endian,
+                           uint64_t start, uint64_t length, patch_checksum_fn fn,
+                           uint32_t init) {
+    if (!ps || !fn || field_offset > UINT64_MAX - 4 || start > UINT64_MAX - length)
+        return -1;
+    if (reserve((void**)&ps->fixups, &ps->fixup_capacity, ps->num_fixups,
+                sizeof(patch_fixup_t)) != 0)
+        return -1;
+
+    patch_fixup_t* f = &ps->fixups[ps->num_fixups++];
+    f->field_offset = field_offset;
+    f->start = start;
+    f->length = length;
+    f->fn = fn;
+    f->init = init;
+    f->big_endian = big_endian != 0;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Ordering and Checksums
+// -----------------------------------------------------------------------------
+
+static int compare_offset(const void* a, const void* b) {
+    const patch_entry_t* x = (const patch_entry_t*)a;
+    const patch_entry_t* y = (const patch_entry_t*)b;
+    if (x->offset != y->offset)
+        return x->offset < y->offset ? -1 : 1;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+static int compare_seq(const void* a, const void* b) {
+    const patch_entry_t* x = (const patch_entry_t*)a;
+    const patch_entry_t* y = (const patch_entry_t*)b;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+uint32_t patch_crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    // Nibble table for the reflected polynomial 0xEDB88320
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+// -----------------------------------------------------------------------------
+// File Application
+// -----------------------------------------------------------------------------
+
+static int seek_to(FILE* file, uint64_t offset) {
+    if (offset > (uint64_t)LONG_MAX)
+        return -1;
+    return fseek(file, (long)offset, SEEK_SET);
+}
+
+static int apply_fixup_file(const patch_fixup_t* f, FILE* file, uint8_t* buffer) {
+    uint32_t state = f->init;
+    if (seek_to(file, f->start) != 0)
+        return -1;
+    for (uint64_t done = 0; done < f->length; ) {
+        const size_t chunk = f->length - done < PATCH_BUFFER_SIZE ?
+                             (size_t)(f->length - done) : PATCH_BUFFER_SIZE;
+        if (fread(buffer, 1, chunk, file) != chunk)
+            return -1;
+        state = f->fn(state, buffer, chunk);
+        done += chunk;
+    }
+
+    uint8_t field[4];
+    store_sized(field, state, 4, f->big_endian);
+    if (seek_to(file, f->field_offset) != 0 || fwrite(field, 1, 4, file) != 4)
+        return -1;
+    return 0;
+}
+
+int patch_set_apply(patch_set_t* ps, FILE* file, size_t* writes) {
+    if (!ps || !file)
+        return -1;
+
+    size_t calls = 0;
+    uint8_t* run = NULL;
+    size_t run_capacity = 0;
+    uint8_t* buffer = NULL;
+
+    // entries is NULL until the first field is queued, and qsort needs a valid base
+    if (ps->count > 0)
+        qsort(ps->entries, ps->count, sizeof(patch_entry_t), compare_offset);
+
+    for (size_t i = 0; i < ps->count; ) {
+        // Extend the run over every field touching it
+        const uint64_t start = ps->entries[i].offset;
+        uint64_t end = start + ps->entries[i].size;
+        size_t j = i + 1;
+        while (j < ps->count && ps->entries[j].offset <= end) {
+            const uint64_t field_end = ps->entries[j].offset + ps->entries[j].size;
+            end = field_end > end ? field_end : end;
+            j++;
+        }
+        if (end - start > SIZE_MAX)
+            goto fail;
+
+        const size_t length = (size_t)(end - start);
+        if (length > run_capacity) {
+            uint8_t* resized = (uint8_t*)realloc(run, length);
+            if (!resized)
+                goto fail;
+            run = resized;
+            run_capacity = length;
+        }
+
+        // Overlapping fields: the later update wins
+        qsort(ps->entries + i, j - i, sizeof(patch_entry_t), compare_seq);
+        for (size_t k = i; k < j; k++) {
+            const patch_entry_t* e = &ps->entries[k];
+            store_sized(run + (e->offset - start), e->value, e->size, e->big_endian);
+        }
+
+        if (seek_to(file, start) != 0 || fwrite(run, 1, length, file) != length)
+            goto fail;
+        calls++;
+        i = j;
+    }
+
+    if (ps->num_fixups > 0) {
+        buffer = (uint8_t*)malloc(PATCH_BUFFER_SIZE);
+        if (!buffer)
+            goto fail;
+        for (size_t i = 0; i < ps->num_fixups; i++) {
+            if (apply_fixup_file(&ps->fixups[i], file, buffer) != 0)
+                goto fail;
+            calls++;
+        }
+    }
+
+    free(run);
+    free(buffer);
+    if (writes)
+        *writes = calls;
+    return fflush(file) == 0 ? 0 : -1;
+
+fail:
+    free(run);
+    free(buffer);
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+// Memory Application
+// -----------------------------------------------------------------------------
+
+static inline int in_bounds(uint64_t offset, uint64_t length, size_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+int patch_set_apply_mem(const patch_set_t* ps, uint8_t* data, size_t size) {
+    if (!ps || (!data && size))
+        return -1;
+
+    for (size_t i = 0; i < ps->count; i++)
+        if (!in_bounds(ps->entries[i].offset, ps->entries[i].size, size))
+            return -1;
+    for (size_t i = 0; i < ps->num_fixups; i++)
+        if (!in_bounds(ps->fixups[i].field_offset, 4, size) ||
+            !in_bounds(ps->fixups[i].start, ps->fixups[i].length, size))
+            return -1;
+
+    // Stores in queue order, so the later update wins on overlap
+    if (ps->count > 0) {
+        size_t* order = (size_t*)malloc(ps->count * sizeof(size_t));
+        if (!order)
+            return -1;
+        for (size_t i = 0; i < ps->count; i++)
+            order[ps->entries[i].seq] = i;
+        for (size_t i = 0; i < ps->count; i++) {
+            const patch_entry_t* e = &ps->entries[order[i]];
+            store_sized(data + e->offset, e->value, e->size, e->big_endian);
+        }
+        free(order);
+    }
+
+    for (size_t i = 0; i < ps->num_fixups; i++) {
+        const patch_fixup_t* f = &ps->fixups[i];
+        const uint32_t sum = f->fn(f->init, data + f->start, (size_t)f->length);
+        store_sized(data + f->field_offset, sum, 4, f->big_endian);
+    }
+    return 0;
+}
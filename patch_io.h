@@ -0,0 +1,131 @@
+#ifndef PATCH_IO_H
+#define PATCH_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Incremental checksum used by checksum fixups.
+ *
+ * Called repeatedly over consecutive pieces of the checksummed range, starting
+ * from the initial state; the final return value is stored in the field.
+ */
+typedef uint32_t (*patch_checksum_fn)(uint32_t state, const uint8_t* data, size_t len);
+
+/// One queued field update.
+typedef struct {
+    uint64_t offset;
+    uint64_t value;     ///< Host-order value; the low size bytes are stored
+    size_t seq;         ///< Queue position, so later updates win on overlap
+    uint8_t size;       ///< 1, 2, 4 or 8
+    uint8_t big_endian;
+} patch_entry_t;
+
+/// Checksum recomputed over a range after the updates are applied.
+typedef struct {
+    uint64_t field_offset;  ///< Location of the 32-bit checksum field
+    uint64_t start;         ///< Start of the checksummed range
+    uint64_t length;        ///< Length of the checksummed range
+    patch_checksum_fn fn;
+    uint32_t init;
+    int big_endian;         ///< Byte order of the checksum field
+} patch_fixup_t;
+
+/// Set of pending field updates.
+typedef struct {
+    patch_entry_t* entries;
+    size_t count;
+    size_t capacity;
+    patch_fixup_t* fixups;
+    size_t num_fixups;
+    size_t fixup_capacity;
+} patch_set_t;
+
+void patch_set_init(patch_set_t* ps);
+
+/// Releases the queue; the set can be reused after patch_set_init().
+void patch_set_free(patch_set_t* ps);
+
+/// Drops all queued updates and fixups, keeping the allocations.
+void patch_set_clear(patch_set_t* ps);
+
+/**
+ * @brief Queues an integer field update.
+ *
+ * Updates are applied in queue order where they overlap.
+ *
+ * @param ps          Patch set.
+ * @param offset      Byte offset of the field.
+ * @param value       New value in host order (truncated to size bytes).
+ * @param size        Field size: 1, 2, 4 or 8 bytes.
+ * @param big_endian  1 to store the field big-endian, 0 for little-endian.
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int patch_set_add(patch_set_t* ps, uint64_t offset, uint64_t value, size_t size,
+                  int big_endian);
+
+/// Queues a float32 field update.
+int patch_set_add_float(patch_set_t* ps, uint64_t offset, float value, int big_endian);
+
+/// Queues a float64 field update.
+int patch_set_add_double(patch_set_t* ps, uint64_t offset, double value, int big_endian);
+
+/**
+ * @brief Queues a 32-bit checksum fixup.
+ *
+ * After all updates are applied, fn is run over [start, start + length) and
+ * the result is stored at field_offset. Fixups run in the order added, so a
+ * checksum covering another checksum field should be added last.
+ *
+ * @param ps            Patch set.
+ * @param field_offset  Offset of the 32-bit checksum field.
+ * @param big_endian    1 to store the checksum big-endian, 0 for little-endian.
+ * @param start         Start of the checksummed range.
+ * @param length        Length of the checksummed range.
+ * @param fn            Checksum function, e.g. patch_crc32.
+ * @param init          Initial checksum state.
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int patch_set_add_checksum(patch_set_t* ps, uint64_t field_offset, int big_endian,
+                           uint64_t start, uint64_t length, patch_checksum_fn fn,
+                           uint32_t init);
+
+/**
+ * @brief Applies the queued updates to a file.
+ *
+ * Updates are sorted by offset and coalesced into runs of adjacent or
+ * overlapping fields, each written with a single seek and write; checksum
+ * fixups then read back their range. The queue is left intact.
+ *
+ * @param ps      Patch set.
+ * @param file    File opened for update ("r+b").
+ * @param writes  Optional; receives the number of write calls issued.
+ * @return 0 on success, -1 on error.
+ */
+int patch_set_apply(patch_set_t* ps, FILE* file, size_t* writes);
+
+/**
+ * @brief Applies the queued updates to memory, e.g. an mmapped file.
+ *
+ * @param ps    Patch set.
+ * @param data  Start of the region.
+ * @param size  Size of the region; every field and range must lie inside.
+ * @return 0 on success, -1 if anything is out of bounds (nothing is written).
+ */
+int patch_set_apply_mem(const patch_set_t* ps, uint8_t* data, size_t size);
+
+/**
+ * @brief Standard CRC-32 (IEEE 802.3, as in zlib/PNG) as a patch_checksum_fn.
+ *
+ * Use init 0; the pre- and post-conditioning is done per call.
+ */
+uint32_t patch_crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PATCH_IO_H
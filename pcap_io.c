@@ -0,0 +1,278 @@
+#include "pcap_io.h"
+#include <string.h>
+
+#define PCAP_GLOBAL_HEADER_SIZE 24
+#define PCAP_RECORD_HEADER_SIZE 16
+
+#define PCAP_MAGIC_USEC 0xA1B2C3D4u
+#define PCAP_MAGIC_NSEC 0xA1B23C4Du
+
+#define PCAPNG_SHB 0x0A0D0D0Au
+#define PCAPNG_IDB 0x00000001u
+#define PCAPNG_SPB 0x00000003u
+#define PCAPNG_EPB 0x00000006u
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4Du
+#define PCAPNG_OPT_TSRESOL 9
+
+static inline uint16_t load16(const pcap_reader_t* r, const uint8_t* p) {
+    return r->big_endian ? load_be16(p) : load_le16(p);
+}
+
+static inline uint32_t load32(const pcap_reader_t* r, const uint8_t* p) {
+    return r->big_endian ? load_be32(p) : load_le32(p);
+}
+
+// Converts a timestamp in units of the interface resolution to nanoseconds.
+static uint64_t to_nanoseconds(uint64_t ts, uint8_t tsresol) {
+    const unsigned exponent = tsresol & 0x7F;
+
+    if (tsresol & 0x80) {
+        // Negative power of two
+        if (exponent >= 64)
+            return 0;
+        const uint64_t frac = ts & (((uint64_t)1 << exponent) - 1);
+        if (exponent < 32)
+            return (ts >> exponent) * 1000000000u + ((frac * 1000000000u) >> exponent);
+
+        // frac * 10^9 needs up to 94 bits: multiply the 32-bit halves
+        // separately and shift before combining them
+        const uint64_t hi = (frac >> 32) * 1000000000u;
+        const uint64_t lo = (frac & 0xFFFFFFFFu) * 1000000000u;
+        return (ts >> exponent) * 1000000000u + ((hi + (lo >> 32)) >> (exponent - 32));
+    }
+
+    // Negative power of ten
+    uint64_t scale = 1;
+    if (exponent <= 9) {
+        for (unsigned i = exponent; i < 9; i++)
+            scale *= 10;
+        return ts * scale;
+    }
+    // 10^20 exceeds any 64-bit timestamp, so finer resolutions round to 0
+    if (exponent - 9 > 19)
+        return 0;
+    for (unsigned i = 9; i < exponent; i++)
+        scale *= 10;
+    return ts / scale;
+}
+
+// -----------------------------------------------------------------------------
+// Classic pcap
+// -----------------------------------------------------------------------------
+
+static int next_batch_pcap(pcap_reader_t* r, pcap_packet_t* packets, size_t max, size_t* count) {
+    const uint64_t frac_scale = r->nanosecond ? 1 : 1000;
+    size_t n = 0;
+
+    while (n < max && r->pos < r->end) {
+        if (r->end - r->pos < PCAP_RECORD_HEADER_SIZE)
+            return -1;
+        const uint8_t* h = r->data + r->pos;
+        const uint32_t incl_len = load32(r, h + 8);
+        if (r->end - r->pos - PCAP_RECORD_HEADER_SIZE < incl_len)
+            return -1;
+
+        pcap_packet_t* p = &packets[n++];
+        p->timestamp_ns = (uint64_t)load32(r, h) * 1000000000u + load32(r, h + 4) * frac_scale;
+        p->interface_id = 0;
+        p->linktype = r->linktype;
+        p->captured_length = incl_len;
+        p->original_length = load32(r, h + 12);
+        p->data = h + PCAP_RECORD_HEADER_SIZE;
+
+        r->pos += PCAP_RECORD_HEADER_SIZE + incl_len;
+    }
+
+    *count = n;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// pcapng
+// -----------------------------------------------------------------------------
+
+static int parse_section_header(pcap_reader_t* r, const uint8_t* block, size_t avail) {
+    if (avail < 12)
+        return -1;
+    const uint32_t magic = load_le32(block + 8);
+    if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+        r->big_endian = 0;
+    else if (load_be32(block + 8) == PCAPNG_BYTE_ORDER_MAGIC)
+        r->big_endian = 1;
+    else
+        return -1;
+    r->num_interfaces = 0;
+    return 0;
+}
+
+static int parse_interface(pcap_reader_t* r, const uint8_t* block, uint32_t length) {
+    if (length < 20 || r->num_interfaces == PCAP_MAX_INTERFACES)
+        return -1;
+
+    pcap_interface_t* iface = &r->interfaces[r->num_interfaces++];
+    iface->linktype = load16(r, block + 8);
+    iface->snaplen = load32(r, block + 12);
+    iface->tsresol = 6;
+
+    // Options: code (16), length (16), value padded to 32 bits
+    size_t pos = 16;
+    while (pos + 4 <= length - 4) {
+        const uint16_t code = load16(r, block + pos);
+        const uint16_t len = load16(r, block + pos + 2);
+        if (code == 0 || pos + 4 + len > length - 4)
+            break;
+        if (code == PCAPNG_OPT_TSRESOL && len >= 1)
+            iface->tsresol = block[pos + 4];
+        pos += 4 + (((size_t)len + 3) & ~(size_t)3);
+    }
+    return 0;
+}
+
+// Advances over one block. Returns 1 and fills *packet for packet blocks,
+// 0 for other blocks and -1 on malformed input.
+static int next_block(pcap_reader_t* r, pcap_packet_t* packet) {
+    const uint8_t* b = r->data + r->pos;
+    const size_t avail = r->end - r->pos;
+    if (avail < 12)
+        return -1;
+
+    const uint32_t type = load32(r, b);
+    if (type == PCAPNG_SHB && parse_section_header(r, b, avail) != 0)
+        return -1;
+
+    const uint32_t length = load32(r, b + 4);
+    if (length < 12 || length % 4 != 0 || length > avail)
+        return -1;
+    r->pos += length;
+
+    switch (type) {
+        case PCAPNG_IDB:
+            return parse_interface(r, b, length) == 0 ? 0 : -1;
+
+        case PCAPNG_EPB: {
+            if (length < 32)
+                return -1;
+            const uint32_t id = load32(r, b + 8);
+            const uint32_t caplen = load32(r, b + 20);
+            if (id >= r->num_interfaces || caplen > length - 32)
+                return -1;
+            const uint64_t ts = ((uint64_t)load32(r, b + 12) << 32) | load32(r, b + 16);
+            packet->timestamp_ns = to_nanoseconds(ts, r->interfaces[id].tsresol);
+            packet->interface_id = id;
+            packet->linktype = r->interfaces[id].linktype;
+            packet->captured_length = caplen;
+            packet->original_length = load32(r, b + 24);
+            packet->data = b + 28;
+            return 1;
+        }
+
+        case PCAPNG_SPB: {
+            if (length < 16 || r->num_interfaces == 0)
+                return -1;
+            const uint32_t original = load32(r, b + 8);
+            uint32_t caplen = length - 16;
+            if (original < caplen)
+                caplen = original;
+            if (r->interfaces[0].snaplen && r->interfaces[0].snaplen < caplen)
+                caplen = r->interfaces[0].snaplen;
+            packet->timestamp_ns = 0;
+            packet->interface_id = 0;
+            packet->linktype = r->interfaces[0].linktype;
+            packet->captured_length = caplen;
+            packet->original_length = original;
+            packet->data = b + 12;
+            return 1;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+static int next_batch_pcapng(pcap_reader_t* r, pcap_packet_t* packets, size_t max, size_t* count) {
+    size_t n = 0;
+    while (n < max && r->pos < r->end) {
+        const int status = next_block(r, &packets[n]);
+        if (status < 0)
+            return -1;
+        n += (size_t)status;
+    }
+    *count = n;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+int pcap_open(pcap_reader_t* reader, const uint8_t* data, size_t size) {
+    if (!reader || !data || size < 12)
+        return -1;
+
+    memset(reader, 0, sizeof(*reader));
+    reader->data = data;
+    reader->end = size;
+
+    const uint32_t magic = load_le32(data);
+    if (magic == PCAPNG_SHB) {
+        // The section header is parsed as the first block
+        reader->format = PCAP_FORMAT_PCAPNG;
+        return parse_section_header(reader, data, size);
+    }
+
+    if (size < PCAP_GLOBAL_HEADER_SIZE)
+        return -1;
+    reader->format = PCAP_FORMAT_PCAP;
+    if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+        reader->big_endian = 0;
+    } else if (load_be32(data) == PCAP_MAGIC_USEC || load_be32(data) == PCAP_MAGIC_NSEC) {
+        reader->big_endian = 1;
+    } else {
+        return -1;
+    }
+    reader->nanosecond = load32(reader, data) == PCAP_MAGIC_NSEC;
+    reader->snaplen = load32(reader, data + 16);
+    reader->linktype = load32(reader, data + 20);
+    reader->pos = PCAP_GLOBAL_HEADER_SIZE;
+    return 0;
+}
+
+int pcap_next_batch(pcap_reader_t* reader, pcap_packet_t* packets, size_t max, size_t* count) {
+    if (!reader || !count || (!packets && max > 0))
+        return -1;
+    *count = 0;
+    return reader->format == PCAP_FORMAT_PCAP ? next_batch_pcap(reader, packets, max, count)
+                                              : next_batch_pcapng(reader, packets, max, count);
+}
+
+int pcap_split(const pcap_reader_t* reader, pcap_reader_t* parts, size_t nparts, size_t* produced) {
+    if (!reader || !parts || nparts == 0 || !produced)
+        return -1;
+
+    // Walk record headers only, cutting at the first boundary past each target
+    pcap_reader_t walker = *reader;
+    const size_t begin = walker.pos;
+    const size_t total = walker.end - begin;
+    size_t n = 0;
+
+    parts[n] = walker;
+    for (size_t k = 1; k < nparts && walker.pos < walker.end; k++) {
+        const size_t target = begin + total / nparts * k;
+        while (walker.pos < target && walker.pos < walker.end) {
+            pcap_packet_t packet;
+            size_t count;
+            const int status = walker.format == PCAP_FORMAT_PCAP
+                               ? next_batch_pcap(&walker, &packet, 1, &count)
+                               : next_block(&walker, &packet);
+            if (status < 0)
+                return -1;
+        }
+        if (walker.pos > parts[n].pos && walker.pos < walker.end) {
+            parts[n].end = walker.pos;
+            parts[++n] = walker;
+        }
+    }
+
+    *produced = n + 1;
+    return 0;
+}
@@ -0,0 +1,92 @@
+#ifndef PCAP_IO_H
+#define PCAP_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PCAP_MAX_INTERFACES 64
+
+/// Capture file flavour, detected from the leading magic number.
+typedef enum {
+    PCAP_FORMAT_PCAP,   ///< Classic libpcap format
+    PCAP_FORMAT_PCAPNG  ///< pcapng block format
+} pcap_format_t;
+
+/// One captured packet; data points into the capture buffer (zero-copy).
+typedef struct {
+    uint64_t timestamp_ns;      ///< Capture time in nanoseconds since the epoch
+    uint32_t interface_id;      ///< Interface index (always 0 for classic pcap)
+    uint32_t linktype;          ///< Link-layer header type of the interface
+    uint32_t captured_length;   ///< Number of bytes available at data
+    uint32_t original_length;   ///< Length of the packet on the wire
+    const uint8_t* data;        ///< Packet bytes
+} pcap_packet_t;
+
+/// Interface described by a pcapng Interface Description Block.
+typedef struct {
+    uint32_t linktype;
+    uint32_t snaplen;
+    uint8_t tsresol;            ///< if_tsresol option (6 = microseconds)
+} pcap_interface_t;
+
+/// Cursor over an in-memory (e.g. mmapped) capture file.
+typedef struct {
+    const uint8_t* data;        ///< Start of the capture file
+    size_t pos;                 ///< Offset of the next record or block
+    size_t end;                 ///< Offset where this cursor stops
+    pcap_format_t format;
+    int big_endian;             ///< Byte order of the current file or section
+    int nanosecond;             ///< Classic pcap: nanosecond timestamps
+    uint32_t linktype;          ///< Classic pcap: link-layer header type
+    uint32_t snaplen;           ///< Classic pcap: snapshot length
+    size_t num_interfaces;      ///< pcapng: interfaces in the current section
+    pcap_interface_t interfaces[PCAP_MAX_INTERFACES];
+} pcap_reader_t;
+
+/**
+ * @brief Opens a capture held in memory and detects its format and byte order.
+ *
+ * @param reader  Reader to initialize.
+ * @param data    Start of the capture file, e.g. an mmapped region.
+ * @param size    Size of the capture in bytes.
+ * @return 0 on success, -1 if the magic number is not recognized.
+ */
+int pcap_open(pcap_reader_t* reader, const uint8_t* data, size_t size);
+
+/**
+ * @brief Decodes the next batch of packets.
+ *
+ * Record headers are decoded with the byte order declared by the file; the
+ * packet data is not copied.
+ *
+ * @param reader  Capture reader.
+ * @param packets Output array of at least max entries.
+ * @param max     Maximum number of packets to return.
+ * @param count   Receives the number of packets returned (0 at the end).
+ * @return 0 on success, -1 on a malformed or truncated record.
+ */
+int pcap_next_batch(pcap_reader_t* reader, pcap_packet_t* packets, size_t max, size_t* count);
+
+/**
+ * @brief Splits the remaining capture into readers for parallel scans.
+ *
+ * Boundaries fall on record boundaries close to equal-size parts. Each part
+ * carries the byte order and interface table in effect at its start, so the
+ * parts can be scanned independently, e.g. one per thread.
+ *
+ * @param reader    Capture reader positioned anywhere in the file.
+ * @param parts     Output array of nparts readers.
+ * @param nparts    Requested number of parts.
+ * @param produced  Receives the number of parts written (at most nparts).
+ * @return 0 on success, -1 on a malformed capture.
+ */
+int pcap_split(const pcap_reader_t* reader, pcap_reader_t* parts, size_t nparts, size_t* produced);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PCAP_IO_H
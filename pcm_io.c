@@ -0,0 +1,549 @@
+#include "pcm_io.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define PCM_BUFFER_SIZE 16384
+
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+// Sample encodings supported by the fused kernels
+typedef enum {
+    PCM_U8, PCM_S8,
+    PCM_S16BE, PCM_S16LE,
+    PCM_S24BE, PCM_S24LE,
+    PCM_S32BE, PCM_S32LE,
+    PCM_F32BE, PCM_F32LE,
+    PCM_F64BE, PCM_F64LE,
+    PCM_INVALID
+} pcm_layout_t;
+
+static pcm_layout_t sample_layout(const pcm_format_t* fmt) {
+    const int be = fmt->big_endian;
+    if (fmt->is_float) {
+        switch (fmt->bits_per_sample) {
+            case 32: return be ? PCM_F32BE : PCM_F32LE;
+            case 64: return be ? PCM_F64BE : PCM_F64LE;
+            default: return PCM_INVALID;
+        }
+    }
+    switch (fmt->bits_per_sample) {
+        case 8:  return fmt->container == PCM_CONTAINER_WAV ? PCM_U8 : PCM_S8;
+        case 16: return be ? PCM_S16BE : PCM_S16LE;
+        case 24: return be ? PCM_S24BE : PCM_S24LE;
+        case 32: return be ? PCM_S32BE : PCM_S32LE;
+        default: return PCM_INVALID;
+    }
+}
+
+static inline size_t frame_size(const pcm_format_t* fmt) {
+    return (size_t)fmt->channels * (fmt->bits_per_sample / 8);
+}
+
+// -----------------------------------------------------------------------------
+// Sample Load/Store Helpers
+// -----------------------------------------------------------------------------
+
+static inline int32_t get_u8(const uint8_t* p)    { return (int32_t)p[0] - 128; }
+static inline int32_t get_s8(const uint8_t* p)    { return (int8_t)p[0]; }
+static inline int32_t get_s16be(const uint8_t* p) { return (int16_t)load_be16(p); }
+static inline int32_t get_s16le(const uint8_t* p) { return (int16_t)load_le16(p); }
+static inline int32_t get_s32be(const uint8_t* p) { return (int32_t)load_be32(p); }
+static inline int32_t get_s32le(const uint8_t* p) { return (int32_t)load_le32(p); }
+
+// Packed 24-bit: assemble in the top three bytes, then sign-extend by shifting
+static inline int32_t get_s24be(const uint8_t* p) {
+    return (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8)) >> 8;
+}
+
+static inline int32_t get_s24le(const uint8_t* p) {
+    return (int32_t)(((uint32_t)p[2] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 8)) >> 8;
+}
+
+static inline float get_f32be(const uint8_t* p) {
+    const uint32_t bits = load_be32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline float get_f32le(const uint8_t* p) {
+    const uint32_t bits = load_le32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline double get_f64be(const uint8_t* p) {
+    const uint64_t bits = load_be64(p);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline double get_f64le(const uint8_t* p) {
+    const uint64_t bits = load_le64(p);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline void put_u8(uint8_t* p, int32_t v)    { p[0] = (uint8_t)(v + 128); }
+static inline void put_s8(uint8_t* p, int32_t v)    { p[0] = (uint8_t)v; }
+static inline void put_s16be(uint8_t* p, int32_t v) { store_be16(p, (uint16_t)v); }
+static inline void put_s16le(uint8_t* p, int32_t v) { store_le16(p, (uint16_t)v); }
+static inline void put_s32be(uint8_t* p, int32_t v) { store_be32(p, (uint32_t)v); }
+static inline void put_s32le(uint8_t* p, int32_t v) { store_le32(p, (uint32_t)v); }
+
+static inline void put_s24be(uint8_t* p, int32_t v) {
+    p[0] = (uint8_t)(v >> 16);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)v;
+}
+
+static inline void put_s24le(uint8_t* p, int32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+}
+
+static inline void put_f32be(uint8_t* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    store_be32(p, bits);
+}
+
+static inline void put_f32le(uint8_t* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    store_le32(p, bits);
+}
+
+static inline void put_f64be(uint8_t* p, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    store_be64(p, bits);
+}
+
+static inline void put_f64le(uint8_t* p, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    store_le64(p, bits);
+}
+
+// -----------------------------------------------------------------------------
+// Conversions
+// -----------------------------------------------------------------------------
+
+static inline int32_t saturate_i32(double x) {
+    if (x >= 2147483647.0)  return INT32_MAX;
+    if (x <= -2147483648.0) return INT32_MIN;
+    return (int32_t)x;
+}
+
+// Rounds a [-1, 1] sample to a signed integer of the given width
+static inline int32_t quantize(float f, unsigned bits) {
+    const double scale = (double)((uint32_t)1 << (bits - 1));
+    double x = (double)f * scale;
+    x += x >= 0 ? 0.5 : -0.5;
+    if (x >= scale - 1) return (int32_t)(scale - 1);
+    if (x <= -scale)    return (int32_t)-scale;
+    return (int32_t)x;
+}
+
+#define F32_FROM_INT(v, bits) ((float)(v) * (1.0f / (float)((uint32_t)1 << ((bits) - 1))))
+#define F32_FROM_FLOAT(f)     ((float)(f))
+#define F32_TO_INT(x, bits)   quantize((x), (bits))
+#define F32_TO_FLOAT(x)       (x)
+
+#define I32_FROM_INT(v, bits) ((int32_t)((uint32_t)(v) << (32 - (bits))))
+#define I32_FROM_FLOAT(f)     saturate_i32((double)(f) * 2147483648.0)
+#define I32_TO_INT(x, bits)   ((x) >> (32 - (bits)))
+#define I32_TO_FLOAT(x)       ((float)((double)(x) / 2147483648.0))
+
+#define PCM_DECODE_LOOP(STRIDE, EXPR)             \
+    for (size_t i = 0; i < n; i++) {              \
+        const uint8_t* p = raw + i * (STRIDE);    \
+        out[i] = EXPR;                            \
+    }                                             \
+    return 0;
+
+#define PCM_ENCODE_LOOP(STRIDE, STMT)             \
+    for (size_t i = 0; i < n; i++) {              \
+        uint8_t* p = raw + i * (STRIDE);          \
+        STMT;                                     \
+    }                                             \
+    return 0;
+
+// Fused swap / sign-extend / scale kernels plus chunked file I/O on top of
+// them, generated for each output sample type.
+#define DEFINE_PCM_IO(TYPE, SUFFIX, FROM_INT, FROM_FLOAT, TO_INT, TO_FLOAT)             \
+int pcm_decode_##SUFFIX(const pcm_format_t* fmt, const uint8_t* raw, size_t n, TYPE* out) { \
+    if (!fmt || !raw || !out)                                                           \
+        return -1;                                                                      \
+    switch (sample_layout(fmt)) {                                                       \
+        case PCM_U8:    PCM_DECODE_LOOP(1, FROM_INT(get_u8(p), 8))                      \
+        case PCM_S8:    PCM_DECODE_LOOP(1, FROM_INT(get_s8(p), 8))                      \
+        case PCM_S16BE: PCM_DECODE_LOOP(2, FROM_INT(get_s16be(p), 16))                  \
+        case PCM_S16LE: PCM_DECODE_LOOP(2, FROM_INT(get_s16le(p), 16))                  \
+        case PCM_S24BE: PCM_DECODE_LOOP(3, FROM_INT(get_s24be(p), 24))                  \
+        case PCM_S24LE: PCM_DECODE_LOOP(3, FROM_INT(get_s24le(p), 24))                  \
+        case PCM_S32BE: PCM_DECODE_LOOP(4, FROM_INT(get_s32be(p), 32))                  \
+        case PCM_S32LE: PCM_DECODE_LOOP(4, FROM_INT(get_s32le(p), 32))                  \
+        case PCM_F32BE: PCM_DECODE_LOOP(4, FROM_FLOAT(get_f32be(p)))                    \
+        case PCM_F32LE: PCM_DECODE_LOOP(4, FROM_FLOAT(get_f32le(p)))                    \
+        case PCM_F64BE: PCM_DECODE_LOOP(8, FROM_FLOAT(get_f64be(p)))                    \
+        case PCM_F64LE: PCM_DECODE_LOOP(8, FROM_FLOAT(get_f64le(p)))                    \
+        default:        return -1;                                                      \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+static int encode_##SUFFIX(const pcm_format_t* fmt, const TYPE* in, size_t n, uint8_t* raw) { \
+    switch (sample_layout(fmt)) {                                                       \
+        case PCM_U8:    PCM_ENCODE_LOOP(1, put_u8(p, TO_INT(in[i], 8)))                 \
+        case PCM_S8:    PCM_ENCODE_LOOP(1, put_s8(p, TO_INT(in[i], 8)))                 \
+        case PCM_S16BE: PCM_ENCODE_LOOP(2, put_s16be(p, TO_INT(in[i], 16)))             \
+        case PCM_S16LE: PCM_ENCODE_LOOP(2, put_s16le(p, TO_INT(in[i], 16)))             \
+        case PCM_S24BE: PCM_ENCODE_LOOP(3, put_s24be(p, TO_INT(in[i], 24)))             \
+        case PCM_S24LE: PCM_ENCODE_LOOP(3, put_s24le(p, TO_INT(in[i], 24)))             \
+        case PCM_S32BE: PCM_ENCODE_LOOP(4, put_s32be(p, TO_INT(in[i], 32)))             \
+        case PCM_S32LE: PCM_ENCODE_LOOP(4, put_s32le(p, TO_INT(in[i], 32)))             \
+        case PCM_F32BE: PCM_ENCODE_LOOP(4, put_f32be(p, TO_FLOAT(in[i])))               \
+        case PCM_F32LE: PCM_ENCODE_LOOP(4, put_f32le(p, TO_FLOAT(in[i])))               \
+        case PCM_F64BE: PCM_ENCODE_LOOP(8, put_f64be(p, TO_FLOAT(in[i])))               \
+        case PCM_F64LE: PCM_ENCODE_LOOP(8, put_f64le(p, TO_FLOAT(in[i])))               \
+        default:        return -1;                                                      \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+int pcm_read_##SUFFIX(FILE* file, const pcm_format_t* fmt, TYPE* out,                   \
+                      size_t frames, size_t* frames_read) {                             \
+    if (!file || !fmt || !out || !frames_read || sample_layout(fmt) == PCM_INVALID)     \
+        return -1;                                                                      \
+    const size_t fsize = frame_size(fmt);                                               \
+    if (fsize > PCM_BUFFER_SIZE)                                                        \
+        return -1;                                                                      \
+    const long pos = ftell(file);                                                       \
+    const size_t end = fmt->data_offset + fmt->frames * fsize;                          \
+    if (pos < 0 || (size_t)pos < fmt->data_offset)                                      \
+        return -1;                                                                      \
+    const size_t left = (size_t)pos < end ? (end - (size_t)pos) / fsize : 0;           \
+    if (frames > left)                                                                  \
+        frames = left;                                                                  \
+                                                                                        \
+    uint8_t buffer[PCM_BUFFER_SIZE];                                                    \
+    const size_t block = sizeof(buffer) / fsize;                                        \
+    for (size_t done = 0; done < frames; ) {                                            \
+        const size_t batch = frames - done < block ? frames - done : block;             \
+        if (fread(buffer, fsize, batch, file) != batch)                                 \
+            return -1;                                                                  \
+        pcm_decode_##SUFFIX(fmt, buffer, batch * fmt->channels,                         \
+                            out + done * fmt->channels);                                \
+        done += batch;                                                                  \
+    }                                                                                   \
+    *frames_read = frames;                                                              \
+    return 0;                                                                           \
+}                                                                                       \
+                                                                                        \
+int pcm_write_##SUFFIX(FILE* file, const pcm_format_t* fmt, const TYPE* in, size_t frames) { \
+    if (!file || !fmt || !in || sample_layout(fmt) == PCM_INVALID)                      \
+        return -1;                                                                      \
+    const size_t fsize = frame_size(fmt);                                               \
+    if (fsize > PCM_BUFFER_SIZE)                                                        \
+        return -1;                                                                      \
+    uint8_t buffer[PCM_BUFFER_SIZE];                                                    \
+    const size_t block = sizeof(buffer) / fsize;                                        \
+    for (size_t done = 0; done < frames; ) {                                            \
+        const size_t batch = frames - done < block ? frames - done : block;             \
+        encode_##SUFFIX(fmt, in + done * fmt->channels, batch * fmt->channels, buffer); \
+        if (fwrite(buffer, fsize, batch, file) != batch)                                \
+            return -1;                                                                  \
+        done += batch;                                                                  \
+    }                                                                                   \
+    return 0;                                                                           \
+}
+
+DEFINE_PCM_IO(float, f32, F32_FROM_INT, F32_FROM_FLOAT, F32_TO_INT, F32_TO_FLOAT)
+DEFINE_PCM_IO(int32_t, i32, I32_FROM_INT, I32_FROM_FLOAT, I32_TO_INT, I32_TO_FLOAT)
+
+// -----------------------------------------------------------------------------
+// Chunk Parsing
+// -----------------------------------------------------------------------------
+
+// Position-tracking walker over a byte source
+typedef struct {
+    const endian_source_t* stream;
+    size_t pos;
+} chunk_source_t;
+
+static int source_read(chunk_source_t* src, uint8_t* dst, size_t n) {
+    if (src->stream->read(src->stream->ctx, dst, n) != 0)
+        return -1;
+    src->pos += n;
+    return 0;
+}
+
+// Sources without a seek hook can still skip forward by reading
+static int source_seek(chunk_source_t* src, size_t pos) {
+    if (src->stream->seek) {
+        if (src->stream->seek(src->stream->ctx, pos) != 0)
+            return -1;
+        src->pos = pos;
+        return 0;
+    }
+    uint8_t scratch[256];
+    if (pos < src->pos)
+        return -1;
+    while (src->pos < pos) {
+        const size_t n = pos - src->pos < sizeof(scratch) ? pos - src->pos : sizeof(scratch);
+        if (source_read(src, scratch, n) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+// Decodes the integer part of an 80-bit IEEE extended float
+static uint32_t extended_to_u32(const uint8_t* p) {
+    const int exponent = (int)(load_be16(p) & 0x7FFF) - 16383 - 63;
+    const uint64_t mantissa = load_be64(p + 2);
+    if (exponent >= 0)
+        return exponent < 32 ? (uint32_t)(mantissa << exponent) : 0;
+    return -exponent < 64 ? (uint32_t)(mantissa >> -exponent) : 0;
+}
+
+static void u32_to_extended(uint32_t value, uint8_t* p) {
+    memset(p, 0, 10);
+    if (value == 0)
+        return;
+    int msb = 31;
+    while (!(value & ((uint32_t)1 << msb)))
+        msb--;
+    store_be16(p, (uint16_t)(16383 + msb));
+    store_be64(p + 2, (uint64_t)value << (63 - msb));
+}
+
+static int parse_wav(chunk_source_t* src, pcm_format_t* fmt) {
+    int have_fmt = 0;
+    uint8_t chunk[8];
+
+    fmt->container = PCM_CONTAINER_WAV;
+    fmt->big_endian = 0;
+    while (source_read(src, chunk, sizeof(chunk)) == 0) {
+        const uint32_t size = load_le32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            const size_t next = src->pos + size + (size & 1);
+            uint8_t body[40] = {0};
+            if (size < 16 || source_read(src, body, size < sizeof(body) ? size : sizeof(body)) != 0)
+                return -1;
+            uint16_t tag = load_le16(body);
+            if (tag == WAVE_FORMAT_EXTENSIBLE && size >= 26)
+                tag = load_le16(body + 24);
+            if (tag != WAVE_FORMAT_PCM && tag != WAVE_FORMAT_IEEE_FLOAT)
+                return -1;
+            fmt->is_float = tag == WAVE_FORMAT_IEEE_FLOAT;
+            fmt->channels = load_le16(body + 2);
+            fmt->sample_rate = load_le32(body + 4);
+            fmt->bits_per_sample = load_le16(body + 14);
+            have_fmt = 1;
+            if (source_seek(src, next) != 0)
+                return -1;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt || fmt->channels == 0 || sample_layout(fmt) == PCM_INVALID)
+                return -1;
+            fmt->data_offset = src->pos;
+            fmt->frames = size / frame_size(fmt);
+            return 0;
+        } else if (source_seek(src, src->pos + size + (size & 1)) != 0) {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+static int parse_aiff(chunk_source_t* src, pcm_format_t* fmt, int aifc) {
+    int have_comm = 0;
+    size_t ssnd = 0;
+    uint8_t chunk[8];
+
+    fmt->container = PCM_CONTAINER_AIFF;
+    fmt->big_endian = 1;
+    while (source_read(src, chunk, sizeof(chunk)) == 0) {
+        const uint32_t size = load_be32(chunk + 4);
+        const size_t next = src->pos + size + (size & 1);
+
+        if (memcmp(chunk, "COMM", 4) == 0) {
+            uint8_t body[22];
+            if (size < (aifc ? 22u : 18u) || source_read(src, body, aifc ? 22 : 18) != 0)
+                return -1;
+            fmt->channels = load_be16(body);
+            fmt->frames = load_be32(body + 2);
+            fmt->bits_per_sample = (uint16_t)((load_be16(body + 6) + 7) / 8 * 8);
+            fmt->sample_rate = extended_to_u32(body + 8);
+            if (aifc) {
+                if (memcmp(body + 18, "sowt", 4) == 0) {
+                    fmt->big_endian = 0;
+                } else if (memcmp(body + 18, "fl32", 4) == 0 || memcmp(body + 18, "FL32", 4) == 0) {
+                    fmt->is_float = 1;
+                    fmt->bits_per_sample = 32;
+                } else if (memcmp(body + 18, "fl64", 4) == 0 || memcmp(body + 18, "FL64", 4) == 0) {
+                    fmt->is_float = 1;
+                    fmt->bits_per_sample = 64;
+                } else if (memcmp(body + 18, "NONE", 4) != 0 && memcmp(body + 18, "twos", 4) != 0) {
+                    return -1;
+                }
+            }
+            have_comm = 1;
+        } else if (memcmp(chunk, "SSND", 4) == 0) {
+            uint8_t body[8];
+            if (size < 8 || source_read(src, body, sizeof(body)) != 0)
+                return -1;
+            ssnd = src->pos + load_be32(body);
+        }
+        if (have_comm && ssnd)
+            break;
+        if (source_seek(src, next) != 0)
+            return -1;
+    }
+
+    if (!have_comm || !ssnd || fmt->channels == 0 || sample_layout(fmt) == PCM_INVALID)
+        return -1;
+    fmt->data_offset = ssnd;
+    return source_seek(src, ssnd);
+}
+
+static int parse_container(chunk_source_t* src, pcm_format_t* fmt) {
+    uint8_t riff[12];
+    if (source_read(src, riff, sizeof(riff)) != 0)
+        return -1;
+
+    memset(fmt, 0, sizeof(*fmt));
+    if (memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0)
+        return parse_wav(src, fmt);
+    if (memcmp(riff, "FORM", 4) == 0 && memcmp(riff + 8, "AIFF", 4) == 0)
+        return parse_aiff(src, fmt, 0);
+    if (memcmp(riff, "FORM", 4) == 0 && memcmp(riff + 8, "AIFC", 4) == 0)
+        return parse_aiff(src, fmt, 1);
+    return -1;
+}
+
+int pcm_parse_header(const uint8_t* data, size_t size, pcm_format_t* fmt) {
+    if (!data || !fmt)
+        return -1;
+    endian_buffer_t buf = { (uint8_t*)data, size, 0 };
+    endian_source_t stream;
+    endian_source_from_buffer(&stream, &buf);
+    chunk_source_t src = { &stream, 0 };
+    return parse_container(&src, fmt);
+}
+
+int pcm_read_header(FILE* file, pcm_format_t* fmt) {
+    if (!file || !fmt)
+        return -1;
+    const long start = ftell(file);
+    if (start < 0)
+        return -1;
+    endian_source_t stream;
+    endian_source_from_file(&stream, file);
+    chunk_source_t src = { &stream, (size_t)start };
+    return parse_container(&src, fmt);
+}
+
+int pcm_read_header_source(const endian_source_t* src, pcm_format_t* fmt) {
+    if (!src || !src->read || !fmt)
+        return -1;
+    chunk_source_t walker = { src, 0 };
+    return parse_container(&walker, fmt);
+}
+
+// -----------------------------------------------------------------------------
+// Header Writing
+// -----------------------------------------------------------------------------
+
+int pcm_write_header(FILE* file, pcm_format_t* fmt) {
+    if (!file || !fmt || fmt->channels == 0)
+        return -1;
+
+    fmt->big_endian = fmt->container == PCM_CONTAINER_AIFF;
+    if (sample_layout(fmt) == PCM_INVALID)
+        return -1;
+
+    // Chunk sizes and the AIFF frame count are 32-bit fields; data plus the
+    // largest header (sizeof(h), which covers the pad byte) must fit in them
+    uint8_t h[80];
+    const size_t frame = frame_size(fmt);
+    if (fmt->frames > (UINT32_MAX - sizeof(h)) / frame)
+        return -1;
+    if (fmt->container == PCM_CONTAINER_WAV &&
+        (frame > UINT16_MAX || fmt->sample_rate > UINT32_MAX / frame))
+        return -1;
+
+    const size_t data_size = fmt->frames * frame;
+    const size_t pad = data_size & 1;
+    size_t n = 0;
+
+    if (fmt->container == PCM_CONTAINER_WAV) {
+        memcpy(h, "RIFF", 4);
+        store_le32(h + 4, (uint32_t)(4 + 24 + 8 + data_size + pad));
+        memcpy(h + 8, "WAVEfmt ", 8);
+        store_le32(h + 16, 16);
+        store_le16(h + 20, fmt->is_float ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+        store_le16(h + 22, fmt->channels);
+        store_le32(h + 24, fmt->sample_rate);
+        store_le32(h + 28, (uint32_t)(fmt->sample_rate * frame));
+        store_le16(h + 32, (uint16_t)frame);
+        store_le16(h + 34, fmt->bits_per_sample);
+        memcpy(h + 36, "data", 4);
+        store_le32(h + 40, (uint32_t)data_size);
+        n = 44;
+    } else {
+        // Float samples need AIFF-C with a format version chunk
+        const int aifc = fmt->is_float;
+        const size_t comm_size = aifc ? 24 : 18;
+        const size_t fver_size = aifc ? 12 : 0;
+
+        memcpy(h, "FORM", 4);
+        store_be32(h + 4, (uint32_t)(4 + fver_size + 8 + comm_size + 16 + data_size + pad));
+        memcpy(h + 8, aifc ? "AIFC" : "AIFF", 4);
+        n = 12;
+        if (aifc) {
+            memcpy(h + n, "FVER", 4);
+            store_be32(h + n + 4, 4);
+            store_be32(h + n + 8, 0xA2805140u); // AIFF-C version 1
+            n += 12;
+        }
+        memcpy(h + n, "COMM", 4);
+        store_be32(h + n + 4, (uint32_t)comm_size);
+        store_be16(h + n + 8, fmt->channels);
+        store_be32(h + n + 10, (uint32_t)fmt->frames);
+        store_be16(h + n + 14, fmt->bits_per_sample);
+        u32_to_extended(fmt->sample_rate, h + n + 16);
+        n += 26;
+        if (aifc) {
+            memcpy(h + n, fmt->bits_per_sample == 64 ? "fl64" : "fl32", 4);
+            h[n + 4] = 0; // empty compression name, padded to even length
+            h[n + 5] = 0;
+            n += 6;
+        }
+        memcpy(h + n, "SSND", 4);
+        store_be32(h + n + 4, (uint32_t)(8 + data_size));
+        store_be32(h + n + 8, 0);
+        store_be32(h + n + 12, 0);
+        n += 16;
+    }
+
+    if (fwrite(h, 1, n, file) != n)
+        return -1;
+    const long pos = ftell(file);
+    fmt->data_offset = pos < 0 ? n : (size_t)pos;
+    return 0;
+}
+
+int pcm_write_finish(FILE* file, const pcm_format_t* fmt) {
+    if (!file || !fmt)
+        return -1;
+    if ((fmt->frames * frame_size(fmt)) & 1)
+        return fputc(0, file) == EOF ? -1 : 0;
+    return 0;
+}
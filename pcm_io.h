@@ -0,0 +1,149 @@
+#ifndef PCM_IO_H
+#define PCM_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Audio container type.
+typedef enum {
+    PCM_CONTAINER_WAV,  ///< RIFF/WAVE, little-endian samples
+    PCM_CONTAINER_AIFF  ///< FORM/AIFF or AIFF-C, big-endian samples (or 'sowt')
+} pcm_container_t;
+
+/// Sample layout of an audio file.
+typedef struct {
+    pcm_container_t container;
+    uint16_t channels;
+    uint32_t sample_rate;       ///< Frames per second
+    uint16_t bits_per_sample;   ///< 8, 16, 24 or 32 (64 for float WAV)
+    int is_float;               ///< 1 for IEEE float samples
+    int big_endian;             ///< Byte order of the samples
+    size_t frames;              ///< Number of sample frames
+    size_t data_offset;         ///< Offset of the first sample from the file start
+} pcm_format_t;
+
+/**
+ * @brief Parses WAV or AIFF/AIFF-C chunks from memory.
+ *
+ * @param data  Start of the file, e.g. an mmapped region.
+ * @param size  Number of bytes available.
+ * @param fmt   Receives the sample layout.
+ * @return 0 on success, -1 on malformed input or unsupported encoding.
+ */
+int pcm_parse_header(const uint8_t* data, size_t size, pcm_format_t* fmt);
+
+/**
+ * @brief Reads the chunks of a WAV or AIFF file, leaving the file at the
+ *        first sample.
+ *
+ * @param file  Open binary file positioned at the start.
+ * @param fmt   Receives the sample layout.
+ * @return 0 on success, -1 on error.
+ */
+int pcm_read_header(FILE* file, pcm_format_t* fmt);
+
+/**
+ * @brief Source counterpart of pcm_read_header(), leaving src at the first sample.
+ *
+ * Offsets, including fmt->data_offset, count from where src starts. Without
+ * a seek hook, chunks are skipped by reading, which works for files whose
+ * AIFF COMM chunk precedes SSND (and for all WAV files).
+ *
+ * @param src  Input stream positioned at the start of the container.
+ * @param fmt  Receives the sample layout.
+ * @return 0 on success, -1 on error.
+ */
+int pcm_read_header_source(const endian_source_t* src, pcm_format_t* fmt);
+
+/**
+ * @brief Decodes interleaved samples to float in [-1, 1).
+ *
+ * Byte swap, sign extension (including packed 24-bit) and scaling happen in
+ * a single pass.
+ *
+ * @param fmt  Sample layout.
+ * @param raw  Samples as stored in the file.
+ * @param n    Number of samples (frames * channels).
+ * @param out  Output array of n floats.
+ * @return 0 on success, -1 on unsupported layout.
+ */
+int pcm_decode_f32(const pcm_format_t* fmt, const uint8_t* raw, size_t n, float* out);
+
+/**
+ * @brief Decodes interleaved samples to left-justified int32_t.
+ *
+ * Integer samples are shifted to the top of the 32-bit range; float samples
+ * are scaled by 2^31 and saturated.
+ *
+ * @param fmt  Sample layout.
+ * @param raw  Samples as stored in the file.
+ * @param n    Number of samples (frames * channels).
+ * @param out  Output array of n values.
+ * @return 0 on success, -1 on unsupported layout.
+ */
+int pcm_decode_i32(const pcm_format_t* fmt, const uint8_t* raw, size_t n, int32_t* out);
+
+/**
+ * @brief Reads up to frames sample frames from the current position as float.
+ *
+ * Intended for chunked streaming: call repeatedly with a small frame count.
+ *
+ * @param file         Open binary file inside the sample data.
+ * @param fmt          Sample layout from pcm_read_header().
+ * @param out          Output array of frames * channels floats.
+ * @param frames       Maximum number of frames to read.
+ * @param frames_read  Receives the number of frames read (0 at the end).
+ * @return 0 on success, -1 on error.
+ */
+int pcm_read_f32(FILE* file, const pcm_format_t* fmt, float* out,
+                 size_t frames, size_t* frames_read);
+
+/// Left-justified int32_t counterpart of pcm_read_f32().
+int pcm_read_i32(FILE* file, const pcm_format_t* fmt, int32_t* out,
+                 size_t frames, size_t* frames_read);
+
+/**
+ * @brief Writes a WAV or AIFF header for fmt->frames frames.
+ *
+ * The sample byte order is the container's native one (little-endian for
+ * WAV, big-endian for AIFF); fmt->big_endian and fmt->data_offset are
+ * updated accordingly.
+ *
+ * @param file  Open binary file for writing.
+ * @param fmt   Sample layout, including the total number of frames.
+ * @return 0 on success, -1 on error, unsupported layout, or data too large
+ *         for the 32-bit chunk sizes.
+ */
+int pcm_write_header(FILE* file, pcm_format_t* fmt);
+
+/**
+ * @brief Encodes and writes float frames, rounding and saturating.
+ *
+ * @param file    Open binary file after pcm_write_header().
+ * @param fmt     Sample layout passed to pcm_write_header().
+ * @param in      Interleaved input samples in [-1, 1].
+ * @param frames  Number of frames to write.
+ * @return 0 on success, -1 on error.
+ */
+int pcm_write_f32(FILE* file, const pcm_format_t* fmt, const float* in, size_t frames);
+
+/// Left-justified int32_t counterpart of pcm_write_f32().
+int pcm_write_i32(FILE* file, const pcm_format_t* fmt, const int32_t* in, size_t frames);
+
+/**
+ * @brief Writes the pad byte required after odd-sized sample data.
+ *
+ * @param file  Open binary file after the last frame.
+ * @param fmt   Sample layout passed to pcm_write_header().
+ * @return 0 on success, -1 on error.
+ */
+int pcm_write_finish(FILE* file, const pcm_format_t* fmt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PCM_IO_H
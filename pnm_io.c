@@ -0,0 +1,223 @@
+#include "pnm_io.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define PNM_BUFFER_SIZE 65536
+
+static inline size_t sample_size(const pnm_header_t* hdr) {
+    return hdr->maxval > 255 ? 2 : 1;
+}
+
+size_t pnm_sample_count(const pnm_header_t* hdr) {
+    if (hdr->width == 0 || hdr->height == 0 || hdr->channels == 0)
+        return 0;
+    if (hdr->width > SIZE_MAX / hdr->height ||
+        hdr->width * hdr->height > SIZE_MAX / hdr->channels)
+        return SIZE_MAX;
+    return hdr->width * hdr->height * hdr->channels;
+}
+
+// Raster size in bytes, or SIZE_MAX if it does not fit
+static size_t raster_bytes(const pnm_header_t* hdr) {
+    const size_t n = pnm_sample_count(hdr);
+    return n == SIZE_MAX || n > SIZE_MAX / sample_size(hdr) ? SIZE_MAX : n * sample_size(hdr);
+}
+
+// -----------------------------------------------------------------------------
+// Header Parsing
+// -----------------------------------------------------------------------------
+
+// Character source over either a FILE* or a memory buffer
+typedef struct {
+    FILE* file;
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+} pnm_source_t;
+
+static int next_char(pnm_source_t* src) {
+    src->pos++;
+    if (src->file)
+        return getc(src->file);
+    return src->pos <= src->size ? src->data[src->pos - 1] : EOF;
+}
+
+static inline int is_space(int c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Reads a decimal field, skipping whitespace and '#' comments before it.
+// The single whitespace character after the field is consumed.
+static int read_field(pnm_source_t* src, size_t* value) {
+    int c = next_char(src);
+    for (;;) {
+        if (c == '#') {
+            while (c != '\n' && c != '\r' && c != EOF)
+                c = next_char(src);
+        } else if (is_space(c)) {
+            c = next_char(src);
+        } else {
+            break;
+        }
+    }
+
+    if (c < '0' || c > '9')
+        return -1;
+    size_t n = 0;
+    while (c >= '0' && c <= '9') {
+        if (n > (SIZE_MAX - (size_t)(c - '0')) / 10)
+            return -1;
+        n = n * 10 + (size_t)(c - '0');
+        c = next_char(src);
+    }
+    if (!is_space(c))
+        return -1;
+    *value = n;
+    return 0;
+}
+
+static int parse_header(pnm_source_t* src, pnm_header_t* hdr) {
+    const int p = next_char(src);
+    const int kind = next_char(src);
+    if (p != 'P' || (kind != '5' && kind != '6'))
+        return -1;
+
+    size_t width, height, maxval;
+    if (read_field(src, &width) != 0 || read_field(src, &height) != 0 ||
+        read_field(src, &maxval) != 0)
+        return -1;
+    if (width == 0 || height == 0 || maxval == 0 || maxval > 65535)
+        return -1;
+
+    hdr->channels = kind == '5' ? 1 : 3;
+    hdr->width = width;
+    hdr->height = height;
+    hdr->maxval = (uint16_t)maxval;
+    hdr->data_offset = src->pos;
+    return raster_bytes(hdr) == SIZE_MAX ? -1 : 0;
+}
+
+int pnm_parse_header(const uint8_t* data, size_t size, pnm_header_t* hdr) {
+    if (!data || !hdr)
+        return -1;
+    pnm_source_t src = { NULL, data, size, 0 };
+    if (parse_header(&src, hdr) != 0)
+        return -1;
+    return size - hdr->data_offset >= raster_bytes(hdr) ? 0 : -1;
+}
+
+int pnm_read_header(FILE* file, pnm_header_t* hdr) {
+    if (!file || !hdr)
+        return -1;
+    const long start = ftell(file);
+    pnm_source_t src = { file, NULL, 0, start < 0 ? 0 : (size_t)start };
+    return parse_header(&src, hdr);
+}
+
+// -----------------------------------------------------------------------------
+// Raster Decoding
+// -----------------------------------------------------------------------------
+
+static void decode_u16(const uint8_t* raw, size_t n, size_t size, uint16_t* out) {
+    if (size == 2) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = load_be16(raw + 2 * i);
+    } else {
+        for (size_t i = 0; i < n; i++)
+            out[i] = raw[i];
+    }
+}
+
+static void decode_f32(const uint8_t* raw, size_t n, size_t size, float scale, float* out) {
+    if (size == 2) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = (float)load_be16(raw + 2 * i) * scale;
+    } else {
+        for (size_t i = 0; i < n; i++)
+            out[i] = (float)raw[i] * scale;
+    }
+}
+
+int pnm_decode_u16(const pnm_header_t* hdr, const uint8_t* raw, uint16_t* out) {
+    if (!hdr || !raw || !out || raster_bytes(hdr) == SIZE_MAX)
+        return -1;
+    decode_u16(raw, pnm_sample_count(hdr), sample_size(hdr), out);
+    return 0;
+}
+
+int pnm_decode_f32(const pnm_header_t* hdr, const uint8_t* raw, float* out) {
+    if (!hdr || !raw || !out || hdr->maxval == 0 || raster_bytes(hdr) == SIZE_MAX)
+        return -1;
+    decode_f32(raw, pnm_sample_count(hdr), sample_size(hdr), 1.0f / hdr->maxval, out);
+    return 0;
+}
+
+int pnm_read_u16(FILE* file, const pnm_header_t* hdr, uint16_t* out) {
+    if (!file || !hdr || !out || raster_bytes(hdr) == SIZE_MAX)
+        return -1;
+
+    // 16-bit samples are read straight into the caller buffer and swapped
+    // in place; 8-bit samples are widened through a staging buffer.
+    const size_t n = pnm_sample_count(hdr);
+    if (sample_size(hdr) == 2)
+        return read_uint16_t_be(file, out, n);
+
+    uint8_t buffer[PNM_BUFFER_SIZE];
+    for (size_t done = 0; done < n; ) {
+        const size_t batch = n - done < sizeof(buffer) ? n - done : sizeof(buffer);
+        if (fread(buffer, 1, batch, file) != batch)
+            return -1;
+        decode_u16(buffer, batch, 1, out + done);
+        done += batch;
+    }
+    return 0;
+}
+
+int pnm_read_f32(FILE* file, const pnm_header_t* hdr, float* out) {
+    if (!file || !hdr || !out || hdr->maxval == 0 || raster_bytes(hdr) == SIZE_MAX)
+        return -1;
+
+    const size_t n = pnm_sample_count(hdr);
+    const size_t size = sample_size(hdr);
+    const float scale = 1.0f / hdr->maxval;
+    uint8_t buffer[PNM_BUFFER_SIZE];
+    const size_t block = sizeof(buffer) / size;
+
+    for (size_t done = 0; done < n; ) {
+        const size_t batch = n - done < block ? n - done : block;
+        if (fread(buffer, size, batch, file) != batch)
+            return -1;
+        decode_f32(buffer, batch, size, scale, out + done);
+        done += batch;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Writing
+// -----------------------------------------------------------------------------
+
+int pnm_write_u16(FILE* file, const pnm_header_t* hdr, const uint16_t* in) {
+    if (!file || !hdr || !in || hdr->maxval == 0 || (hdr->channels != 1 && hdr->channels != 3) ||
+        raster_bytes(hdr) == SIZE_MAX)
+        return -1;
+
+    if (fprintf(file, "P%c\n%zu %zu\n%u\n", hdr->channels == 1 ? '5' : '6',
+                hdr->width, hdr->height, (unsigned)hdr->maxval) < 0)
+        return -1;
+
+    const size_t n = pnm_sample_count(hdr);
+    if (sample_size(hdr) == 2)
+        return write_uint16_t_be(file, in, n);
+
+    uint8_t buffer[PNM_BUFFER_SIZE];
+    for (size_t done = 0; done < n; ) {
+        const size_t batch = n - done < sizeof(buffer) ? n - done : sizeof(buffer);
+        for (size_t i = 0; i < batch; i++)
+            buffer[i] = (uint8_t)in[done + i];
+        if (fwrite(buffer, 1, batch, file) != batch)
+            return -1;
+        done += batch;
+    }
+    return 0;
+}
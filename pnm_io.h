@@ -0,0 +1,99 @@
+#ifndef PNM_IO_H
+#define PNM_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Header of a binary PGM (P5) or PPM (P6) image.
+typedef struct {
+    unsigned channels;      ///< 1 for PGM, 3 for PPM
+    size_t width;
+    size_t height;
+    uint16_t maxval;        ///< Samples above 255 are stored as 16-bit big-endian
+    size_t data_offset;     ///< Offset of the raster from the source start
+} pnm_header_t;
+
+/**
+ * @brief Returns the number of samples in the raster (width * height * channels),
+ *        or SIZE_MAX if the product overflows. Headers whose raster size does
+ *        not fit in size_t are rejected by the parsers and I/O functions.
+ */
+size_t pnm_sample_count(const pnm_header_t* hdr);
+
+/**
+ * @brief Parses a P5/P6 header from memory, e.g. an mmapped file.
+ *
+ * @param data  Start of the file.
+ * @param size  Number of bytes available.
+ * @param hdr   Receives the header.
+ * @return 0 on success, -1 on malformed or truncated input.
+ */
+int pnm_parse_header(const uint8_t* data, size_t size, pnm_header_t* hdr);
+
+/**
+ * @brief Reads a P5/P6 header, leaving the file at the raster.
+ *
+ * @param file  Open binary file positioned at the magic number.
+ * @param hdr   Receives the header.
+ * @return 0 on success, -1 on error.
+ */
+int pnm_read_header(FILE* file, pnm_header_t* hdr);
+
+/**
+ * @brief Decodes a raster held in memory into native uint16_t samples.
+ *
+ * 8-bit rasters are widened; 16-bit rasters are swapped in one pass.
+ *
+ * @param hdr  Image header.
+ * @param raw  Raster as stored in the file.
+ * @param out  Output array of pnm_sample_count(hdr) samples.
+ * @return 0 on success, -1 on error.
+ */
+int pnm_decode_u16(const pnm_header_t* hdr, const uint8_t* raw, uint16_t* out);
+
+/**
+ * @brief Decodes a raster held in memory into floats normalized to [0, 1].
+ *
+ * The byte swap and the division by maxval are fused into one pass.
+ *
+ * @param hdr  Image header.
+ * @param raw  Raster as stored in the file.
+ * @param out  Output array of pnm_sample_count(hdr) samples.
+ * @return 0 on success, -1 on error.
+ */
+int pnm_decode_f32(const pnm_header_t* hdr, const uint8_t* raw, float* out);
+
+/**
+ * @brief Reads the raster that follows the header into a caller buffer.
+ *
+ * @param file  Open binary file positioned at the raster.
+ * @param hdr   Header from pnm_read_header().
+ * @param out   Output array of pnm_sample_count(hdr) samples.
+ * @return 0 on success, -1 on error.
+ */
+int pnm_read_u16(FILE* file, const pnm_header_t* hdr, uint16_t* out);
+
+/// Normalized float counterpart of pnm_read_u16().
+int pnm_read_f32(FILE* file, const pnm_header_t* hdr, float* out);
+
+/**
+ * @brief Writes a P5/P6 image.
+ *
+ * Samples are written as 16-bit big-endian when maxval exceeds 255 and as
+ * bytes otherwise.
+ *
+ * @param file  Open binary file for writing.
+ * @param hdr   Image header (data_offset is ignored).
+ * @param in    pnm_sample_count(hdr) samples, each at most maxval.
+ * @return 0 on success, -1 on error.
+ */
+int pnm_write_u16(FILE* file, const pnm_header_t* hdr, const uint16_t* in);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PNM_IO_H
@@ -0,0 +1,205 @@
+#include "segy_io.h"
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define SEGY_FILE_HEADER_SIZE (SEGY_TEXT_HEADER_SIZE + SEGY_BINARY_HEADER_SIZE)
+#define SEGY_BUFFER_SIZE 65536
+
+// Binary file header field offsets (relative to the binary header)
+#define SEGY_BIN_SAMPLE_INTERVAL 16
+#define SEGY_BIN_SAMPLES 20
+#define SEGY_BIN_FORMAT 24
+#define SEGY_BIN_EXTENDED_HEADERS 304
+
+// -----------------------------------------------------------------------------
+// Sample Conversion
+// -----------------------------------------------------------------------------
+
+void segy_ibm_to_float(const uint8_t* raw, size_t n, float* out) {
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t ibm = load_be32(raw + 4 * i);
+        const uint32_t sign = ibm & 0x80000000u;
+        const uint32_t exponent = (ibm >> 24) & 0x7F;
+        const uint32_t fraction = ibm & 0x00FFFFFFu;
+
+        // value = fraction * 2^-24 * 16^(exponent - 64). The scale is built
+        // directly as double bits; the product is exact in double and is
+        // rounded once when narrowing to float.
+        const uint64_t scale_bits = (uint64_t)(4 * exponent + 1023 - 280) << 52;
+        double scale;
+        memcpy(&scale, &scale_bits, sizeof(scale));
+        const float magnitude = (float)((double)fraction * scale);
+
+        uint32_t bits;
+        memcpy(&bits, &magnitude, sizeof(bits));
+        bits |= sign;
+        memcpy(&out[i], &bits, sizeof(bits));
+    }
+}
+
+static void decode_samples(const uint8_t* raw, size_t n, segy_format_t format, float* out) {
+    switch (format) {
+        case SEGY_FORMAT_IBM_FLOAT:
+            segy_ibm_to_float(raw, n, out);
+            break;
+        case SEGY_FORMAT_INT32:
+            for (size_t i = 0; i < n; i++)
+                out[i] = (float)(int32_t)load_be32(raw + 4 * i);
+            break;
+        case SEGY_FORMAT_INT16:
+            for (size_t i = 0; i < n; i++)
+                out[i] = (float)(int16_t)load_be16(raw + 2 * i);
+            break;
+        case SEGY_FORMAT_IEEE_FLOAT:
+            for (size_t i = 0; i < n; i++) {
+                const uint32_t bits = load_be32(raw + 4 * i);
+                memcpy(&out[i], &bits, sizeof(bits));
+            }
+            break;
+        case SEGY_FORMAT_INT8:
+            for (size_t i = 0; i < n; i++)
+                out[i] = (float)(int8_t)raw[i];
+            break;
+    }
+}
+
+static void decode_trace_header(const uint8_t* h, segy_trace_header_t* out) {
+    out->trace_sequence    = (int32_t)load_be32(h + 0);
+    out->field_record      = (int32_t)load_be32(h + 8);
+    out->cdp               = (int32_t)load_be32(h + 20);
+    out->coordinate_scalar = (int16_t)load_be16(h + 70);
+    out->source_x          = (int32_t)load_be32(h + 72);
+    out->source_y          = (int32_t)load_be32(h + 76);
+    out->group_x           = (int32_t)load_be32(h + 80);
+    out->group_y           = (int32_t)load_be32(h + 84);
+    out->num_samples       = load_be16(h + 114);
+    out->sample_interval   = load_be16(h + 116);
+    out->inline_number     = (int32_t)load_be32(h + 188);
+    out->crossline_number  = (int32_t)load_be32(h + 192);
+}
+
+// Decodes count consecutive traces that are already in memory.
+static void decode_trace_run(const uint8_t* traces, size_t count, const segy_header_t* header,
+                             segy_trace_header_t* headers, float* samples) {
+    for (size_t t = 0; t < count; t++) {
+        const uint8_t* trace = traces + t * header->trace_size;
+        if (headers)
+            decode_trace_header(trace, &headers[t]);
+        if (samples)
+            decode_samples(trace + SEGY_TRACE_HEADER_SIZE, header->samples_per_trace,
+                           header->format, samples + t * header->samples_per_trace);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// File Layout
+// -----------------------------------------------------------------------------
+
+static int parse_binary_header(const uint8_t* bin, segy_header_t* header) {
+    header->sample_interval = load_be16(bin + SEGY_BIN_SAMPLE_INTERVAL);
+    header->samples_per_trace = load_be16(bin + SEGY_BIN_SAMPLES);
+    header->format = (segy_format_t)load_be16(bin + SEGY_BIN_FORMAT);
+    header->extended_headers = load_be16(bin + SEGY_BIN_EXTENDED_HEADERS);
+
+    switch (header->format) {
+        case SEGY_FORMAT_IBM_FLOAT:
+        case SEGY_FORMAT_INT32:
+        case SEGY_FORMAT_IEEE_FLOAT: header->sample_size = 4; break;
+        case SEGY_FORMAT_INT16:      header->sample_size = 2; break;
+        case SEGY_FORMAT_INT8:       header->sample_size = 1; break;
+        default: return -1;
+    }
+
+    header->trace_size = SEGY_TRACE_HEADER_SIZE +
+                         (size_t)header->samples_per_trace * header->sample_size;
+    header->data_offset = SEGY_FILE_HEADER_SIZE +
+                          (size_t)header->extended_headers * SEGY_TEXT_HEADER_SIZE;
+    return 0;
+}
+
+int segy_parse_header(const uint8_t* data, size_t size, segy_header_t* header) {
+    if (!data || !header || size < SEGY_FILE_HEADER_SIZE)
+        return -1;
+    if (parse_binary_header(data + SEGY_TEXT_HEADER_SIZE, header) != 0)
+        return -1;
+    return size >= header->data_offset ? 0 : -1;
+}
+
+int segy_read_header(FILE* file, segy_header_t* header) {
+    if (!file || !header)
+        return -1;
+
+    uint8_t bin[SEGY_BINARY_HEADER_SIZE];
+    if (fseek(file, SEGY_TEXT_HEADER_SIZE, SEEK_CUR) != 0 ||
+        fread(bin, 1, sizeof(bin), file) != sizeof(bin))
+        return -1;
+    if (parse_binary_header(bin, header) != 0)
+        return -1;
+
+    const size_t skip = (size_t)header->extended_headers * SEGY_TEXT_HEADER_SIZE;
+    if (skip > (size_t)LONG_MAX)
+        return -1;
+    return fseek(file, (long)skip, SEEK_CUR) == 0 ? 0 : -1;
+}
+
+size_t segy_trace_count(const segy_header_t* header, size_t file_size) {
+    if (!header || file_size < header->data_offset)
+        return 0;
+    return (file_size - header->data_offset) / header->trace_size;
+}
+
+// -----------------------------------------------------------------------------
+// Trace Decoding
+// -----------------------------------------------------------------------------
+
+int segy_decode_traces(const uint8_t* data, size_t size, const segy_header_t* header,
+                       size_t first, size_t count,
+                       segy_trace_header_t* headers, float* samples) {
+    if (!data || !header)
+        return -1;
+
+    const size_t available = segy_trace_count(header, size);
+    if (first > available || count > available - first)
+        return -1;
+
+    decode_trace_run(data + header->data_offset + first * header->trace_size,
+                     count, header, headers, samples);
+    return 0;
+}
+
+int segy_read_traces(FILE* file, const segy_header_t* header, size_t first, size_t count,
+                     segy_trace_header_t* headers, float* samples) {
+    if (!file || !header)
+        return -1;
+    if (count == 0)
+        return 0;
+    if (first > ((size_t)LONG_MAX - header->data_offset) / header->trace_size)
+        return -1;
+
+    // Whole traces are read in large blocks and decoded from the buffer
+    const size_t block = header->trace_size < SEGY_BUFFER_SIZE
+                         ? SEGY_BUFFER_SIZE / header->trace_size : 1;
+    uint8_t* buffer = (uint8_t*)malloc(block * header->trace_size);
+    if (!buffer)
+        return -1;
+
+    int status = 0;
+    if (fseek(file, (long)(header->data_offset + first * header->trace_size), SEEK_SET) != 0)
+        status = -1;
+
+    for (size_t done = 0; done < count && status == 0; ) {
+        const size_t batch = count - done < block ? count - done : block;
+        if (fread(buffer, header->trace_size, batch, file) != batch) {
+            status = -1;
+            break;
+        }
+        decode_trace_run(buffer, batch, header,
+                         headers ? headers + done : NULL,
+                         samples ? samples + done * header->samples_per_trace : NULL);
+        done += batch;
+    }
+
+    free(buffer);
+    return status;
+}
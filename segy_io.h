@@ -0,0 +1,123 @@
+#ifndef SEGY_IO_H
+#define SEGY_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEGY_TEXT_HEADER_SIZE 3200
+#define SEGY_BINARY_HEADER_SIZE 400
+#define SEGY_TRACE_HEADER_SIZE 240
+
+/// Data sample format codes from the binary file header.
+typedef enum {
+    SEGY_FORMAT_IBM_FLOAT = 1,  ///< 4-byte IBM System/360 hexadecimal float
+    SEGY_FORMAT_INT32     = 2,  ///< 4-byte two's complement integer
+    SEGY_FORMAT_INT16     = 3,  ///< 2-byte two's complement integer
+    SEGY_FORMAT_IEEE_FLOAT = 5, ///< 4-byte IEEE float
+    SEGY_FORMAT_INT8      = 8   ///< 1-byte two's complement integer
+} segy_format_t;
+
+/// Layout of a SEG-Y file, taken from the binary file header.
+typedef struct {
+    segy_format_t format;       ///< Data sample format code
+    uint16_t sample_interval;   ///< Sample interval in microseconds
+    uint16_t samples_per_trace; ///< Samples in every trace (fixed-length traces)
+    uint16_t extended_headers;  ///< Number of extended textual headers
+    size_t sample_size;         ///< Bytes per sample
+    size_t trace_size;          ///< Bytes per trace including its header
+    size_t data_offset;         ///< Offset of the first trace from the file start
+} segy_header_t;
+
+/// Commonly used fields of a 240-byte trace header.
+typedef struct {
+    int32_t trace_sequence;     ///< Trace sequence number within line (bytes 1-4)
+    int32_t field_record;       ///< Original field record number (bytes 9-12)
+    int32_t cdp;                ///< Ensemble (CDP) number (bytes 21-24)
+    int16_t coordinate_scalar;  ///< Scalar applied to coordinates (bytes 71-72)
+    int32_t source_x;           ///< Source coordinate X (bytes 73-76)
+    int32_t source_y;           ///< Source coordinate Y (bytes 77-80)
+    int32_t group_x;            ///< Group coordinate X (bytes 81-84)
+    int32_t group_y;            ///< Group coordinate Y (bytes 85-88)
+    uint16_t num_samples;       ///< Number of samples in this trace (bytes 115-116)
+    uint16_t sample_interval;   ///< Sample interval in microseconds (bytes 117-118)
+    int32_t inline_number;      ///< In-line number (bytes 189-192)
+    int32_t crossline_number;   ///< Cross-line number (bytes 193-196)
+} segy_trace_header_t;
+
+/**
+ * @brief Converts big-endian IBM hexadecimal floats to native IEEE floats.
+ *
+ * The byte swap and format conversion are a single branch-free pass; values
+ * outside the float range become infinity or are flushed toward zero.
+ *
+ * @param raw  n big-endian IBM floats.
+ * @param n    Number of values.
+ * @param out  Output array of n floats.
+ */
+void segy_ibm_to_float(const uint8_t* raw, size_t n, float* out);
+
+/**
+ * @brief Parses the textual and binary file headers from memory.
+ *
+ * @param data    Start of the file, e.g. an mmapped region.
+ * @param size    Number of bytes available.
+ * @param header  Receives the file layout.
+ * @return 0 on success, -1 on truncated input or unsupported sample format.
+ */
+int segy_parse_header(const uint8_t* data, size_t size, segy_header_t* header);
+
+/**
+ * @brief Reads the file headers, leaving the file at the first trace.
+ *
+ * @param file    Open binary file positioned at the start.
+ * @param header  Receives the file layout.
+ * @return 0 on success, -1 on error.
+ */
+int segy_read_header(FILE* file, segy_header_t* header);
+
+/**
+ * @brief Returns the number of complete traces in a file of the given size.
+ */
+size_t segy_trace_count(const segy_header_t* header, size_t file_size);
+
+/**
+ * @brief Decodes a range of traces from memory into native floats.
+ *
+ * Ranges are independent, so large surveys can be decoded in parallel by
+ * giving each thread its own [first, first + count) range.
+ *
+ * @param data     Start of the file.
+ * @param size     Number of bytes available.
+ * @param header   File layout from segy_parse_header().
+ * @param first    Index of the first trace.
+ * @param count    Number of traces.
+ * @param headers  Output array of count trace headers, or NULL.
+ * @param samples  Output array of count * samples_per_trace floats, or NULL.
+ * @return 0 on success, -1 if the range exceeds the data.
+ */
+int segy_decode_traces(const uint8_t* data, size_t size, const segy_header_t* header,
+                       size_t first, size_t count,
+                       segy_trace_header_t* headers, float* samples);
+
+/**
+ * @brief Reads a range of traces from a file into native floats.
+ *
+ * @param file     Open binary file.
+ * @param header   File layout from segy_read_header().
+ * @param first    Index of the first trace.
+ * @param count    Number of traces.
+ * @param headers  Output array of count trace headers, or NULL.
+ * @param samples  Output array of count * samples_per_trace floats, or NULL.
+ * @return 0 on success, -1 on error.
+ */
+int segy_read_traces(FILE* file, const segy_header_t* header, size_t first, size_t count,
+                     segy_trace_header_t* headers, float* samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEGY_IO_H
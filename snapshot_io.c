@@ -0,0 +1,125 @@
+#include "snapshot_io.h"
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+// -----------------------------------------------------------------------------
+// Chunk Hashing
+// -----------------------------------------------------------------------------
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Word-at-a-time multiply/rotate hash; only used to detect changes
+static uint64_t chunk_hash(const uint8_t* data, size_t len) {
+    const uint64_t p1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t p2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t h = p2 ^ (uint64_t)len;
+
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = rotl64(h ^ (w * p2), 31) * p1;
+    }
+    uint64_t tail = 0;
+    for (size_t k = 0; i + k < len; k++)
+        tail |= (uint64_t)data[i + k] << (8 * k);
+    h = rotl64(h ^ (tail * p2), 31) * p1;
+
+    h ^= h >> 33;
+    h *= p2;
+    h ^= h >> 29;
+    return h;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+int snapshot_init(snapshot_writer_t* sw, FILE* file, uint64_t offset, size_t elem_size,
+                  size_t count, size_t chunk_bytes, int big_endian) {
+    if (!sw || !file || elem_size == 0)
+        return -1;
+    memset(sw, 0, sizeof(*sw));
+
+    const size_t chunk_elems = chunk_bytes / elem_size ? chunk_bytes / elem_size : 1;
+    if (count > SIZE_MAX / elem_size)
+        return -1;
+
+    sw->file = file;
+    sw->offset = offset;
+    sw->elem_size = elem_size;
+    sw->count = count;
+    sw->chunk_elems = chunk_elems;
+    sw->num_chunks = count / chunk_elems + (count % chunk_elems != 0);
+    sw->big_endian = big_endian != 0;
+    if (sw->num_chunks > 0) {
+        sw->hashes = (uint64_t*)calloc(sw->num_chunks, sizeof(uint64_t));
+        if (!sw->hashes)
+            return -1;
+    }
+    return 0;
+}
+
+void snapshot_free(snapshot_writer_t* sw) {
+    if (!sw)
+        return;
+    free(sw->hashes);
+    sw->hashes = NULL;
+    sw->valid = 0;
+}
+
+void snapshot_invalidate(snapshot_writer_t* sw) {
+    if (sw)
+        sw->valid = 0;
+}
+
+int snapshot_write(snapshot_writer_t* sw, const void* data, uint64_t* bytes_written) {
+    if (!sw || !sw->file || (!data && sw->count))
+        return -1;
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    const size_t chunk_size = sw->chunk_elems * sw->elem_size;
+    uint64_t written = 0;
+    int positioned = 0;     // file is at the start of chunk c
+
+    for (size_t c = 0; c < sw->num_chunks; c++) {
+        const size_t first = c * sw->chunk_elems;
+        const size_t n = sw->count - first < sw->chunk_elems ? sw->count - first : sw->chunk_elems;
+        const uint8_t* chunk = bytes + first * sw->elem_size;
+        const uint64_t h = chunk_hash(chunk, n * sw->elem_size);
+
+        if (sw->valid && h == sw->hashes[c]) {
+            positioned = 0;
+            continue;
+        }
+
+        // Seek only at the start of a run of dirty chunks
+        if (!positioned) {
+            const uint64_t pos = sw->offset + (uint64_t)c * chunk_size;
+            if (pos > (uint64_t)LONG_MAX || fseek(sw->file, (long)pos, SEEK_SET) != 0)
+                goto fail;
+            positioned = 1;
+        }
+        const int rc = sw->big_endian ? write_be(sw->file, chunk, n, sw->elem_size)
+                                      : write_le(sw->file, chunk, n, sw->elem_size);
+        if (rc != 0)
+            goto fail;
+        sw->hashes[c] = h;
+        written += (uint64_t)n * sw->elem_size;
+    }
+
+    // Only a flushed snapshot may serve as the baseline for the next one
+    if (fflush(sw->file) != 0)
+        goto fail;
+    sw->valid = 1;
+    if (bytes_written)
+        *bytes_written = written;
+    return 0;
+
+fail:
+    sw->valid = 0;
+    return -1;
+}
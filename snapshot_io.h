@@ -0,0 +1,71 @@
+#ifndef SNAPSHOT_IO_H
+#define SNAPSHOT_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Incremental writer for repeated snapshots of one in-memory array into a
+ * fixed region of a file. A 64-bit hash of every chunk is kept from the
+ * previous snapshot; chunks whose hash is unchanged are neither re-encoded
+ * nor rewritten.
+ */
+typedef struct {
+    FILE* file;
+    uint64_t offset;        ///< File offset of the first element
+    size_t elem_size;       ///< Element size in bytes
+    size_t count;           ///< Number of elements
+    size_t chunk_elems;     ///< Elements per chunk
+    size_t num_chunks;
+    int big_endian;         ///< Byte order in the file
+    int valid;              ///< 0 until the file holds a complete snapshot
+    uint64_t* hashes;       ///< Hash of each chunk as last written
+} snapshot_writer_t;
+
+/**
+ * @brief Sets up a snapshot writer.
+ *
+ * @param sw           Writer to initialize.
+ * @param file         File opened for update ("r+b" or "w+b").
+ * @param offset       File offset of the array.
+ * @param elem_size    Element size in bytes.
+ * @param count        Number of elements in the array.
+ * @param chunk_bytes  Approximate chunk size, rounded down to whole elements
+ *                     (at least one).
+ * @param big_endian   1 to store elements big-endian, 0 for little-endian.
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int snapshot_init(snapshot_writer_t* sw, FILE* file, uint64_t offset, size_t elem_size,
+                  size_t count, size_t chunk_bytes, int big_endian);
+
+/// Releases the chunk hashes.
+void snapshot_free(snapshot_writer_t* sw);
+
+/**
+ * @brief Forces the next snapshot_write() to rewrite every chunk, e.g. after
+ *        the file was modified by someone else.
+ */
+void snapshot_invalidate(snapshot_writer_t* sw);
+
+/**
+ * @brief Writes a snapshot, rewriting only the chunks that changed.
+ *
+ * The first call writes everything. Consecutive dirty chunks are written
+ * with a single seek. If a write or the final flush fails the writer is
+ * invalidated, so the next call rewrites the whole array.
+ *
+ * @param sw             Writer.
+ * @param data           Array of count host-order elements.
+ * @param bytes_written  Optional; receives the number of bytes rewritten.
+ * @return 0 on success, -1 on error.
+ */
+int snapshot_write(snapshot_writer_t* sw, const void* data, uint64_t* bytes_written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAPSHOT_IO_H
@@ -0,0 +1,116 @@
+#include "template_io.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Building
+// -----------------------------------------------------------------------------
+
+void header_template_init(header_template_t* t) {
+    if (t)
+        memset(t, 0, sizeof(*t));
+}
+
+static inline int valid_size(size_t size) {
+    return size == 1 || size == 2 || size == 4 || size == 8;
+}
+
+int header_template_put(header_template_t* t, uint64_t value, size_t size, int big_endian) {
+    if (!t || !valid_size(size) || TEMPLATE_MAX_SIZE - t->size < size) {
+        if (t)
+            t->error = 1;
+        return -1;
+    }
+    store_sized(t->bytes + t->size, value, size, big_endian);
+    t->size += size;
+    return 0;
+}
+
+int header_template_put_bytes(header_template_t* t, const uint8_t* data, size_t len) {
+    if (!t || (!data && len) || TEMPLATE_MAX_SIZE - t->size < len) {
+        if (t)
+            t->error = 1;
+        return -1;
+    }
+    if (len)
+        memcpy(t->bytes + t->size, data, len);
+    t->size += len;
+    return 0;
+}
+
+int header_template_field(header_template_t* t, size_t size, int big_endian) {
+    if (!t || !valid_size(size) || TEMPLATE_MAX_SIZE - t->size < size ||
+        t->num_fields == TEMPLATE_MAX_FIELDS) {
+        if (t)
+            t->error = 1;
+        return -1;
+    }
+    template_field_t* f = &t->fields[t->num_fields];
+    f->offset = (uint16_t)t->size;
+    f->size = (uint8_t)size;
+    f->big_endian = big_endian != 0;
+    memset(t->bytes + t->size, 0, size);
+    t->size += size;
+    return (int)t->num_fields++;
+}
+
+// -----------------------------------------------------------------------------
+// Stamping
+// -----------------------------------------------------------------------------
+
+// Copies the template and patches its variable fields
+static inline void stamp_one(const header_template_t* t, uint8_t* out, const uint64_t* values) {
+    memcpy(out, t->bytes, t->size);
+    for (size_t i = 0; i < t->num_fields; i++) {
+        const template_field_t* f = &t->fields[i];
+        store_sized(out + f->offset, values[i], f->size, f->big_endian);
+    }
+}
+
+int header_template_stamp(const header_template_t* t, uint8_t* out,
+                          const uint64_t* values, size_t count) {
+    if (!t || t->error || (count && (!out || (!values && t->num_fields))))
+        return -1;
+    for (size_t c = 0; c < count; c++)
+        stamp_one(t, out + c * t->size, values + c * t->num_fields);
+    return 0;
+}
+
+int template_writer_init(template_writer_t* w, FILE* file, const header_template_t* tmpl) {
+    if (!file)
+        return -1;
+    endian_sink_t sink;
+    endian_sink_from_file(&sink, file);
+    return template_writer_init_sink(w, &sink, tmpl);
+}
+
+int template_writer_init_sink(template_writer_t* w, const endian_sink_t* sink,
+                              const header_template_t* tmpl) {
+    if (!w || !sink || !sink->write || !tmpl || tmpl->error)
+        return -1;
+    endian_writer_init(&w->out, sink, w->buffer, sizeof(w->buffer));
+    w->tmpl = tmpl;
+    return 0;
+}
+
+int template_writer_emit(template_writer_t* w, const uint64_t* values) {
+    if (!w || (!values && w->tmpl->num_fields))
+        return -1;
+    uint8_t* dst = endian_writer_reserve(&w->out, w->tmpl->size);
+    if (!dst)
+        return -1;
+    stamp_one(w->tmpl, dst, values);
+    w->out.fill += w->tmpl->size;
+    return 0;
+}
+
+int template_writer_write(template_writer_t* w, const uint8_t* data, size_t len) {
+    if (!w || (!data && len))
+        return -1;
+    return endian_writer_write(&w->out, data, len);
+}
+
+int template_writer_flush(template_writer_t* w) {
+    if (!w)
+        return -1;
+    return endian_writer_flush(&w->out);
+}
@@ -0,0 +1,113 @@
+#ifndef TEMPLATE_IO_H
+#define TEMPLATE_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEMPLATE_MAX_SIZE 256
+#define TEMPLATE_MAX_FIELDS 32
+#define TEMPLATE_BUFFER_SIZE 65536
+
+/// Variable field of a template.
+typedef struct {
+    uint16_t offset;
+    uint8_t size;           ///< 1, 2, 4 or 8
+    uint8_t big_endian;
+} template_field_t;
+
+/**
+ * Header encoded once in wire order. Constant parts are stored as bytes;
+ * variable fields are patched into each copy with inline stores.
+ */
+typedef struct {
+    uint8_t bytes[TEMPLATE_MAX_SIZE];
+    size_t size;
+    template_field_t fields[TEMPLATE_MAX_FIELDS];
+    size_t num_fields;
+    int error;              ///< Set once an append has failed
+} header_template_t;
+
+/// Batched writer of stamped headers and payloads.
+typedef struct {
+    endian_writer_t out;    ///< Stages bytes in buffer for the sink
+    const header_template_t* tmpl;
+    uint8_t buffer[TEMPLATE_BUFFER_SIZE];
+} template_writer_t;
+
+// -----------------------------------------------------------------------------
+// Building
+// -----------------------------------------------------------------------------
+
+void header_template_init(header_template_t* t);
+
+/**
+ * @brief Appends a constant integer field.
+ *
+ * @param t           Template.
+ * @param value       Value in host order (truncated to size bytes).
+ * @param size        Field size: 1, 2, 4 or 8 bytes.
+ * @param big_endian  1 to store big-endian, 0 for little-endian.
+ * @return 0 on success, -1 on invalid size or if the template is full.
+ */
+int header_template_put(header_template_t* t, uint64_t value, size_t size, int big_endian);
+
+/// Appends constant raw bytes (magic numbers, padding, ...).
+int header_template_put_bytes(header_template_t* t, const uint8_t* data, size_t len);
+
+/**
+ * @brief Appends a variable integer field.
+ *
+ * @param t           Template.
+ * @param size        Field size: 1, 2, 4 or 8 bytes.
+ * @param big_endian  1 to store big-endian, 0 for little-endian.
+ * @return Index of the field in the values array passed to the stamp
+ *         functions, or -1 on invalid size or if the template is full.
+ */
+int header_template_field(header_template_t* t, size_t size, int big_endian);
+
+// -----------------------------------------------------------------------------
+// Stamping
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Writes count copies of the template into out.
+ *
+ * @param t       Template.
+ * @param out     Output of count * t->size bytes.
+ * @param values  count * t->num_fields host-order field values, one row per copy.
+ * @param count   Number of copies.
+ * @return 0 on success, -1 on invalid arguments or a failed template.
+ */
+int header_template_stamp(const header_template_t* t, uint8_t* out,
+                          const uint64_t* values, size_t count);
+
+/// Initializes a writer; the template must outlive it.
+int template_writer_init(template_writer_t* w, FILE* file, const header_template_t* tmpl);
+
+/// Sink counterpart of template_writer_init(); the sink is copied into w.
+int template_writer_init_sink(template_writer_t* w, const endian_sink_t* sink,
+                              const header_template_t* tmpl);
+
+/**
+ * @brief Stages one header stamped with values.
+ *
+ * @param w       Writer.
+ * @param values  t->num_fields host-order field values.
+ * @return 0 on success, -1 on error.
+ */
+int template_writer_emit(template_writer_t* w, const uint64_t* values);
+
+/// Stages raw bytes, e.g. the payload following a header.
+int template_writer_write(template_writer_t* w, const uint8_t* data, size_t len);
+
+/// Writes out the staged bytes.
+int template_writer_flush(template_writer_t* w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEMPLATE_IO_H
@@ -1,8 +1,1448 @@
 #include "endian_io.h"
+#include "cbor_io.h"
+#include "cdf_io.h"
+#include "fits_io.h"
+#include "jdata_io.h"
+#include "msgpack_io.h"
+#include "npy_io.h"
+#include "patch_io.h"
+#include "pcap_io.h"
+#include "pcm_io.h"
+#include "pnm_io.h"
+#include "segy_io.h"
+#include "snapshot_io.h"
+#include "template_io.h"
+#include "tiff_io.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Checks convert_be/convert_le against a per-element byte reversal for every
+// element size and for lengths that exercise both the block and tail paths.
+static int check_swap_kernels(void) {
+    uint8_t data[8 * 67], expected[8 * 67];
+    const size_t sizes[3] = {2, 4, 8};
+    uint16_t probe = 1;
+    const int host_little = *(uint8_t*)&probe == 1;
+
+    for (size_t s = 0; s < 3; ++s) {
+        const size_t size = sizes[s];
+        for (size_t num = 0; num <= 67; ++num) {
+            for (size_t i = 0; i < num * size; ++i)
+                data[i] = (uint8_t)(i * 7 + num);
+            for (size_t e = 0; e < num; ++e)
+                for (size_t b = 0; b < size; ++b)
+                    expected[e * size + b] = data[e * size + size - 1 - b];
+
+            // Exactly one of the two conversions swaps on any host
+            if ((host_little ? convert_be : convert_le)(data, num, size) != 0 ||
+                memcmp(data, expected, num * size) != 0) {
+                fprintf(stderr, "Swap kernel mismatch: size %zu, count %zu\n", size, num);
+                return -1;
+            }
+        }
+    }
+    printf("Swap kernels match the scalar reference\n");
+    return 0;
+}
+
+// Round-trips a frame-of-reference packed array in both bit orders.
+static int check_packed(void) {
+    uint32_t values[100], back[100];
+    for (size_t i = 0; i < 100; ++i)
+        values[i] = 1000000 + (uint32_t)(i * 37 % 500);
+
+    for (int order = 0; order < 2; ++order) {
+        FILE* f = tmpfile();
+        if (!f)
+            return -1;
+        memset(back, 0, sizeof(back));
+        const int ok = write_packed_u32(f, values, 100, (bit_order_t)order) == 0 &&
+                       fseek(f, 0, SEEK_SET) == 0 &&
+                       read_packed_u32(f, back, 100) == 0 &&
+                       memcmp(values, back, sizeof(values)) == 0;
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "Packed round trip failed: bit order %d\n", order);
+            return -1;
+        }
+    }
+    printf("Packed arrays round-trip\n");
+    return 0;
+}
+
+// Round-trips 1-, 2-, 4- and 8-byte elements through both byte-plane layouts.
+static int check_shuffle(void) {
+    uint8_t data[8 * 45], back[8 * 45];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = (uint8_t)(i * 13 + 5);
+
+    for (size_t size = 1; size <= 8; size *= 2) {
+        for (int big = 0; big < 2; ++big) {
+            FILE* f = tmpfile();
+            if (!f)
+                return -1;
+            memset(back, 0, sizeof(back));
+            const int ok = (big ? write_shuffle_be : write_shuffle_le)(f, data, 45, size) == 0 &&
+                           fseek(f, 0, SEEK_SET) == 0 &&
+                           (big ? read_shuffle_be : read_shuffle_le)(f, back, 45, size) == 0 &&
+                           memcmp(data, back, 45 * size) == 0;
+            fclose(f);
+            if (!ok) {
+                fprintf(stderr, "Shuffle round trip failed: size %zu, big-endian %d\n", size, big);
+                return -1;
+            }
+        }
+    }
+    printf("Byte-plane shuffle round-trips\n");
+    return 0;
+}
+
+// Round-trips mixed-width fields and a fixed-width array through the bit
+// writer and reader in both bit orders.
+static int check_bit_stream(void) {
+    static bit_writer_t bw;
+    static bit_reader_t br;
+    const unsigned widths[6] = {1, 3, 7, 13, 32, 56};
+    uint32_t arr[50], arr_back[50];
+    for (size_t i = 0; i < 50; ++i)
+        arr[i] = (uint32_t)(i * 2654435761u) & 0x7FF;
+
+    for (int order = 0; order < 2; ++order) {
+        FILE* f = tmpfile();
+        if (!f)
+            return -1;
+        int ok = bit_writer_init(&bw, f, (bit_order_t)order) == 0;
+        for (size_t i = 0; i < 6; ++i)
+            ok = ok && bit_writer_write(&bw, 0x00F0E1D2C3B4A596ULL + i, widths[i]) == 0;
+        ok = ok && bit_writer_write_array(&bw, 11, arr, 50) == 0 &&
+             bit_writer_flush(&bw) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+             bit_reader_init(&br, f, (bit_order_t)order) == 0;
+        for (size_t i = 0; i < 6 && ok; ++i) {
+            uint64_t value;
+            const uint64_t mask = (1ULL << widths[i]) - 1;
+            ok = bit_reader_read(&br, widths[i], &value) == 0 &&
+                 value == ((0x00F0E1D2C3B4A596ULL + i) & mask);
+        }
+        ok = ok && bit_reader_read_array(&br, 11, arr_back, 50) == 0 &&
+             memcmp(arr, arr_back, sizeof(arr)) == 0;
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "Bit stream round trip failed: bit order %d\n", order);
+            return -1;
+        }
+    }
+    printf("Bit streams round-trip\n");
+    return 0;
+}
+
+// Round-trips text covering 1- to 4-byte UTF-8 sequences (including a
+// surrogate pair in UTF-16) through all four encodings.
+static int check_utf(void) {
+    static const char text[] = "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80z";
+    const size_t len = sizeof(text) - 1;
+    typedef int (*utf_write_fn)(FILE*, const char*, size_t, size_t*);
+    typedef int (*utf_read_fn)(FILE*, size_t, char*, size_t, size_t*);
+    const utf_write_fn writers[4] = {write_utf16_be, write_utf16_le, write_utf32_be, write_utf32_le};
+    const utf_read_fn readers[4] = {read_utf16_be, read_utf16_le, read_utf32_be, read_utf32_le};
+    const size_t expected_units[4] = {6, 6, 5, 5};
+
+    for (size_t k = 0; k < 4; ++k) {
+        char back[32];
+        size_t units = 0, back_len = 0;
+        FILE* f = tmpfile();
+        if (!f)
+            return -1;
+        const int ok = writers[k](f, text, len, &units) == 0 && units == expected_units[k] &&
+                       fseek(f, 0, SEEK_SET) == 0 &&
+                       readers[k](f, units, back, sizeof(back), &back_len) == 0 &&
+                       back_len == len && memcmp(back, text, len) == 0;
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "UTF round trip failed: encoding %zu\n", k);
+            return -1;
+        }
+    }
+    printf("UTF-16/UTF-32 text round-trips\n");
+    return 0;
+}
+
+// Round-trips a string table, including empty and NULL entries, through the
+// stream reader and the zero-copy view parser in both byte orders.
+static int check_strings(void) {
+    const char* strs[5] = {"alpha", "", NULL, "a somewhat longer string", "z"};
+    const char* expected[5] = {"alpha", "", "", "a somewhat longer string", "z"};
+
+    for (int big = 0; big < 2; ++big) {
+        size_t offsets[6];
+        char* blob = NULL;
+        string_view_t views[5];
+        uint8_t raw[128];
+        size_t raw_size = 0, consumed = 0;
+        FILE* f = tmpfile();
+        if (!f)
+            return -1;
+        int ok = (big ? write_strings_be : write_strings_le)(f, strs, NULL, 5) == 0 &&
+                 fputc(0x7E, f) != EOF && fseek(f, 0, SEEK_SET) == 0 &&
+                 (raw_size = fread(raw, 1, sizeof(raw), f)) > 0 && fseek(f, 0, SEEK_SET) == 0 &&
+                 (big ? read_strings_be : read_strings_le)(f, 5, offsets, &blob, NULL) == 0 &&
+                 fgetc(f) == 0x7E &&
+                 (big ? view_strings_be : view_strings_le)(raw, raw_size, 5, views, &consumed) == 0 &&
+                 consumed == raw_size - 1;
+        for (size_t i = 0; i < 5 && ok; ++i) {
+            const size_t len = strlen(expected[i]);
+            ok = offsets[i + 1] - offsets[i] == len && views[i].length == len &&
+                 memcmp(blob + offsets[i], expected[i], len) == 0 &&
+                 memcmp(views[i].data, expected[i], len) == 0;
+        }
+        free(blob);
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "String table round trip failed: big-endian %d\n", big);
+            return -1;
+        }
+    }
+    printf("Length-prefixed strings round-trip\n");
+    return 0;
+}
+
+// Parses a small big-endian .npy file from memory, then round-trips npy_write output.
+static int check_npy(void) {
+    static const char dict[] = "{'descr': '>i2', 'fortran_order': False, 'shape': (2, 3), }\n";
+    const size_t text_len = sizeof(dict) - 1;
+    uint8_t file[128];
+    memcpy(file, "\x93NUMPY\x01\x00", 8);
+    file[8] = (uint8_t)text_len;
+    file[9] = 0;
+    memcpy(file + 10, dict, text_len);
+    for (size_t i = 0; i < 6; ++i) {
+        file[10 + text_len + 2 * i] = (uint8_t)(i == 5 ? 0xFF : 0x01);
+        file[10 + text_len + 2 * i + 1] = (uint8_t)i;
+    }
+
+    npy_header_t hdr;
+    const void* payload = NULL;
+    int16_t scratch[6];
+    if (npy_view(file, 10 + text_len + 12, &hdr, &payload, scratch) != 0 ||
+        hdr.kind != 'i' || hdr.item_size != 2 || !hdr.big_endian || hdr.ndim != 2 ||
+        hdr.shape[0] != 2 || hdr.shape[1] != 3 || npy_count(&hdr) != 6) {
+        fprintf(stderr, "NumPy header parse failed\n");
+        return -1;
+    }
+    const int16_t* values = (const int16_t*)payload;
+    if (values[0] != 0x0100 || values[4] != 0x0104 || values[5] != -251) {
+        fprintf(stderr, "NumPy payload mismatch\n");
+        return -1;
+    }
+
+    // Two arrays back to back: a 1-D int32 and a Fortran-order 2-D float64
+    const int32_t ints[3] = {-7, 0, 123456789};
+    const double reals[4] = {1.5, -2.25, 1e300, -0.0};
+    const size_t int_shape[1] = {3};
+    const size_t real_shape[2] = {2, 2};
+    int32_t ints_back[3];
+    double reals_back[4];
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    npy_header_t ih, rh;
+    int ok = npy_write(f, ints, 'i', 4, int_shape, 1, 0) == 0 &&
+             npy_write(f, reals, 'f', 8, real_shape, 2, 1) == 0 &&
+             fseek(f, 0, SEEK_SET) == 0 &&
+             npy_read_header(f, &ih) == 0 && ftell(f) % 64 == 0 &&
+             ih.kind == 'i' && ih.item_size == 4 && ih.ndim == 1 && ih.shape[0] == 3 &&
+             !ih.fortran_order && npy_read(f, &ih, ints_back) == 0 &&
+             npy_read_header(f, &rh) == 0 &&
+             rh.kind == 'f' && rh.item_size == 8 && rh.ndim == 2 && rh.shape[0] == 2 &&
+             rh.shape[1] == 2 && rh.fortran_order && npy_read(f, &rh, reals_back) == 0 &&
+             memcmp(ints, ints_back, sizeof(ints)) == 0 &&
+             memcmp(reals, reals_back, sizeof(reals)) == 0;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "NumPy write/read round trip failed\n");
+        return -1;
+    }
+    printf("NumPy fixture parses and files round-trip\n");
+    return 0;
+}
+
+// Parses a small 16-bit FITS image from memory and applies BSCALE/BZERO.
+static int check_fits(void) {
+    static const char* const cards[8] = {
+        "SIMPLE  =                    T", "BITPIX  =                   16",
+        "NAXIS   =                    2", "NAXIS1  =                    3",
+        "NAXIS2  =                    2", "BSCALE  =                  2.0",
+        "BZERO   =                 10.0", "END"
+    };
+    static uint8_t file[FITS_BLOCK_SIZE + 12];
+    static fits_hdu_t hdu;
+    memset(file, ' ', FITS_BLOCK_SIZE);
+    for (size_t i = 0; i < 8; ++i)
+        memcpy(file + i * FITS_CARD_SIZE, cards[i], strlen(cards[i]));
+    const int16_t pixels[6] = {0, 1, -1, 100, -100, 32767};
+    for (size_t i = 0; i < 6; ++i) {
+        file[FITS_BLOCK_SIZE + 2 * i] = (uint8_t)((uint16_t)pixels[i] >> 8);
+        file[FITS_BLOCK_SIZE + 2 * i + 1] = (uint8_t)pixels[i];
+    }
+
+    float out[6];
+    if (fits_parse_header(file, sizeof(file), &hdu) != 0 || hdu.bitpix != 16 ||
+        hdu.naxis != 2 || hdu.axes[0] != 3 || hdu.axes[1] != 2 ||
+        hdu.data_offset != FITS_BLOCK_SIZE || hdu.data_size != 12 ||
+        fits_decode_f32(file + hdu.data_offset, 6, &hdu, out) != 0) {
+        fprintf(stderr, "FITS header parse failed\n");
+        return -1;
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        if (out[i] != 10.0f + 2.0f * pixels[i]) {
+            fprintf(stderr, "FITS pixel %zu mismatch\n", i);
+            return -1;
+        }
+    }
+
+    // A 4x3x2 float image followed by a binary table extension, read from a file
+    static const char* const image_cards[7] = {
+        "SIMPLE  =                    T", "BITPIX  =                  -32",
+        "NAXIS   =                    3", "NAXIS1  =                    4",
+        "NAXIS2  =                    3", "NAXIS3  =                    2", "END"
+    };
+    static const char* const table_cards[12] = {
+        "XTENSION= 'BINTABLE'", "BITPIX  =                    8",
+        "NAXIS   =                    2", "NAXIS1  =                    8",
+        "NAXIS2  =                    3", "PCOUNT  =                    0",
+        "GCOUNT  =                    1", "TFIELDS =                    2",
+        "TFORM1  = 'J'", "TFORM2  = '2I'", "TSCAL2  =                  0.5", "END"
+    };
+    static char block[FITS_BLOCK_SIZE];
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    int ok = 1;
+    memset(block, ' ', sizeof(block));
+    for (size_t i = 0; i < 7; ++i)
+        memcpy(block + i * FITS_CARD_SIZE, image_cards[i], strlen(image_cards[i]));
+    ok = ok && fwrite(block, 1, sizeof(block), f) == sizeof(block);
+    memset(block, 0, sizeof(block));
+    for (size_t i = 0; i < 24; ++i) {
+        const float value = (float)(i % 4 + 10 * (i / 4 % 3) + 100 * (i / 12));
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        store_be32((uint8_t*)block + 4 * i, bits);
+    }
+    ok = ok && fwrite(block, 1, sizeof(block), f) == sizeof(block);
+    memset(block, ' ', sizeof(block));
+    for (size_t i = 0; i < 12; ++i)
+        memcpy(block + i * FITS_CARD_SIZE, table_cards[i], strlen(table_cards[i]));
+    ok = ok && fwrite(block, 1, sizeof(block), f) == sizeof(block);
+    memset(block, 0, sizeof(block));
+    for (size_t r = 0; r < 3; ++r) {
+        store_be32((uint8_t*)block + 8 * r, (uint32_t)-(int32_t)r);
+        store_be16((uint8_t*)block + 8 * r + 4, (uint16_t)(2 * r));
+        store_be16((uint8_t*)block + 8 * r + 6, (uint16_t)(2 * r + 1));
+    }
+    ok = ok && fwrite(block, 1, sizeof(block), f) == sizeof(block) && fseek(f, 0, SEEK_SET) == 0;
+
+    double image[24], column[4];
+    float planes[16], rows[6];
+    const size_t full_start[3] = {0, 1, 0}, full_count[3] = {4, 2, 2};
+    const size_t part_start[3] = {1, 0, 1}, part_count[3] = {2, 3, 1};
+    ok = ok && fits_read_header(f, &hdu) == 0 && hdu.naxis == 3 && hdu.data_size == 96 &&
+         fits_read_image_f64(f, &hdu, image) == 0 &&
+         fits_read_cutout_f32(f, &hdu, full_start, full_count, planes) == 0 &&
+         fits_read_cutout_f32(f, &hdu, part_start, part_count, rows) == 0;
+    for (size_t i = 0; i < 24 && ok; ++i)
+        ok = image[i] == (double)(i % 4 + 10 * (i / 4 % 3) + 100 * (i / 12));
+    // Full-width cutout: rows 1-2 of both planes; partial one: x 1-2 of plane 1
+    for (size_t i = 0; i < 16 && ok; ++i)
+        ok = planes[i] == (float)(i % 4 + 10 * (i / 4 % 2 + 1) + 100 * (i / 8));
+    for (size_t i = 0; i < 6 && ok; ++i)
+        ok = rows[i] == (float)(i % 2 + 1 + 10 * (i / 2) + 100);
+    ok = ok && fits_skip_data(f, &hdu) == 0 && fits_read_header(f, &hdu) == 0 &&
+         hdu.bintable && hdu.tfields == 2 &&
+         fits_read_column_f64(f, &hdu, 0, 1, 2, column) == 0 &&
+         column[0] == -1.0 && column[1] == -2.0 &&
+         fits_read_column_f64(f, &hdu, 1, 1, 2, column) == 0 &&
+         column[0] == 1.0 && column[1] == 1.5 && column[2] == 2.0 && column[3] == 2.5;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "FITS file read failed\n");
+        return -1;
+    }
+    printf("FITS fixture parses and file cutouts read back\n");
+    return 0;
+}
+
+// Parses a big-endian classic pcap and a little-endian pcapng capture with a
+// binary (2^-40 s) timestamp resolution from memory.
+static int check_pcap(void) {
+    static pcap_reader_t reader;
+    pcap_packet_t packets[4];
+    size_t count = 0;
+
+    uint8_t classic[24 + 2 * 20];
+    memset(classic, 0, sizeof(classic));
+    store_be32(classic, 0xA1B2C3D4u);
+    store_be16(classic + 4, 2);
+    store_be16(classic + 6, 4);
+    store_be32(classic + 16, 65535);
+    store_be32(classic + 20, 1);
+    for (uint32_t i = 0; i < 2; ++i) {
+        uint8_t* rec = classic + 24 + 20 * i;
+        store_be32(rec, 1000 + i);
+        store_be32(rec + 4, 250000);
+        store_be32(rec + 8, 4);
+        store_be32(rec + 12, 60);
+        store_be32(rec + 16, 0xC0FFEE00u + i);
+    }
+    if (pcap_open(&reader, classic, sizeof(classic)) != 0 || reader.format != PCAP_FORMAT_PCAP ||
+        !reader.big_endian || pcap_next_batch(&reader, packets, 4, &count) != 0 || count != 2 ||
+        packets[1].timestamp_ns != 1001250000000ULL || packets[1].linktype != 1 ||
+        packets[1].captured_length != 4 || packets[1].original_length != 60 ||
+        load_be32(packets[1].data) != 0xC0FFEE01u) {
+        fprintf(stderr, "Classic pcap parse failed\n");
+        return -1;
+    }
+
+    uint8_t ng[28 + 32 + 36];
+    memset(ng, 0, sizeof(ng));
+    store_le32(ng, 0x0A0D0D0Au);            // Section header block
+    store_le32(ng + 4, 28);
+    store_le32(ng + 8, 0x1A2B3C4Du);
+    store_le16(ng + 12, 1);
+    store_le64(ng + 16, UINT64_MAX);
+    store_le32(ng + 24, 28);
+    uint8_t* idb = ng + 28;                 // Interface with if_tsresol = 2^-40
+    store_le32(idb, 1);
+    store_le32(idb + 4, 32);
+    store_le16(idb + 8, 101);
+    store_le16(idb + 16, 9);
+    store_le16(idb + 18, 1);
+    idb[20] = 0x80 | 40;
+    store_le32(idb + 28, 32);
+    uint8_t* epb = idb + 32;                // Enhanced packet, t = 3.5 s
+    store_le32(epb, 6);
+    store_le32(epb + 4, 36);
+    store_le32(epb + 12, 0x380);
+    store_le32(epb + 20, 4);
+    store_le32(epb + 24, 4);
+    store_le32(epb + 28, 0x12345678u);
+    store_le32(epb + 32, 36);
+    if (pcap_open(&reader, ng, sizeof(ng)) != 0 || reader.format != PCAP_FORMAT_PCAPNG ||
+        pcap_next_batch(&reader, packets, 4, &count) != 0 || count != 1 ||
+        packets[0].timestamp_ns != 3500000000ULL || packets[0].linktype != 101 ||
+        load_le32(packets[0].data) != 0x12345678u) {
+        fprintf(stderr, "pcapng parse failed\n");
+        return -1;
+    }
+    printf("pcap and pcapng fixtures parse\n");
+    return 0;
+}
+
+// Parses a two-trace SEG-Y file with IBM float samples from memory.
+static int check_segy(void) {
+    static const uint32_t ibm[4] = {0x41100000u, 0xC1200000u, 0x40800000u, 0x42640000u};
+    static const float expected[4] = {1.0f, -2.0f, 0.5f, 100.0f};
+    enum { TRACE = SEGY_TRACE_HEADER_SIZE + 4 * 4 };
+    static uint8_t file[SEGY_TEXT_HEADER_SIZE + SEGY_BINARY_HEADER_SIZE + 2 * TRACE];
+    memset(file, 0, sizeof(file));
+
+    uint8_t* bin = file + SEGY_TEXT_HEADER_SIZE;
+    store_be16(bin + 16, 2000);
+    store_be16(bin + 20, 4);
+    store_be16(bin + 24, SEGY_FORMAT_IBM_FLOAT);
+    for (size_t t = 0; t < 2; ++t) {
+        uint8_t* trace = bin + SEGY_BINARY_HEADER_SIZE + t * TRACE;
+        store_be32(trace, (uint32_t)t + 1);
+        store_be32(trace + 20, 500 + (uint32_t)t);
+        store_be16(trace + 114, 4);
+        for (size_t i = 0; i < 4; ++i)
+            store_be32(trace + SEGY_TRACE_HEADER_SIZE + 4 * i, ibm[(i + t) % 4]);
+    }
+
+    segy_header_t header;
+    segy_trace_header_t traces[2];
+    float samples[8];
+    if (segy_parse_header(file, sizeof(file), &header) != 0 ||
+        header.format != SEGY_FORMAT_IBM_FLOAT || header.samples_per_trace != 4 ||
+        header.sample_interval != 2000 || header.trace_size != TRACE ||
+        segy_trace_count(&header, sizeof(file)) != 2 ||
+        segy_decode_traces(file, sizeof(file), &header, 0, 2, traces, samples) != 0 ||
+        traces[1].trace_sequence != 2 || traces[1].cdp != 501 || traces[1].num_samples != 4) {
+        fprintf(stderr, "SEG-Y parse failed\n");
+        return -1;
+    }
+    for (size_t i = 0; i < 8; ++i) {
+        if (samples[i] != expected[(i % 4 + i / 4) % 4]) {
+            fprintf(stderr, "SEG-Y sample %zu mismatch\n", i);
+            return -1;
+        }
+    }
+    printf("SEG-Y fixture parses\n");
+    return 0;
+}
+
+// Parses a 16-bit stereo WAV and a 24-bit mono AIFF file from memory.
+static int check_pcm(void) {
+    pcm_format_t fmt;
+    int32_t out[4];
+
+    uint8_t wav[44 + 8];
+    memcpy(wav, "RIFF", 4);
+    store_le32(wav + 4, sizeof(wav) - 8);
+    memcpy(wav + 8, "WAVEfmt ", 8);
+    store_le32(wav + 16, 16);
+    store_le16(wav + 20, 1);
+    store_le16(wav + 22, 2);
+    store_le32(wav + 24, 8000);
+    store_le32(wav + 28, 8000 * 4);
+    store_le16(wav + 32, 4);
+    store_le16(wav + 34, 16);
+    memcpy(wav + 36, "data", 4);
+    store_le32(wav + 40, 8);
+    const int16_t pcm16[4] = {0, 1, -2, 32767};
+    for (size_t i = 0; i < 4; ++i)
+        store_le16(wav + 44 + 2 * i, (uint16_t)pcm16[i]);
+    if (pcm_parse_header(wav, sizeof(wav), &fmt) != 0 || fmt.container != PCM_CONTAINER_WAV ||
+        fmt.channels != 2 || fmt.sample_rate != 8000 || fmt.bits_per_sample != 16 ||
+        fmt.big_endian || fmt.frames != 2 || fmt.data_offset != 44 ||
+        pcm_decode_i32(&fmt, wav + fmt.data_offset, 4, out) != 0 ||
+        out[1] != 1 << 16 || out[2] != -2 * (1 << 16) || out[3] != 32767 * (1 << 16)) {
+        fprintf(stderr, "WAV parse failed\n");
+        return -1;
+    }
+
+    // A source without a seek hook skips chunks by reading
+    endian_buffer_t buf = {wav, sizeof(wav), 0};
+    endian_source_t forward;
+    endian_source_from_buffer(&forward, &buf);
+    forward.seek = NULL;
+    if (pcm_read_header_source(&forward, &fmt) != 0 || fmt.frames != 2 ||
+        fmt.data_offset != 44 || buf.pos != 44) {
+        fprintf(stderr, "WAV source parse failed\n");
+        return -1;
+    }
+
+    // COMM: 1 channel, 3 frames, 24 bits, 8000 Hz as an 80-bit extended float
+    uint8_t aiff[12 + 26 + 16 + 9 + 1];
+    memset(aiff, 0, sizeof(aiff));
+    memcpy(aiff, "FORM", 4);
+    store_be32(aiff + 4, sizeof(aiff) - 8);
+    memcpy(aiff + 8, "AIFFCOMM", 8);
+    store_be32(aiff + 16, 18);
+    store_be16(aiff + 20, 1);
+    store_be32(aiff + 22, 3);
+    store_be16(aiff + 26, 24);
+    store_be16(aiff + 28, 0x400B);
+    store_be64(aiff + 30, 0xFA00000000000000ULL);
+    memcpy(aiff + 38, "SSND", 4);
+    store_be32(aiff + 42, 8 + 9);
+    static const uint8_t pcm24[9] = {0x00, 0x00, 0x01, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF};
+    memcpy(aiff + 54, pcm24, 9);
+    if (pcm_parse_header(aiff, sizeof(aiff), &fmt) != 0 || fmt.container != PCM_CONTAINER_AIFF ||
+        fmt.channels != 1 || fmt.sample_rate != 8000 || fmt.bits_per_sample != 24 ||
+        !fmt.big_endian || fmt.frames != 3 || fmt.data_offset != 54 ||
+        pcm_decode_i32(&fmt, aiff + fmt.data_offset, 3, out) != 0 ||
+        out[0] != 1 << 8 || out[1] != -(1 << 8) || out[2] != 0x7FFFFF00) {
+        fprintf(stderr, "AIFF parse failed\n");
+        return -1;
+    }
+
+    // 2^30 stereo 16-bit frames need a 4 GiB data chunk, past the 32-bit sizes
+    fmt.container = PCM_CONTAINER_WAV;
+    fmt.channels = 2;
+    fmt.bits_per_sample = 16;
+    fmt.is_float = 0;
+    fmt.frames = (size_t)1 << 30;
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    const int oversized = pcm_write_header(f, &fmt) == 0 || ftell(f) != 0;
+    fclose(f);
+    if (oversized) {
+        fprintf(stderr, "Oversized WAV header accepted\n");
+        return -1;
+    }
+    printf("WAV and AIFF fixtures parse\n");
+    return 0;
+}
+
+// Parses 16-bit PGM and 8-bit PPM images from memory, with a header comment.
+static int check_pnm(void) {
+    static const uint8_t pgm[] = "P5\n# fixture\n2 1\n65535\n\x01\x02\xFF\xFE";
+    static const uint8_t ppm[] = "P6 1 1 255 \x10\x80\xFF";
+    pnm_header_t hdr;
+    uint16_t samples[3];
+    float values[3];
+
+    if (pnm_parse_header(pgm, sizeof(pgm) - 1, &hdr) != 0 || hdr.channels != 1 ||
+        hdr.width != 2 || hdr.height != 1 || hdr.maxval != 65535 ||
+        pnm_sample_count(&hdr) != 2 || hdr.data_offset != sizeof(pgm) - 5 ||
+        pnm_decode_u16(&hdr, pgm + hdr.data_offset, samples) != 0 ||
+        samples[0] != 0x0102 || samples[1] != 0xFFFE) {
+        fprintf(stderr, "PGM parse failed\n");
+        return -1;
+    }
+    if (pnm_parse_header(ppm, sizeof(ppm) - 1, &hdr) != 0 || hdr.channels != 3 ||
+        pnm_sample_count(&hdr) != 3 ||
+        pnm_decode_f32(&hdr, ppm + hdr.data_offset, values) != 0 ||
+        values[0] != 16.0f * (1.0f / 255.0f) || values[2] != 1.0f) {
+        fprintf(stderr, "PPM parse failed\n");
+        return -1;
+    }
+    // A truncated raster is rejected
+    if (pnm_parse_header(pgm, sizeof(pgm) - 2, &hdr) == 0) {
+        fprintf(stderr, "Truncated PGM accepted\n");
+        return -1;
+    }
+    printf("PGM and PPM fixtures parse\n");
+    return 0;
+}
+
+// Parses a big-endian 2x2 16-bit grayscale TIFF with one strip from memory.
+static int check_tiff(void) {
+    static const uint16_t tags[9][3] = {   // tag, type (3 SHORT, 4 LONG), value
+        {256, 3, 2}, {257, 3, 2}, {258, 3, 16}, {259, 3, 1}, {262, 3, 1},
+        {273, 4, 122}, {277, 3, 1}, {278, 3, 2}, {279, 4, 8}
+    };
+    uint8_t file[122 + 8];
+    memset(file, 0, sizeof(file));
+    memcpy(file, "MM", 2);
+    store_be16(file + 2, 42);
+    store_be32(file + 4, 8);
+    store_be16(file + 8, 9);
+    for (size_t i = 0; i < 9; ++i) {
+        uint8_t* entry = file + 10 + 12 * i;
+        store_be16(entry, tags[i][0]);
+        store_be16(entry + 2, tags[i][1]);
+        store_be32(entry + 4, 1);
+        if (tags[i][1] == 3)
+            store_be16(entry + 8, tags[i][2]);
+        else
+            store_be32(entry + 8, tags[i][2]);
+    }
+    const uint16_t pixels[4] = {0x0102, 0x0304, 0xFFFE, 0x8000};
+    for (size_t i = 0; i < 4; ++i)
+        store_be16(file + 122 + 2 * i, pixels[i]);
+
+    tiff_image_t image;
+    uint16_t out[4];
+    memset(&image, 0, sizeof(image));
+    int ok = tiff_parse_image(file, sizeof(file), 0, &image) == 0 &&
+                   image.big_endian && image.width == 2 && image.height == 2 &&
+                   image.bits_per_sample == 16 && image.samples_per_pixel == 1 &&
+                   !image.tiled && image.num_chunks == 1 && image.next_ifd == 0 &&
+                   tiff_chunk_size(&image, 0) == 8 &&
+                   tiff_decode_chunk(file, sizeof(file), &image, 0, out) == 0 &&
+                   memcmp(out, pixels, sizeof(pixels)) == 0;
+    tiff_free_image(&image);
+
+    // Source entry points need random access
+    endian_buffer_t buf = {file, sizeof(file), 0};
+    endian_source_t src;
+    endian_source_from_buffer(&src, &buf);
+    memset(out, 0, sizeof(out));
+    ok = ok && tiff_read_image_source(&src, 0, &image) == 0 && image.width == 2 &&
+         tiff_read_raster_source(&src, &image, out) == 0 &&
+         memcmp(out, pixels, sizeof(pixels)) == 0;
+    tiff_free_image(&image);
+    src.seek = NULL;
+    ok = ok && tiff_read_image_source(&src, 0, &image) != 0;
+    if (!ok) {
+        fprintf(stderr, "TIFF parse failed\n");
+        return -1;
+    }
+    printf("TIFF fixture parses\n");
+    return 0;
+}
+
+// Parses a classic netCDF file with a fixed and two record variables, then reads
+// slabs through the file staging buffer and from memory.
+static int check_cdf(void) {
+    static const uint32_t header[42] = {
+        0x43444601, 3,                      // "CDF\1", numrecs
+        0x0A, 2,                            // dimensions:
+        1, 0x74000000, 0,                   //   t = UNLIMITED
+        1, 0x78000000, 3,                   //   x = 3
+        0, 0,                               // no global attributes
+        0x0B, 3,                            // variables:
+        1, 0x76000000, 1, 1, 0, 0,          //   v(x), no attributes
+        CDF_SHORT, 8, 168,                  //   type, vsize, begin
+        1, 0x72000000, 2, 0, 1, 0, 0,       //   r(t, x)
+        CDF_INT, 12, 176,
+        1, 0x73000000, 1, 0, 0, 0,          //   s(t)
+        CDF_SHORT, 4, 188
+    };
+    // Fixed data, then three 16-byte records of r (3 ints) and s (1 padded short)
+    uint8_t file[224];
+    memset(file, 0, sizeof(file));
+    for (size_t i = 0; i < 42; ++i)
+        store_be32(file + 4 * i, header[i]);
+    store_be16(file + 168, 7);
+    store_be16(file + 170, 0xFFF9);
+    store_be16(file + 172, 0x1234);
+    for (size_t rec = 0; rec < 3; ++rec) {
+        for (size_t x = 0; x < 3; ++x)
+            store_be32(file + 176 + 16 * rec + 4 * x, (uint32_t)(int32_t)(100 * rec + x - 50));
+        store_be16(file + 188 + 16 * rec, (uint16_t)(int16_t)-(int16_t)rec);
+    }
+
+    cdf_file_t cdf;
+    memset(&cdf, 0, sizeof(cdf));
+    int16_t out[2] = {0, 0};
+    const size_t start = 1, count = 2;
+    const cdf_var_t* var = NULL;
+    int ok = cdf_parse_header(file, sizeof(file), &cdf) == 0 && cdf.version == 1 &&
+             cdf.ndims == 2 && cdf.dims[1].length == 3 && cdf.nvars == 3 &&
+             cdf.header_size == 168 && cdf.numrecs == 3 && cdf.record_size == 16 &&
+             (var = cdf_find_var(&cdf, "v")) != NULL &&
+             var->type == CDF_SHORT && var->ndims == 1 && var->shape[0] == 3 &&
+             cdf_decode_vara(file, sizeof(file), &cdf, var, &start, &count, out) == 0 &&
+             out[0] == -7 && out[1] == 0x1234;
+    cdf_free(&cdf);
+
+    // Records 1-2, x 1-2 of r through the file staging buffer and from memory
+    const size_t slab_start[2] = {1, 1}, slab_count[2] = {2, 2};
+    const size_t s_start = 0, s_count = 3;
+    int32_t from_file[4], from_mem[4];
+    int16_t s_out[3];
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    ok = ok && fwrite(file, 1, sizeof(file), f) == sizeof(file) && fseek(f, 0, SEEK_SET) == 0 &&
+         cdf_read_header(f, &cdf) == 0 && cdf.header_size == 168 &&
+         (var = cdf_find_var(&cdf, "r")) != NULL && var->is_record && var->shape[0] == 3 &&
+         cdf_read_vara(f, &cdf, var, slab_start, slab_count, from_file) == 0 &&
+         cdf_decode_vara(file, sizeof(file), &cdf, var, slab_start, slab_count, from_mem) == 0 &&
+         memcmp(from_file, from_mem, sizeof(from_file)) == 0 &&
+         from_file[0] == 51 && from_file[1] == 52 && from_file[2] == 151 && from_file[3] == 152 &&
+         (var = cdf_find_var(&cdf, "s")) != NULL &&
+         cdf_read_vara(f, &cdf, var, &s_start, &s_count, s_out) == 0 &&
+         s_out[0] == 0 && s_out[1] == -1 && s_out[2] == -2;
+    cdf_free(&cdf);
+    fclose(f);
+
+    // Headers read from a forward-only source; slabs need the seek hook
+    endian_buffer_t buf = {file, sizeof(file), 0};
+    endian_source_t src;
+    endian_source_from_buffer(&src, &buf);
+    src.seek = NULL;
+    memset(from_file, 0, sizeof(from_file));
+    ok = ok && cdf_read_header_source(&src, &cdf) == 0 && buf.pos == 168 && cdf.numrecs == 3 &&
+         (var = cdf_find_var(&cdf, "r")) != NULL &&
+         cdf_read_vara_source(&src, &cdf, var, slab_start, slab_count, from_file) != 0;
+    endian_source_from_buffer(&src, &buf);
+    ok = ok && cdf_read_vara_source(&src, &cdf, var, slab_start, slab_count, from_file) == 0 &&
+         memcmp(from_file, from_mem, sizeof(from_file)) == 0;
+    cdf_free(&cdf);
+    if (!ok) {
+        fprintf(stderr, "netCDF parse failed\n");
+        return -1;
+    }
+    printf("netCDF fixture parses and record slabs read back\n");
+    return 0;
+}
+
+// Parses a DataOutputStream byte fixture and checks that the writer
+// reproduces it exactly.
+static int check_jdata(void) {
+    static const uint8_t fixture[] = {
+        0x01, 0x02, 0x03, 0x04,                                 // writeInt
+        0xFF, 0xFE,                                             // writeShort(-2)
+        0x00, 0x0B, 'a', 0xC0, 0x80, 0xC3, 0xA9,                // writeUTF
+        0xED, 0xA0, 0xBD, 0xED, 0xB8, 0x80,
+        0x3F, 0xF8, 0, 0, 0, 0, 0, 0,                           // writeDouble(1.5)
+        0, 0, 0, 1, 0xFF, 0xFF, 0xFF, 0xFF                      // int[] {1, -1}
+    };
+    static const char text[] = "a\0\xC3\xA9\xF0\x9F\x98\x80";
+    static jdata_reader_t r;
+    static jdata_writer_t w;
+    int32_t i32 = 0, arr[2] = {0, 0};
+    int16_t i16 = 0;
+    double f64 = 0;
+    char utf[16];
+    size_t len = 0;
+    uint8_t written[sizeof(fixture)];
+
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    int ok = fwrite(fixture, 1, sizeof(fixture), f) == sizeof(fixture) &&
+             fseek(f, 0, SEEK_SET) == 0 && jdata_reader_init(&r, f) == 0 &&
+             jdata_read_int(&r, &i32) == 0 && i32 == 0x01020304 &&
+             jdata_read_short(&r, &i16) == 0 && i16 == -2 &&
+             jdata_read_utf(&r, utf, sizeof(utf), &len) == 0 &&
+             len == sizeof(text) - 1 && memcmp(utf, text, len) == 0 &&
+             jdata_read_double(&r, &f64) == 0 && f64 == 1.5 &&
+             jdata_read_int_array(&r, arr, 2) == 0 && arr[0] == 1 && arr[1] == -1 &&
+             jdata_read_byte(&r, (int8_t*)utf) != 0;
+    fclose(f);
+
+    f = tmpfile();
+    if (!f)
+        return -1;
+    ok = ok && jdata_writer_init(&w, f) == 0 && jdata_write_int(&w, i32) == 0 &&
+         jdata_write_short(&w, i16) == 0 && jdata_write_utf(&w, utf, len) == 0 &&
+         jdata_write_double(&w, f64) == 0 && jdata_write_int_array(&w, arr, 2) == 0 &&
+         jdata_writer_flush(&w) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+         fread(written, 1, sizeof(written), f) == sizeof(written) &&
+         memcmp(written, fixture, sizeof(fixture)) == 0;
+    fclose(f);
+
+    endian_buffer_t buf = {written, sizeof(written), 0};
+    endian_sink_t sink;
+    endian_sink_from_buffer(&sink, &buf);
+    memset(written, 0, sizeof(written));
+    ok = ok && jdata_writer_init_sink(&w, &sink) == 0 && jdata_write_int(&w, i32) == 0 &&
+         jdata_write_short(&w, i16) == 0 && jdata_write_utf(&w, utf, len) == 0 &&
+         jdata_write_double(&w, f64) == 0 && jdata_write_int_array(&w, arr, 2) == 0 &&
+         jdata_writer_flush(&w) == 0 && buf.pos == sizeof(fixture) &&
+         memcmp(written, fixture, sizeof(fixture)) == 0;
+
+    // Strings longer than the read buffer, shifted so that multi-byte forms
+    // and surrogate pairs straddle the buffer-sized pieces
+    static const char unit[] = "ab\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+    const size_t unit_len = sizeof(unit) - 1, units = 4000;
+    const size_t long_len = 5 + units * unit_len;
+    char* long_text = (char*)malloc(long_len);
+    char* long_back = (char*)malloc(long_len);
+    f = tmpfile();
+    ok = ok && long_text && long_back && f && jdata_writer_init(&w, f) == 0;
+    if (ok) {
+        memset(long_text, 'x', 5);
+        for (size_t i = 0; i < units; ++i)
+            memcpy(long_text + 5 + i * unit_len, unit, unit_len);
+    }
+    for (size_t shift = 0; shift < 6 && ok; ++shift)
+        ok = jdata_write_utf(&w, long_text + 5 - shift, long_len - 5 + shift) == 0;
+    ok = ok && jdata_writer_flush(&w) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+         jdata_reader_init(&r, f) == 0;
+    for (size_t shift = 0; shift < 6 && ok; ++shift)
+        ok = jdata_read_utf(&r, long_back, long_len, &len) == 0 && len == long_len - 5 + shift &&
+             memcmp(long_back, long_text + 5 - shift, len) == 0;
+    if (f)
+        fclose(f);
+    free(long_text);
+    free(long_back);
+    if (!ok) {
+        fprintf(stderr, "Java data stream fixture mismatch\n");
+        return -1;
+    }
+    printf("Java data stream fixture parses and long strings round-trip\n");
+    return 0;
+}
+
+// Decodes hand-assembled CBOR and MessagePack fixtures, including a
+// big-endian float64 typed array and a mixed numeric array.
+static int check_tagged_codecs(void) {
+    static const uint8_t cbor[] = {
+        0x83,                                           // [
+        0xA2, 0x61, 'a', 0x01, 0x61, 'b', 0x82, 0x02, 0x03, //   {"a": 1, "b": [2, 3]},
+        0xF9, 0x3E, 0x00,                               //   1.5 (half),
+        0x39, 0x01, 0xF3,                               //   -500 ]
+        0xD8, 0x52, 0x50,                               // tag 82 (float64 BE), 16 bytes
+        0x3F, 0xF8, 0, 0, 0, 0, 0, 0, 0xC0, 0x00, 0, 0, 0, 0, 0, 0
+    };
+    cbor_decoder_t dec;
+    cbor_item_t item;
+    cbor_typed_t type;
+    double typed[2];
+    size_t count = 0;
+    cbor_decoder_init(&dec, cbor, sizeof(cbor));
+    int ok = cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_ARRAY && item.value == 3 &&
+             cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_MAP && item.value == 2 &&
+             cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_TEXT && item.value == 1 &&
+             item.data[0] == 'a' && cbor_skip(&dec) == 0 && cbor_skip(&dec) == 0 &&
+             cbor_skip(&dec) == 0 &&
+             cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_FLOAT && item.number == 1.5 &&
+             cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_NEGINT && item.value == 499 &&
+             cbor_decode_typed_array(&dec, &type, typed, sizeof(typed), &count) == 0 &&
+             type == CBOR_TYPED_F64 && count == 2 && typed[0] == 1.5 && typed[1] == -2.0 &&
+             dec.pos == sizeof(cbor);
+    if (!ok) {
+        fprintf(stderr, "CBOR fixture parse failed\n");
+        return -1;
+    }
+
+    static const uint8_t msgpack[] = {
+        0x83,                                           // {
+        0xA1, 'a', 0x01,                                //   "a": 1,
+        0xA1, 'b', 0x92, 0xCB, 0x3F, 0xF8, 0, 0, 0, 0, 0, 0, 0xD0, 0x85, // "b": [1.5, -123],
+        0xA1, 'c', 0xC0                                 //   "c": nil }
+    };
+    msgpack_decoder_t mdec;
+    msgpack_item_t mitem;
+    double values[2];
+    msgpack_decoder_init(&mdec, msgpack, sizeof(msgpack));
+    ok = msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_MAP && mitem.value == 3 &&
+         msgpack_skip(&mdec) == 0 && msgpack_skip(&mdec) == 0 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_STR &&
+         mitem.value == 1 && mitem.data[0] == 'b' &&
+         msgpack_decode_double_array(&mdec, values, 2, &count) == 0 && count == 2 &&
+         values[0] == 1.5 && values[1] == -123.0 &&
+         msgpack_skip(&mdec) == 0 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_NIL &&
+         mdec.pos == sizeof(msgpack);
+    if (!ok) {
+        fprintf(stderr, "MessagePack fixture parse failed\n");
+        return -1;
+    }
+
+    // Every CBOR encoder, decoded back; the typed array goes out in both orders
+    static const uint16_t u16s[3] = {1, 0xABCD, 0x8000};
+    static const int64_t i64s[2] = {INT64_MIN, -2};
+    static const uint8_t payload[2] = {9, 8};
+    uint8_t buffer[256];
+    uint16_t u16_back[3];
+    int64_t i64_back[2];
+    cbor_encoder_t enc;
+    cbor_encoder_init(&enc, buffer, sizeof(buffer));
+    ok = cbor_encode_array(&enc, 2) == 0 && cbor_encode_uint(&enc, 23) == 0 &&
+         cbor_encode_uint(&enc, UINT64_MAX) == 0 && cbor_encode_map(&enc, 1) == 0 &&
+         cbor_encode_int(&enc, -1) == 0 && cbor_encode_int(&enc, INT64_MIN) == 0 &&
+         cbor_encode_int(&enc, 500) == 0 && cbor_encode_bytes(&enc, payload, 2) == 0 &&
+         cbor_encode_text(&enc, "hi", 2) == 0 && cbor_encode_tag(&enc, 1) == 0 &&
+         cbor_encode_null(&enc) == 0 && cbor_encode_bool(&enc, 1) == 0 &&
+         cbor_encode_float(&enc, 1.5f) == 0 && cbor_encode_double(&enc, -0.1) == 0 &&
+         cbor_encode_typed_array(&enc, CBOR_TYPED_U16, u16s, 3, 1) == 0 &&
+         cbor_encode_typed_array(&enc, CBOR_TYPED_U16, u16s, 3, 0) == 0 &&
+         cbor_encode_typed_array(&enc, CBOR_TYPED_I64, i64s, 2, 0) == 0;
+    cbor_decoder_init(&dec, buffer, enc.pos);
+    ok = ok &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_ARRAY && item.value == 2 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_UINT && item.value == 23 &&
+         dec.pos == 2 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_UINT && item.value == UINT64_MAX &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_MAP && item.value == 1 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_NEGINT && item.value == 0 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_NEGINT &&
+         item.value == (uint64_t)INT64_MAX &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_UINT && item.value == 500 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_BYTES && item.value == 2 &&
+         item.data[0] == 9 && item.data[1] == 8 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_TEXT && item.value == 2 &&
+         memcmp(item.data, "hi", 2) == 0 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_TAG && item.value == 1 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_NULL &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_BOOL && item.value == 1 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_FLOAT && item.number == 1.5 &&
+         cbor_decode_next(&dec, &item) == 0 && item.type == CBOR_FLOAT && item.number == -0.1;
+    // RFC 8746 tags: 65 is uint16 big-endian, 69 uint16 little-endian
+    const size_t typed_at = dec.pos;
+    ok = ok && buffer[typed_at] == 0xD8 && buffer[typed_at + 1] == 65 &&
+         load_be16(buffer + typed_at + 3 + 2) == 0xABCD &&
+         cbor_decode_typed_array(&dec, &type, u16_back, sizeof(u16_back), &count) == 0 &&
+         type == CBOR_TYPED_U16 && count == 3 && memcmp(u16_back, u16s, sizeof(u16s)) == 0 &&
+         buffer[dec.pos] == 0xD8 && buffer[dec.pos + 1] == 69 &&
+         load_le16(buffer + dec.pos + 3 + 2) == 0xABCD &&
+         cbor_decode_typed_array(&dec, &type, u16_back, sizeof(u16_back), &count) == 0 &&
+         type == CBOR_TYPED_U16 && count == 3 && memcmp(u16_back, u16s, sizeof(u16s)) == 0 &&
+         cbor_decode_typed_array(&dec, &type, i64_back, sizeof(i64_back), &count) == 0 &&
+         type == CBOR_TYPED_I64 && count == 2 && i64_back[0] == INT64_MIN && i64_back[1] == -2 &&
+         dec.pos == enc.pos;
+    if (!ok) {
+        fprintf(stderr, "CBOR encode/decode round trip failed\n");
+        return -1;
+    }
+
+    // Every MessagePack encoder, with the fixint and int64 boundaries
+    static const double doubles[2] = {0.25, -1e300};
+    static const float floats[2] = {-0.5f, 3.0f};
+    static const int64_t ints[5] = {-1, -32, -33, INT32_MIN, INT64_MIN};
+    static const uint8_t int_codes[5] = {0xFF, 0xE0, 0xD0, 0xD2, 0xD3};
+    msgpack_encoder_t menc;
+    msgpack_encoder_init(&menc, buffer, sizeof(buffer));
+    ok = msgpack_encode_nil(&menc) == 0 && msgpack_encode_bool(&menc, 0) == 0 &&
+         msgpack_encode_uint(&menc, 127) == 0 && msgpack_encode_uint(&menc, UINT64_MAX) == 0 &&
+         msgpack_encode_int(&menc, 128) == 0;
+    for (size_t i = 0; i < 5 && ok; ++i) {
+        const size_t at = menc.pos;
+        ok = msgpack_encode_int(&menc, ints[i]) == 0 && buffer[at] == int_codes[i];
+    }
+    ok = ok && msgpack_encode_float(&menc, 1.5f) == 0 && msgpack_encode_double(&menc, -0.1) == 0 &&
+         msgpack_encode_str(&menc, "hi", 2) == 0 && msgpack_encode_bin(&menc, payload, 1) == 0 &&
+         msgpack_encode_array(&menc, 0) == 0 && msgpack_encode_map(&menc, 0) == 0 &&
+         msgpack_encode_ext(&menc, -3, payload, 2) == 0 &&
+         msgpack_encode_double_array(&menc, doubles, 2) == 0 &&
+         msgpack_encode_float_array(&menc, floats, 2) == 0;
+    msgpack_decoder_init(&mdec, buffer, menc.pos);
+    ok = ok &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_NIL &&
+         msgpack_decode_next(&mdec, &mitem) == 0 &&
+         mitem.type == MSGPACK_BOOL && mitem.value == 0 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 &&
+         mitem.type == MSGPACK_UINT && mitem.value == 127 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_UINT &&
+         mitem.value == UINT64_MAX &&
+         msgpack_decode_next(&mdec, &mitem) == 0 &&
+         mitem.type == MSGPACK_UINT && mitem.value == 128;
+    for (size_t i = 0; i < 5 && ok; ++i)
+        ok = msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_INT &&
+             mitem.integer == ints[i];
+    ok = ok &&
+         msgpack_decode_next(&mdec, &mitem) == 0 &&
+         mitem.type == MSGPACK_FLOAT && mitem.number == 1.5 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 &&
+         mitem.type == MSGPACK_FLOAT && mitem.number == -0.1 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_STR && mitem.value == 2 &&
+         memcmp(mitem.data, "hi", 2) == 0 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_BIN && mitem.value == 1 &&
+         mitem.data[0] == 9 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 &&
+         mitem.type == MSGPACK_ARRAY && mitem.value == 0 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_MAP && mitem.value == 0 &&
+         msgpack_decode_next(&mdec, &mitem) == 0 && mitem.type == MSGPACK_EXT &&
+         mitem.ext_type == -3 && mitem.value == 2 && mitem.data[0] == 9 && mitem.data[1] == 8 &&
+         msgpack_decode_double_array(&mdec, values, 2, &count) == 0 && count == 2 &&
+         values[0] == doubles[0] && values[1] == doubles[1] &&
+         msgpack_decode_double_array(&mdec, values, 2, &count) == 0 && count == 2 &&
+         values[0] == floats[0] && values[1] == floats[1] &&
+         mdec.pos == menc.pos;
+    if (!ok) {
+        fprintf(stderr, "MessagePack encode/decode round trip failed\n");
+        return -1;
+    }
+    printf("CBOR and MessagePack fixtures parse and encoders round-trip\n");
+    return 0;
+}
+
+// Writes word-swapped 32-bit values, checks the stored layout and reads them
+// back, then round-trips a 16-byte order given in comma-separated form.
+static int check_ordered(void) {
+    endian_order_t order;
+    const uint32_t values[5] = {0x11223344u, 0xAABBCCDDu, 0, 0xFFFFFFFFu, 0x01020304u};
+    uint32_t back[5];
+    uint8_t raw[20];
+
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    int ok = endian_order_init(&order, "3-4-1-2") == 0 &&
+             write_uint32_t_ordered(f, values, 5, &order) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+             fread(raw, 1, sizeof(raw), f) == sizeof(raw) &&
+             raw[0] == 0x33 && raw[1] == 0x44 && raw[2] == 0x11 && raw[3] == 0x22 &&
+             fseek(f, 0, SEEK_SET) == 0 && read_uint32_t_ordered(f, back, 5, &order) == 0 &&
+             memcmp(values, back, sizeof(values)) == 0;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Word-swapped round trip failed\n");
+        return -1;
+    }
+
+    uint8_t data[3 * 16], copy[3 * 16];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = (uint8_t)(i * 11);
+    memcpy(copy, data, sizeof(data));
+    ok = endian_order_init(&order, "9,10,11,12,13,14,15,16,1,2,3,4,5,6,7,8") == 0 &&
+         convert_to_ordered(data, 3, &order) == 0 && memcmp(data, copy, sizeof(data)) != 0 &&
+         convert_from_ordered(data, 3, &order) == 0 && memcmp(data, copy, sizeof(data)) == 0;
+    if (!ok) {
+        fprintf(stderr, "16-byte order round trip failed\n");
+        return -1;
+    }
+    printf("Byte permutation orders round-trip\n");
+    return 0;
+}
+
+// Round-trips Q15 and Q16.16 values through memory and a file, including
+// rounding and saturation.
+static int check_fixed(void) {
+    const float in[5] = {0.5f, -0.25f, 0.999f, -1.0f, 2.0f};
+    const float q15[5] = {0.5f, -0.25f, 32735.0f / 32768.0f, -1.0f, 32767.0f / 32768.0f};
+    float out[5];
+    uint8_t raw[10];
+
+    if (encode_fixed_f32(in, raw, 5, 16, 15, 1) != 0 || raw[0] != 0x40 || raw[1] != 0x00 ||
+        decode_fixed_f32(raw, out, 5, 16, 15, 1) != 0 || memcmp(out, q15, sizeof(q15)) != 0) {
+        fprintf(stderr, "Q15 round trip failed\n");
+        return -1;
+    }
+
+    const double values[4] = {1.5, -3.25, 32767.0, -0.0000152587890625};
+    double back[4];
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    const int ok = write_fixed_f64(f, values, 4, 32, 16, 0) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+                   read_fixed_f64(f, back, 4, 32, 16, 0) == 0 &&
+                   memcmp(values, back, sizeof(values)) == 0;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Q16.16 round trip failed\n");
+        return -1;
+    }
+    printf("Fixed-point values round-trip\n");
+    return 0;
+}
+
+// Round-trips signed and unsigned quantized blocks and checks the error
+// stays within half a quantization step.
+static int check_quant8(void) {
+    float in[64], out[64];
+    for (size_t i = 0; i < 64; ++i)
+        in[i] = (float)((int)(i * 37 % 64) - 20) * 0.125f;
+
+    for (int is_signed = 0; is_signed < 2; ++is_signed) {
+        const quant8_format_t fmt = {32, is_signed, 1};
+        FILE* f = tmpfile();
+        if (!f)
+            return -1;
+        int ok = write_quant8_f32(f, &fmt, in, 2) == 0 &&
+                 ftell(f) == (long)(2 * quant8_block_bytes(&fmt)) &&
+                 fseek(f, 0, SEEK_SET) == 0 && read_quant8_f32(f, &fmt, out, 2) == 0;
+        fclose(f);
+        for (size_t b = 0; b < 2 && ok; ++b) {
+            float lo = in[32 * b], hi = in[32 * b];
+            for (size_t i = 32 * b; i < 32 * b + 32; ++i) {
+                lo = in[i] < lo ? in[i] : lo;
+                hi = in[i] > hi ? in[i] : hi;
+            }
+            const float amax = -lo > hi ? -lo : hi;
+            const float step = is_signed ? amax / 127.0f : (hi - lo) / 255.0f;
+            for (size_t i = 32 * b; i < 32 * b + 32 && ok; ++i) {
+                const float err = out[i] - in[i];
+                ok = err <= step * 0.501f && -err <= step * 0.501f;
+            }
+        }
+        if (!ok) {
+            fprintf(stderr, "Quantized round trip failed: signed %d\n", is_signed);
+            return -1;
+        }
+    }
+    printf("Quantized blocks round-trip\n");
+    return 0;
+}
+
+// Round-trips a 17-byte value (one partial limb) through limbs in both byte
+// orders and checks the limb values and the overflow cases.
+static int check_bigint(void) {
+    uint8_t be[17], le[17], back[17];
+    for (size_t i = 0; i < 17; ++i) {
+        be[i] = (uint8_t)(0xA0 + i);
+        le[16 - i] = be[i];
+    }
+    uint64_t limbs[4], limbs_le[4];
+    const int ok = endian_bigint_import_be(limbs, 4, be, 17) == 0 &&
+                   limbs[0] == 0xA9AAABACADAEAFB0ULL && limbs[1] == 0xA1A2A3A4A5A6A7A8ULL &&
+                   limbs[2] == 0xA0 && limbs[3] == 0 &&
+                   endian_bigint_import_le(limbs_le, 4, le, 17) == 0 &&
+                   memcmp(limbs, limbs_le, sizeof(limbs)) == 0 &&
+                   endian_bigint_export_be(back, 17, limbs, 4) == 0 &&
+                   memcmp(back, be, 17) == 0 &&
+                   endian_bigint_export_le(back, 17, limbs, 4) == 0 &&
+                   memcmp(back, le, 17) == 0 &&
+                   endian_bigint_import_be(limbs, 2, be, 17) != 0 &&
+                   endian_bigint_export_be(back, 16, limbs_le, 4) != 0;
+    if (!ok) {
+        fprintf(stderr, "Big-integer limb round trip failed\n");
+        return -1;
+    }
+    printf("Big-integer limbs round-trip\n");
+    return 0;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+// Checks the stored byte order and return values of the atomic operations.
+static int check_atomics(void) {
+    uint32_t word = 0;
+    uint64_t wide = 0;
+    uint32_t expected = 0;
+    uint8_t bytes[8];
+
+    endian_atomic_store_be32(&word, 0x000000FFu);
+    memcpy(bytes, &word, 4);
+    int ok = bytes[0] == 0 && bytes[3] == 0xFF &&
+             endian_atomic_fetch_add_be32(&word, 1) == 0xFFu &&
+             endian_atomic_load_be32(&word) == 0x100u && load_be32(&word) == 0x100u &&
+             endian_atomic_exchange_be32(&word, 7) == 0x100u &&
+             endian_atomic_cas_be32(&word, &expected, 9) == 0 && expected == 7 &&
+             endian_atomic_cas_be32(&word, &expected, 9) == 1 && load_be32(&word) == 9;
+
+    endian_atomic_store_le64(&wide, 0xFFFFFFFFull);
+    ok = ok && endian_atomic_fetch_add_le64(&wide, 1) == 0xFFFFFFFFull &&
+         load_le64(&wide) == 0x100000000ull && endian_atomic_load_le64(&wide) == 0x100000000ull;
+    endian_atomic_store_be64(&wide, 0x0102030405060708ull);
+    memcpy(bytes, &wide, 8);
+    ok = ok && bytes[0] == 1 && bytes[7] == 8 &&
+         endian_atomic_fetch_add_be64(&wide, 0x100) == 0x0102030405060708ull &&
+         load_be64(&wide) == 0x0102030405060808ull;
+    if (!ok) {
+        fprintf(stderr, "Atomic fixed-order operations failed\n");
+        return -1;
+    }
+    printf("Atomic fixed-order operations behave\n");
+    return 0;
+}
+#endif
+
+// Applies the same patch set to a file and to memory: adjacent fields are
+// coalesced, the later of two overlapping fields wins and the CRC fixup
+// covers the patched bytes.
+static int check_patch(void) {
+    uint8_t image[64], file_bytes[64];
+    for (size_t i = 0; i < sizeof(image); ++i)
+        image[i] = (uint8_t)i;
+
+    patch_set_t ps;
+    size_t writes = 0;
+    patch_set_init(&ps);
+    int ok = patch_crc32(0, (const uint8_t*)"123456789", 9) == 0xCBF43926u &&
+             patch_set_add(&ps, 6, 0xDEADBEEF, 4, 1) == 0 &&
+             patch_set_add(&ps, 4, 0x1234, 2, 1) == 0 &&
+             patch_set_add_float(&ps, 20, 1.0f, 0) == 0 &&
+             patch_set_add(&ps, 40, 0x1111111111111111ULL, 8, 0) == 0 &&
+             patch_set_add(&ps, 44, 0x2222, 2, 0) == 0 &&
+             patch_set_add_checksum(&ps, 60, 1, 0, 48, patch_crc32, 0) == 0;
+
+    FILE* f = tmpfile();
+    if (!f) {
+        patch_set_free(&ps);
+        return -1;
+    }
+    ok = ok && fwrite(image, 1, sizeof(image), f) == sizeof(image) &&
+         patch_set_apply(&ps, f, &writes) == 0 && writes == 4 &&
+         fseek(f, 0, SEEK_SET) == 0 &&
+         fread(file_bytes, 1, sizeof(file_bytes), f) == sizeof(file_bytes) &&
+         patch_set_apply_mem(&ps, image, sizeof(image)) == 0 &&
+         memcmp(image, file_bytes, sizeof(image)) == 0 &&
+         load_be16(image + 4) == 0x1234 && load_be32(image + 6) == 0xDEADBEEFu &&
+         load_le32(image + 20) == 0x3F800000u && load_le16(image + 44) == 0x2222 &&
+         load_le16(image + 42) == 0x1111 && load_be32(image + 60) == patch_crc32(0, image, 48);
+
+    // Empty and fixup-only sets have no field entries to sort
+    patch_set_free(&ps);
+    patch_set_init(&ps);
+    ok = ok && patch_set_apply(&ps, f, &writes) == 0 && writes == 0 &&
+         patch_set_add_checksum(&ps, 0, 0, 4, 8, patch_crc32, 0) == 0 &&
+         patch_set_apply(&ps, f, &writes) == 0 && writes == 1 &&
+         fseek(f, 0, SEEK_SET) == 0 &&
+         fread(file_bytes, 1, sizeof(file_bytes), f) == sizeof(file_bytes) &&
+         load_le32(file_bytes) == patch_crc32(0, file_bytes + 4, 8);
+    fclose(f);
+    patch_set_free(&ps);
+    if (!ok) {
+        fprintf(stderr, "Field patch application failed\n");
+        return -1;
+    }
+    printf("Field patches apply to files and memory\n");
+    return 0;
+}
+
+// Writes three snapshots of a big-endian array and checks that only the
+// changed chunk is rewritten and the file always matches the array.
+static int check_snapshot(void) {
+    uint32_t values[100], stored[100];
+    for (size_t i = 0; i < 100; ++i)
+        values[i] = (uint32_t)i * 0x01010101u;
+
+    snapshot_writer_t sw;
+    uint64_t written = 0;
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    int ok = fputs("HDR!", f) >= 0 && snapshot_init(&sw, f, 4, 4, 100, 64, 1) == 0 &&
+             snapshot_write(&sw, values, &written) == 0 && written == 400 &&
+             snapshot_write(&sw, values, &written) == 0 && written == 0;
+    values[50] ^= 0xFFu;
+    ok = ok && snapshot_write(&sw, values, &written) == 0 && written == 64 &&
+         fseek(f, 4, SEEK_SET) == 0 && read_uint32_t_be(f, stored, 100) == 0 &&
+         memcmp(stored, values, sizeof(values)) == 0;
+    snapshot_invalidate(&sw);
+    ok = ok && snapshot_write(&sw, values, &written) == 0 && written == 400;
+    snapshot_free(&sw);
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Incremental snapshot check failed\n");
+        return -1;
+    }
+    printf("Incremental snapshots rewrite only dirty chunks\n");
+    return 0;
+}
+
+// Stamps a header template in a batch and through the writer, interleaved
+// with payloads, and checks both against the expected bytes.
+static int check_template(void) {
+    static header_template_t t;
+    static template_writer_t w;
+    static const uint8_t magic[2] = {'H', 'D'};
+    const uint64_t values[2][2] = {{0x0102, 3}, {0xFFFF, 0xAABBCCDD}};
+    uint8_t batch[2 * 12], expected[2 * 12 + 2], out[sizeof(expected)];
+
+    header_template_init(&t);
+    int ok = header_template_put_bytes(&t, magic, 2) == 0 &&
+             header_template_put(&t, 1, 2, 1) == 0 &&
+             header_template_field(&t, 2, 1) == 0 &&
+             header_template_field(&t, 4, 0) == 1 &&
+             header_template_put(&t, 0, 2, 0) == 0 && t.size == 12 &&
+             header_template_stamp(&t, batch, &values[0][0], 2) == 0;
+    for (size_t c = 0; c < 2; ++c) {
+        uint8_t* h = expected + c * 13;
+        memcpy(h, magic, 2);
+        store_be16(h + 2, 1);
+        store_be16(h + 4, (uint16_t)values[c][0]);
+        store_le32(h + 6, (uint32_t)values[c][1]);
+        store_le16(h + 10, 0);
+        h[12] = (uint8_t)(0xE0 + c);
+        ok = ok && memcmp(batch + c * 12, h, 12) == 0;
+    }
+
+    // The same stream through a memory sink
+    endian_buffer_t buf = {out, sizeof(out), 0};
+    endian_sink_t sink;
+    endian_sink_from_buffer(&sink, &buf);
+    ok = ok && template_writer_init_sink(&w, &sink, &t) == 0;
+    for (size_t c = 0; c < 2 && ok; ++c) {
+        const uint8_t payload = (uint8_t)(0xE0 + c);
+        ok = template_writer_emit(&w, values[c]) == 0 &&
+             template_writer_write(&w, &payload, 1) == 0;
+    }
+    ok = ok && template_writer_flush(&w) == 0 && buf.pos == sizeof(expected) &&
+         memcmp(out, expected, sizeof(expected)) == 0;
+
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    ok = ok && template_writer_init(&w, f, &t) == 0;
+    for (size_t c = 0; c < 2 && ok; ++c) {
+        const uint8_t payload = (uint8_t)(0xE0 + c);
+        ok = template_writer_emit(&w, values[c]) == 0 &&
+             template_writer_write(&w, &payload, 1) == 0;
+    }
+    ok = ok && template_writer_flush(&w) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+         fread(out, 1, sizeof(out), f) == sizeof(out) &&
+         memcmp(out, expected, sizeof(expected)) == 0 &&
+         header_template_field(&t, 3, 1) < 0 && t.error;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Header template check failed\n");
+        return -1;
+    }
+    printf("Header templates stamp the expected bytes\n");
+    return 0;
+}
+
+// Byte stream without a direct hook, so the staged path is exercised.
+typedef struct {
+    uint8_t data[64];
+    size_t pos;
+} test_stream_t;
+
+static int test_stream_write(void* ctx, const uint8_t* src, size_t n) {
+    test_stream_t* s = (test_stream_t*)ctx;
+    if (n > sizeof(s->data) - s->pos)
+        return -1;
+    memcpy(s->data + s->pos, src, n);
+    s->pos += n;
+    return 0;
+}
+
+static int test_stream_read(void* ctx, uint8_t* dst, size_t n) {
+    test_stream_t* s = (test_stream_t*)ctx;
+    if (n > sizeof(s->data) - s->pos)
+        return -1;
+    memcpy(dst, s->data + s->pos, n);
+    s->pos += n;
+    return 0;
+}
+
+// Round-trips typed arrays through the buffer adapters and a callback
+// stream, and checks the encoded bytes against the FILE* functions.
+static int check_source_sink(void) {
+    const uint32_t values[5] = {0x11223344u, 0xAABBCCDDu, 1, 0, 0xFFFFFFFFu};
+    const int8_t small[3] = {-1, 0, 127};
+    uint32_t back[5];
+    int8_t small_back[3];
+    uint8_t storage[64], from_file[20];
+
+    endian_buffer_t buf = {storage, sizeof(storage), 0};
+    endian_sink_t sink;
+    endian_source_t src;
+    endian_sink_from_buffer(&sink, &buf);
+    int ok = write_uint32_t_be_to(&sink, values, 5) == 0 &&
+             write_int8_t_le_to(&sink, small, 3) == 0 && buf.pos == 23;
+    buf.pos = 0;
+    endian_source_from_buffer(&src, &buf);
+    ok = ok && read_uint32_t_be_from(&src, back, 5) == 0 &&
+         memcmp(back, values, sizeof(values)) == 0 &&
+         read_int8_t_le_from(&src, small_back, 3) == 0 &&
+         memcmp(small_back, small, sizeof(small)) == 0 &&
+         read_uint32_t_be_from(&src, back, 16) != 0;
+
+    test_stream_t stream = {{0}, 0};
+    const endian_sink_t stream_sink = {test_stream_write, NULL, &stream};
+    const endian_source_t stream_src = {test_stream_read, NULL, &stream, NULL};
+    FILE* f = tmpfile();
+    if (!f)
+        return -1;
+    ok = ok && write_uint32_t_le_to(&stream_sink, values, 5) == 0 &&
+         write_uint32_t_le(f, values, 5) == 0 && fseek(f, 0, SEEK_SET) == 0 &&
+         fread(from_file, 1, sizeof(from_file), f) == sizeof(from_file) &&
+         memcmp(stream.data, from_file, sizeof(from_file)) == 0;
+    fclose(f);
+    stream.pos = 0;
+    memset(back, 0, sizeof(back));
+    ok = ok && read_uint32_t_le_from(&stream_src, back, 5) == 0 &&
+         memcmp(back, values, sizeof(values)) == 0;
+    if (!ok) {
+        fprintf(stderr, "Source/sink round trip failed\n");
+        return -1;
+    }
+    printf("Sources and sinks round-trip\n");
+    return 0;
+}
+
 int main(void) {
+    if (check_swap_kernels() != 0)
+        return 1;
+    if (check_packed() != 0)
+        return 1;
+    if (check_shuffle() != 0)
+        return 1;
+    if (check_bit_stream() != 0)
+        return 1;
+    if (check_utf() != 0)
+        return 1;
+    if (check_strings() != 0)
+        return 1;
+    if (check_npy() != 0)
+        return 1;
+    if (check_fits() != 0)
+        return 1;
+    if (check_pcap() != 0)
+        return 1;
+    if (check_segy() != 0)
+        return 1;
+    if (check_pcm() != 0)
+        return 1;
+    if (check_pnm() != 0)
+        return 1;
+    if (check_tiff() != 0)
+        return 1;
+    if (check_cdf() != 0)
+        return 1;
+    if (check_jdata() != 0)
+        return 1;
+    if (check_tagged_codecs() != 0)
+        return 1;
+    if (check_ordered() != 0)
+        return 1;
+    if (check_fixed() != 0)
+        return 1;
+    if (check_quant8() != 0)
+        return 1;
+    if (check_bigint() != 0)
+        return 1;
+#if defined(__GNUC__) || defined(__clang__)
+    if (check_atomics() != 0)
+        return 1;
+#endif
+    if (check_patch() != 0)
+        return 1;
+    if (check_snapshot() != 0)
+        return 1;
+    if (check_template() != 0)
+        return 1;
+    if (check_source_sink() != 0)
+        return 1;
+
     const char *filename_be = "test_be.bin";
     const char *filename_le = "test_le.bin";
 
@@ -0,0 +1,381 @@
+#include "tiff_io.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define TIFF_HEADER_SIZE 8
+#define TIFF_ENTRY_SIZE 12
+
+// Baseline and extension tags used to locate the raster
+#define TAG_IMAGE_WIDTH 256
+#define TAG_IMAGE_LENGTH 257
+#define TAG_BITS_PER_SAMPLE 258
+#define TAG_COMPRESSION 259
+#define TAG_PHOTOMETRIC 262
+#define TAG_STRIP_OFFSETS 273
+#define TAG_SAMPLES_PER_PIXEL 277
+#define TAG_ROWS_PER_STRIP 278
+#define TAG_STRIP_BYTE_COUNTS 279
+#define TAG_PLANAR_CONFIG 284
+#define TAG_TILE_WIDTH 322
+#define TAG_TILE_LENGTH 323
+#define TAG_TILE_OFFSETS 324
+#define TAG_TILE_BYTE_COUNTS 325
+#define TAG_SAMPLE_FORMAT 339
+
+// Field types that can hold the integer values above
+#define TYPE_BYTE 1
+#define TYPE_SHORT 3
+#define TYPE_LONG 4
+
+// -----------------------------------------------------------------------------
+// Byte Access
+// -----------------------------------------------------------------------------
+
+// Files, memory and custom streams are all read through a seekable source
+static int source_read(const endian_source_t* src, uint64_t offset, void* dst, size_t n) {
+    return endian_source_read_at(src, offset, (uint8_t*)dst, n);
+}
+
+static inline uint16_t get16(const uint8_t* p, int big_endian) {
+    return big_endian ? load_be16(p) : load_le16(p);
+}
+
+static inline uint32_t get32(const uint8_t* p, int big_endian) {
+    return big_endian ? load_be32(p) : load_le32(p);
+}
+
+// -----------------------------------------------------------------------------
+// Directory Parsing
+// -----------------------------------------------------------------------------
+
+// Loads the first n values of an integer-typed IFD entry, following the
+// value offset when the data does not fit in the entry itself.
+static int load_values(const endian_source_t* src, const uint8_t* entry, int big_endian,
+                       uint64_t* out, size_t n) {
+    const uint16_t type = get16(entry + 2, big_endian);
+    const uint32_t count = get32(entry + 4, big_endian);
+    const size_t size = type == TYPE_BYTE ? 1 : type == TYPE_SHORT ? 2 : type == TYPE_LONG ? 4 : 0;
+    if (size == 0 || count < n)
+        return -1;
+
+    const uint8_t* values = entry + 8;
+    uint8_t* buffer = NULL;
+    if ((size_t)count * size > 4) {
+        buffer = (uint8_t*)malloc(n * size);
+        if (!buffer || source_read(src, get32(entry + 8, big_endian), buffer, n * size) != 0) {
+            free(buffer);
+            return -1;
+        }
+        values = buffer;
+    }
+
+    // Type and byte order are fixed for the whole array; keep the branches
+    // out of the per-value loop.
+    switch (size) {
+        case 1:
+            for (size_t i = 0; i < n; i++)
+                out[i] = values[i];
+            break;
+        case 2:
+            if (big_endian)
+                for (size_t i = 0; i < n; i++) out[i] = load_be16(values + 2 * i);
+            else
+                for (size_t i = 0; i < n; i++) out[i] = load_le16(values + 2 * i);
+            break;
+        case 4:
+            if (big_endian)
+                for (size_t i = 0; i < n; i++) out[i] = load_be32(values + 4 * i);
+            else
+                for (size_t i = 0; i < n; i++) out[i] = load_le32(values + 4 * i);
+            break;
+    }
+
+    free(buffer);
+    return 0;
+}
+
+static int load_value(const endian_source_t* src, const uint8_t* entry, int big_endian,
+                      uint64_t* value) {
+    return load_values(src, entry, big_endian, value, 1);
+}
+
+// Loads an offset or byte count table with exactly image->num_chunks entries
+static int load_table(const endian_source_t* src, const uint8_t* entry, const tiff_image_t* image,
+                      uint64_t** table) {
+    if (!entry || get32(entry + 4, image->big_endian) != image->num_chunks)
+        return -1;
+    *table = (uint64_t*)malloc(image->num_chunks * sizeof(uint64_t));
+    if (!*table)
+        return -1;
+    return load_values(src, entry, image->big_endian, *table, image->num_chunks);
+}
+
+static int parse_entries(const endian_source_t* src, const uint8_t* entries, size_t count,
+                         tiff_image_t* image) {
+    const int be = image->big_endian;
+    const uint8_t* offsets = NULL;
+    const uint8_t* byte_counts = NULL;
+    uint64_t width = 0, height = 0, rows_per_strip = UINT32_MAX;
+    uint64_t tile_width = 0, tile_height = 0;
+    uint64_t bits = 1, samples = 1, format = TIFF_SAMPLE_UINT;
+    uint64_t compression = 1, photometric = 0, planar = 1;
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* entry = entries + i * TIFF_ENTRY_SIZE;
+        int status = 0;
+        switch (get16(entry, be)) {
+            case TAG_IMAGE_WIDTH:       status = load_value(src, entry, be, &width); break;
+            case TAG_IMAGE_LENGTH:      status = load_value(src, entry, be, &height); break;
+            case TAG_BITS_PER_SAMPLE:   status = load_value(src, entry, be, &bits); break;
+            case TAG_COMPRESSION:       status = load_value(src, entry, be, &compression); break;
+            case TAG_PHOTOMETRIC:       status = load_value(src, entry, be, &photometric); break;
+            case TAG_SAMPLES_PER_PIXEL: status = load_value(src, entry, be, &samples); break;
+            case TAG_ROWS_PER_STRIP:    status = load_value(src, entry, be, &rows_per_strip); break;
+            case TAG_PLANAR_CONFIG:     status = load_value(src, entry, be, &planar); break;
+            case TAG_TILE_WIDTH:        status = load_value(src, entry, be, &tile_width); break;
+            case TAG_TILE_LENGTH:       status = load_value(src, entry, be, &tile_height); break;
+            case TAG_SAMPLE_FORMAT:     status = load_value(src, entry, be, &format); break;
+            case TAG_STRIP_OFFSETS:
+            case TAG_TILE_OFFSETS:      offsets = entry; break;
+            case TAG_STRIP_BYTE_COUNTS:
+            case TAG_TILE_BYTE_COUNTS:  byte_counts = entry; break;
+        }
+        if (status != 0)
+            return -1;
+    }
+
+    if (width == 0 || height == 0 || samples == 0 || (planar != 1 && planar != 2))
+        return -1;
+
+    image->width = (uint32_t)width;
+    image->height = (uint32_t)height;
+    image->samples_per_pixel = (uint16_t)samples;
+    image->bits_per_sample = (uint16_t)bits;
+    image->sample_format = (uint16_t)format;
+    image->compression = (uint16_t)compression;
+    image->photometric = (uint16_t)photometric;
+    image->planar_config = (uint16_t)planar;
+    image->tiled = tile_width != 0 || tile_height != 0;
+
+    if (image->tiled) {
+        if (tile_width == 0 || tile_height == 0)
+            return -1;
+        image->chunk_width = (uint32_t)tile_width;
+        image->chunk_height = (uint32_t)tile_height;
+    } else {
+        image->chunk_width = image->width;
+        image->chunk_height = rows_per_strip == 0 || rows_per_strip > height
+                              ? image->height : (uint32_t)rows_per_strip;
+    }
+
+    image->chunks_across = (image->width + image->chunk_width - 1) / image->chunk_width;
+    image->chunks_down = (image->height + image->chunk_height - 1) / image->chunk_height;
+    image->num_chunks = image->chunks_across * image->chunks_down * (planar == 2 ? samples : 1);
+
+    if (load_table(src, offsets, image, &image->offsets) != 0 ||
+        load_table(src, byte_counts, image, &image->byte_counts) != 0)
+        return -1;
+    return 0;
+}
+
+static int parse_image(const endian_source_t* src, size_t index, tiff_image_t* image) {
+    memset(image, 0, sizeof(*image));
+
+    uint8_t header[TIFF_HEADER_SIZE];
+    if (source_read(src, 0, header, sizeof(header)) != 0)
+        return -1;
+    if (header[0] == 'M' && header[1] == 'M')
+        image->big_endian = 1;
+    else if (header[0] != 'I' || header[1] != 'I')
+        return -1;
+    const int be = image->big_endian;
+    if (get16(header + 2, be) != 42)
+        return -1;
+
+    // Walk the IFD chain to the requested directory. Each step reads only the
+    // entry count and the next-IFD pointer.
+    uint64_t offset = get32(header + 4, be);
+    uint8_t field[4];
+    for (size_t i = 0; i < index && offset != 0; i++) {
+        if (source_read(src, offset, field, 2) != 0)
+            return -1;
+        const uint64_t next_at = offset + 2 + (uint64_t)get16(field, be) * TIFF_ENTRY_SIZE;
+        if (source_read(src, next_at, field, 4) != 0)
+            return -1;
+        offset = get32(field, be);
+    }
+    if (offset == 0 || source_read(src, offset, field, 2) != 0)
+        return -1;
+
+    // All entries and the next pointer are fetched in a single read
+    const size_t count = get16(field, be);
+    const size_t bytes = count * TIFF_ENTRY_SIZE + 4;
+    uint8_t* entries = (uint8_t*)malloc(bytes);
+    if (!entries)
+        return -1;
+
+    int status = source_read(src, offset + 2, entries, bytes);
+    if (status == 0) {
+        image->next_ifd = get32(entries + count * TIFF_ENTRY_SIZE, be);
+        status = parse_entries(src, entries, count, image);
+    }
+    free(entries);
+
+    if (status != 0)
+        tiff_free_image(image);
+    return status;
+}
+
+int tiff_parse_image(const uint8_t* data, size_t size, size_t index, tiff_image_t* image) {
+    if (!data || !image)
+        return -1;
+    endian_buffer_t buf = { (uint8_t*)data, size, 0 };
+    endian_source_t src;
+    endian_source_from_buffer(&src, &buf);
+    return parse_image(&src, index, image);
+}
+
+int tiff_read_image(FILE* file, size_t index, tiff_image_t* image) {
+    if (!file)
+        return -1;
+    endian_source_t src;
+    endian_source_from_file(&src, file);
+    return tiff_read_image_source(&src, index, image);
+}
+
+int tiff_read_image_source(const endian_source_t* src, size_t index, tiff_image_t* image) {
+    if (!src || !src->seek || !image)
+        return -1;
+    return parse_image(src, index, image);
+}
+
+void tiff_free_image(tiff_image_t* image) {
+    if (!image)
+        return;
+    free(image->offsets);
+    free(image->byte_counts);
+    image->offsets = NULL;
+    image->byte_counts = NULL;
+}
+
+// -----------------------------------------------------------------------------
+// Chunk Decoding
+// -----------------------------------------------------------------------------
+
+static inline size_t sample_bytes(const tiff_image_t* image) {
+    return image->bits_per_sample / 8;
+}
+
+static inline size_t pixel_bytes(const tiff_image_t* image) {
+    return sample_bytes(image) * (image->planar_config == 2 ? 1 : image->samples_per_pixel);
+}
+
+static int is_supported(const tiff_image_t* image) {
+    const uint16_t bits = image->bits_per_sample;
+    return image->compression == 1 && (bits == 8 || bits == 16 || bits == 32 || bits == 64);
+}
+
+size_t tiff_chunk_size(const tiff_image_t* image, size_t chunk) {
+    if (!image || chunk >= image->num_chunks)
+        return 0;
+
+    size_t rows = image->chunk_height;
+    if (!image->tiled) {
+        const size_t row = (chunk % image->chunks_down) * image->chunk_height;
+        if (image->height - row < rows)
+            rows = image->height - row;
+    }
+    return (size_t)image->chunk_width * rows * pixel_bytes(image);
+}
+
+// Reads the stored bytes of a chunk into out and swaps them to host order
+static int decode_chunk(const endian_source_t* src, const tiff_image_t* image, size_t chunk,
+                        void* out) {
+    if (!is_supported(image))
+        return -1;
+    const size_t size = tiff_chunk_size(image, chunk);
+    if (size == 0 || image->byte_counts[chunk] < size)
+        return -1;
+    if (source_read(src, image->offsets[chunk], out, size) != 0)
+        return -1;
+
+    const size_t width = sample_bytes(image);
+    return image->big_endian ? convert_be((uint8_t*)out, size / width, width)
+                             : convert_le((uint8_t*)out, size / width, width);
+}
+
+int tiff_decode_chunk(const uint8_t* data, size_t size, const tiff_image_t* image,
+                      size_t chunk, void* out) {
+    if (!data || !image || !out)
+        return -1;
+    endian_buffer_t buf = { (uint8_t*)data, size, 0 };
+    endian_source_t src;
+    endian_source_from_buffer(&src, &buf);
+    return decode_chunk(&src, image, chunk, out);
+}
+
+int tiff_read_chunk(FILE* file, const tiff_image_t* image, size_t chunk, void* out) {
+    if (!file)
+        return -1;
+    endian_source_t src;
+    endian_source_from_file(&src, file);
+    return tiff_read_chunk_source(&src, image, chunk, out);
+}
+
+int tiff_read_chunk_source(const endian_source_t* src, const tiff_image_t* image,
+                           size_t chunk, void* out) {
+    if (!src || !src->seek || !image || !out)
+        return -1;
+    return decode_chunk(src, image, chunk, out);
+}
+
+int tiff_read_raster(FILE* file, const tiff_image_t* image, void* out) {
+    if (!file)
+        return -1;
+    endian_source_t src;
+    endian_source_from_file(&src, file);
+    return tiff_read_raster_source(&src, image, out);
+}
+
+int tiff_read_raster_source(const endian_source_t* src, const tiff_image_t* image, void* out) {
+    if (!src || !src->seek || !image || !out || !is_supported(image))
+        return -1;
+
+    const size_t pixel = pixel_bytes(image);
+    const size_t stride = (size_t)image->width * pixel;
+    const size_t plane = stride * image->height;
+    const size_t per_plane = image->chunks_across * image->chunks_down;
+
+    // Strips land directly in the raster; tiles go through one scratch tile
+    // so the padding past the right and bottom edges can be dropped.
+    uint8_t* scratch = NULL;
+    if (image->tiled) {
+        scratch = (uint8_t*)malloc((size_t)image->chunk_width * image->chunk_height * pixel);
+        if (!scratch)
+            return -1;
+    }
+
+    int status = 0;
+    for (size_t chunk = 0; chunk < image->num_chunks && status == 0; chunk++) {
+        const size_t index = chunk % per_plane;
+        const size_t x0 = (index % image->chunks_across) * image->chunk_width;
+        const size_t y0 = (index / image->chunks_across) * image->chunk_height;
+        uint8_t* dst = (uint8_t*)out + (chunk / per_plane) * plane + y0 * stride + x0 * pixel;
+
+        if (!image->tiled) {
+            status = decode_chunk(src, image, chunk, dst);
+            continue;
+        }
+
+        status = decode_chunk(src, image, chunk, scratch);
+        const size_t cols = image->width - x0 < image->chunk_width
+                            ? image->width - x0 : image->chunk_width;
+        const size_t rows = image->height - y0 < image->chunk_height
+                            ? image->height - y0 : image->chunk_height;
+        for (size_t r = 0; r < rows && status == 0; r++)
+            memcpy(dst + r * stride, scratch + r * image->chunk_width * pixel, cols * pixel);
+    }
+
+    free(scratch);
+    return status;
+}
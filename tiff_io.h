@@ -0,0 +1,141 @@
+#ifndef TIFF_IO_H
+#define TIFF_IO_H
+
+#include "endian_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// SampleFormat tag values.
+typedef enum {
+    TIFF_SAMPLE_UINT = 1,
+    TIFF_SAMPLE_INT = 2,
+    TIFF_SAMPLE_FLOAT = 3
+} tiff_sample_format_t;
+
+/**
+ * @brief One image file directory (IFD) of a classic TIFF file.
+ *
+ * Strips are treated as tiles that span the full image width, so both
+ * layouts are addressed by chunk index. Chunks are ordered left to right,
+ * top to bottom, and (for planar images) plane by plane.
+ */
+typedef struct {
+    int big_endian;                 ///< 1 for "MM" files, 0 for "II"
+    uint32_t width;
+    uint32_t height;
+    uint16_t samples_per_pixel;
+    uint16_t bits_per_sample;       ///< 8, 16, 32 or 64; identical for all samples
+    uint16_t sample_format;         ///< tiff_sample_format_t
+    uint16_t compression;           ///< 1 for uncompressed
+    uint16_t photometric;
+    uint16_t planar_config;         ///< 1 chunky (interleaved), 2 planar
+    int tiled;                      ///< 1 for tiles, 0 for strips
+    uint32_t chunk_width;           ///< TileWidth, or width for strips
+    uint32_t chunk_height;          ///< TileLength, or RowsPerStrip for strips
+    size_t chunks_across;
+    size_t chunks_down;
+    size_t num_chunks;
+    uint64_t* offsets;              ///< File offset of each chunk
+    uint64_t* byte_counts;          ///< Stored size of each chunk
+    uint64_t next_ifd;              ///< Offset of the next IFD, 0 for the last
+} tiff_image_t;
+
+/**
+ * @brief Parses the index-th IFD of a TIFF file held in memory.
+ *
+ * @param data   Start of the file, e.g. an mmapped region.
+ * @param size   Number of bytes available.
+ * @param index  Zero-based directory index.
+ * @param image  Receives the directory; release with tiff_free_image().
+ * @return 0 on success, -1 on error or malformed input.
+ */
+int tiff_parse_image(const uint8_t* data, size_t size, size_t index, tiff_image_t* image);
+
+/**
+ * @brief Reads the index-th IFD of a TIFF file.
+ *
+ * @param file   Open binary file.
+ * @param index  Zero-based directory index.
+ * @param image  Receives the directory; release with tiff_free_image().
+ * @return 0 on success, -1 on error or malformed input.
+ */
+int tiff_read_image(FILE* file, size_t index, tiff_image_t* image);
+
+/// Source counterpart of tiff_read_image(); src must have a seek hook.
+int tiff_read_image_source(const endian_source_t* src, size_t index, tiff_image_t* image);
+
+/**
+ * @brief Releases the chunk tables of an image.
+ */
+void tiff_free_image(tiff_image_t* image);
+
+/**
+ * @brief Returns the decoded size in bytes of one chunk.
+ *
+ * The last strip may be shorter than RowsPerStrip; tiles always have the
+ * full tile size, including padding past the image edge.
+ *
+ * @param image  Parsed directory.
+ * @param chunk  Chunk index.
+ * @return Size in bytes, or 0 if chunk is out of range.
+ */
+size_t tiff_chunk_size(const tiff_image_t* image, size_t chunk);
+
+/**
+ * @brief Decodes one uncompressed chunk of a file held in memory into native
+ *        samples.
+ *
+ * Chunks are independent, so separate threads may decode different chunks
+ * of the same mapped file concurrently.
+ *
+ * @param data   Start of the file.
+ * @param size   Number of bytes available.
+ * @param image  Parsed directory.
+ * @param chunk  Chunk index.
+ * @param out    Output buffer of tiff_chunk_size() bytes.
+ * @return 0 on success, -1 on error or unsupported layout.
+ */
+int tiff_decode_chunk(const uint8_t* data, size_t size, const tiff_image_t* image,
+                      size_t chunk, void* out);
+
+/**
+ * @brief Reads one uncompressed chunk into native samples.
+ *
+ * The stored bytes are read directly into out and swapped in place.
+ *
+ * @param file   Open binary file.
+ * @param image  Parsed directory.
+ * @param chunk  Chunk index.
+ * @param out    Output buffer of tiff_chunk_size() bytes.
+ * @return 0 on success, -1 on error or unsupported layout.
+ */
+int tiff_read_chunk(FILE* file, const tiff_image_t* image, size_t chunk, void* out);
+
+/// Source counterpart of tiff_read_chunk(); src must have a seek hook.
+int tiff_read_chunk_source(const endian_source_t* src, const tiff_image_t* image,
+                           size_t chunk, void* out);
+
+/**
+ * @brief Reads the whole image into a contiguous native raster.
+ *
+ * Chunky images are laid out as height x width x samples_per_pixel; planar
+ * images as samples_per_pixel planes of height x width. Tile padding past
+ * the image edge is dropped.
+ *
+ * @param file   Open binary file.
+ * @param image  Parsed directory.
+ * @param out    Output buffer of width * height * samples_per_pixel samples.
+ * @return 0 on success, -1 on error or unsupported layout.
+ */
+int tiff_read_raster(FILE* file, const tiff_image_t* image, void* out);
+
+/// Source counterpart of tiff_read_raster(); src must have a seek hook.
+int tiff_read_raster_source(const endian_source_t* src, const tiff_image_t* image, void* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIFF_IO_H